@@ -0,0 +1,163 @@
+// Benchmark of a face loop over a hexahedral grid in shuffled order, and after
+// renumbering cells and faces along the Morton and Hilbert curves and by
+// reverse Cuthill-McKee ordering the same way as renumberGrid. The face loop
+// gathers the state of the left and right cells and scatters a flux to their
+// residual like the residual assembly does.
+//
+// Usage: LFlame3Bench [n] [repeat]
+// The grid has n^3 cells (default 64) and the face loop is repeated repeat
+// times (default 20).
+
+#include <space_filling_curve.hh>
+#include <graph_ordering.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+struct Grid {
+  std::vector<Loci::vector3d<double>> centroid;
+  std::vector<std::pair<int, int>> face;
+};
+
+// Creates an n^3 hexahedral grid with cells and internal faces in random
+// order, as left by a grid generator with poor locality.
+Grid createShuffledGrid(int const n) {
+  std::mt19937 gen(1);
+  
+  std::vector<int> cellNumber(n*n*n);
+  std::iota(cellNumber.begin(), cellNumber.end(), 0);
+  std::shuffle(cellNumber.begin(), cellNumber.end(), gen);
+  
+  Grid grid;
+  grid.centroid.resize(n*n*n);
+  for(int i = 0; i < n; ++i) {
+    for(int j = 0; j < n; ++j) {
+      for(int k = 0; k < n; ++k) {
+        grid.centroid[cellNumber[(i*n+j)*n+k]] = Loci::vector3d<double>(i, j, k);
+        if(i+1 < n) {
+          grid.face.push_back(std::make_pair(cellNumber[(i*n+j)*n+k], cellNumber[((i+1)*n+j)*n+k]));
+        }
+        if(j+1 < n) {
+          grid.face.push_back(std::make_pair(cellNumber[(i*n+j)*n+k], cellNumber[(i*n+j+1)*n+k]));
+        }
+        if(k+1 < n) {
+          grid.face.push_back(std::make_pair(cellNumber[(i*n+j)*n+k], cellNumber[(i*n+j)*n+k+1]));
+        }
+      }
+    }
+  }
+  std::shuffle(grid.face.begin(), grid.face.end(), gen);
+  
+  return grid;
+}
+
+// Numbers cell order[k] as k and sorts faces by the new numbers of their cells.
+Grid renumber(Grid const & grid, std::vector<int> const & order) {
+  int const nCells = grid.centroid.size();
+  std::vector<int> newNumber(nCells);
+  Grid result;
+  result.centroid.resize(nCells);
+  for(int k = 0; k < nCells; ++k) {
+    newNumber[order[k]] = k;
+    result.centroid[k] = grid.centroid[order[k]];
+  }
+  
+  result.face.resize(grid.face.size());
+  for(std::size_t f = 0; f < grid.face.size(); ++f) {
+    int const l = newNumber[grid.face[f].first], r = newNumber[grid.face[f].second];
+    result.face[f] = std::make_pair(std::min(l, r), std::max(l, r));
+  }
+  std::sort(result.face.begin(), result.face.end());
+  
+  return result;
+}
+
+Grid renumber(Grid const & grid, SpaceFillingCurve const curve) {
+  std::vector<int> order;
+  spaceFillingCurveOrder(grid.centroid, curve, order);
+  return renumber(grid, order);
+}
+
+Grid renumberRCM(Grid const & grid) {
+  AdjacencyGraph graph;
+  createAdjacencyGraph(grid.centroid.size(), grid.face, graph);
+  
+  std::vector<int> order;
+  reverseCuthillMcKeeOrder(graph, order);
+  return renumber(grid, order);
+}
+
+// Returns the time per face loop in seconds.
+double timeFaceLoop(Grid const & grid, int const repeat) {
+  int const nCells = grid.centroid.size();
+  int const nFaces = grid.face.size();
+  
+  std::vector<double> state(5*nCells, 1.0);
+  std::vector<double> residual(5*nCells, 0.0);
+  std::vector<double> flux(5*nFaces, 0.0);
+  
+  auto const start = std::chrono::steady_clock::now();
+  for(int n = 0; n < repeat; ++n) {
+    for(int f = 0; f < nFaces; ++f) {
+      double const * ql = &state[5*grid.face[f].first];
+      double const * qr = &state[5*grid.face[f].second];
+      for(int i = 0; i < 5; ++i) {
+        flux[5*f+i] = 0.5*(ql[i]+qr[i])-0.1*(qr[i]-ql[i]);
+      }
+    }
+    for(int f = 0; f < nFaces; ++f) {
+      double * rl = &residual[5*grid.face[f].first];
+      double * rr = &residual[5*grid.face[f].second];
+      for(int i = 0; i < 5; ++i) {
+        rl[i] -= flux[5*f+i];
+        rr[i] += flux[5*f+i];
+      }
+    }
+  }
+  auto const stop = std::chrono::steady_clock::now();
+  
+  // Keep the result alive.
+  volatile double sink = std::accumulate(residual.begin(), residual.end(), 0.0);
+  (void)sink;
+  
+  return std::chrono::duration<double>(stop-start).count()/repeat;
+}
+
+} // end: anonymous namespace
+
+int main(int argc, char * argv[]) {
+  int const n = argc > 1 ? std::atoi(argv[1]) : 64;
+  int const repeat = argc > 2 ? std::atoi(argv[2]) : 20;
+  
+  Grid const shuffled = createShuffledGrid(n);
+  Grid const morton = renumber(shuffled, SpaceFillingCurve::Morton);
+  Grid const hilbert = renumber(shuffled, SpaceFillingCurve::Hilbert);
+  Grid const rcm = renumberRCM(shuffled);
+  
+  double const tShuffled = timeFaceLoop(shuffled, repeat);
+  double const tMorton = timeFaceLoop(morton, repeat);
+  double const tHilbert = timeFaceLoop(hilbert, repeat);
+  double const tRCM = timeFaceLoop(rcm, repeat);
+  
+  std::cout << "cells: " << shuffled.centroid.size()
+    << ", internal faces: " << shuffled.face.size() << std::endl;
+  std::cout << "shuffled: " << tShuffled << " s per face loop" << std::endl;
+  std::cout << "morton:   " << tMorton << " s per face loop, speedup "
+    << tShuffled/tMorton << std::endl;
+  std::cout << "hilbert:  " << tHilbert << " s per face loop, speedup "
+    << tShuffled/tHilbert << std::endl;
+  std::cout << "rcm:      " << tRCM << " s per face loop, speedup "
+    << tShuffled/tRCM << std::endl;
+  
+  return 0;
+}
@@ -0,0 +1,110 @@
+// Benchmark of the Wilke weighting function of the mixture viscosity and
+// conductivity: the per-pair evaluation with pow of the molecular weight and
+// viscosity ratios, as computed before the factors of the molecular weights
+// were precomputed, against wilkeTransportPhi with the factors of
+// initWilkeTransportFactors.
+//
+// Usage: LFlame3BenchTransport [nSpecies] [nCells]
+// The mixture has nSpecies species (default 30) with random molecular weights
+// and viscosities, and the weighting function is evaluated for nCells cells
+// (default 20000).
+
+#include <transport.hh>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+// Column-major matrix of order N in the layout of a Loci storeMat, with
+// phi[k][m] at m*N+k.
+struct Column {
+  double * p;
+  int N;
+  double & operator[](int const m) const {
+    return p[m*N];
+  }
+};
+
+struct Matrix {
+  double * p;
+  int N;
+  Column operator[](int const k) const {
+    Column c = {p+k, N};
+    return c;
+  }
+};
+
+// The weighting function of one cell evaluated pair by pair.
+void wilkeTransportPhiPow(
+  Matrix phi, int const N, double const * w, double const * mu
+) {
+  for(int m = 0; m < N; ++m) {
+    for(int k = 0; k < N; ++k) {
+      double wratio = w[k]/w[m];
+      double muratio = mu[k]/mu[m];
+      phi[k][m] = pow(8.0*(1.0+wratio), -0.5) * pow(1.0+sqrt(muratio)*pow(1.0/wratio, 0.25), 2.0);
+    }
+  }
+}
+
+} // end: anonymous namespace
+
+int main(int argc, char * argv[]) {
+  int const N = argc > 1 ? std::atoi(argv[1]) : 30;
+  int const nCells = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if(N < 1 || N > FLAME_MAX_NSPECIES || nCells < 1) {
+    std::cerr << "usage: " << argv[0] << " [nSpecies] [nCells]" << std::endl;
+    return 1;
+  }
+
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> weight(1.0, 200.0);
+  std::uniform_real_distribution<double> viscosity(1.0e-5, 8.0e-5);
+
+  std::vector<double> W(N), mu(N*nCells), phi(N*N*nCells);
+  for(int k = 0; k < N; ++k) {
+    W[k] = weight(gen);
+  }
+  for(int i = 0; i < N*nCells; ++i) {
+    mu[i] = viscosity(gen);
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  for(int c = 0; c < nCells; ++c) {
+    Matrix m = {&phi[c*N*N], N};
+    wilkeTransportPhiPow(m, N, &W[0], &mu[c*N]);
+  }
+  auto const middle = std::chrono::steady_clock::now();
+  std::vector<double> const reference(phi);
+
+  std::vector<double> factors;
+  initWilkeTransportFactors(N, &W[0], factors);
+  auto const factored = std::chrono::steady_clock::now();
+  for(int c = 0; c < nCells; ++c) {
+    Matrix m = {&phi[c*N*N], N};
+    wilkeTransportPhi(m, N, &factors[0], &mu[c*N]);
+  }
+  auto const stop = std::chrono::steady_clock::now();
+
+  double error = 0.0;
+  for(std::size_t i = 0; i < phi.size(); ++i) {
+    error = std::max(error, std::fabs(phi[i]-reference[i])/reference[i]);
+  }
+
+  double const tPow = std::chrono::duration<double>(middle-start).count();
+  double const tFactors = std::chrono::duration<double>(stop-factored).count();
+  std::cout << "species: " << N << ", cells: " << nCells << std::endl;
+  std::cout << "pow:     " << tPow/nCells << " s per cell" << std::endl;
+  std::cout << "factors: " << tFactors/nCells << " s per cell, speedup "
+    << tPow/tFactors << std::endl;
+  std::cout << "largest relative difference: " << error << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#ifndef FLAME_CHEMISTRY_INTEGRATOR_HH
+#define FLAME_CHEMISTRY_INTEGRATOR_HH
+
+#include <dense_lu.hh>
+#include <kinetics.hh>
+#include <nasa9.hh>
+#include <sparse_lu.hh>
+
+#include <memory>
+#include <vector>
+
+// Largest fraction of the entries of the matrices of the steps of
+// integrateChemistry that the sparse factorization may fill for it to be
+// chosen over the dense one. Denser factors are faster to compute densely.
+#ifndef FLAME_CHEMISTRY_SPARSE_LU_MAX_FILL
+#define FLAME_CHEMISTRY_SPARSE_LU_MAX_FILL 0.75
+#endif
+
+namespace flame {
+
+// Settings of integrateChemistry.
+struct ChemistryIntegrator {
+  // Tolerances of the local error of a step: relative to the concentrations
+  // and the temperature, and absolute in terms of the mass fractions.
+  double relativeTolerance;
+  double absoluteTolerance;
+
+  // Largest number of steps, accepted and rejected, of one integration.
+  int maxSteps;
+
+  // Symbolic factorization of the matrices of the steps, shared by the cells
+  // and steps of all integrations, or nullptr to factorize them as dense
+  // matrices.
+  std::shared_ptr<SparseLU const> sparseLU;
+};
+
+// Computes the symbolic factorization of the matrices I/(gamma*h)-J of the
+// steps of integrateChemistry from the pattern of the Jacobian of the
+// mechanism, with the row of the temperature dense.
+void initChemistrySparseLU(SparseLU & lu, KineticsTable const & kinetics);
+
+// Scratch arrays of integrateChemistry, allocated once for a mechanism so that
+// no memory is allocated per cell. The matrices are of order nSpecies+1.
+struct ChemistryWorkspace {
+  int n;
+  DenseLU lu;
+  std::vector<double> y, y1, f, k1, k2, k3, atol;
+  std::vector<double> J, A;
+  std::vector<int> pivot;
+
+  // Jacobian in the entries of the sparse factorization of the integrator, if
+  // it has one; J is then set from it only when the sensitivity or a dense
+  // factorization needs it.
+  std::vector<double> sparseJ;
+
+  // Entries of the sparse factorization of the current step, and the
+  // factorization they belong to, or nullptr if the step was factorized as a
+  // dense matrix in A.
+  std::vector<double> values, solveWork;
+  SparseLU const * sparseStep;
+  std::vector<double> U, Cv;
+  std::vector<double> stepSensitivity, product;
+};
+
+void initChemistryWorkspace(
+  ChemistryWorkspace & work, KineticsTable const & kinetics
+);
+
+// Right-hand side f of the equations of an isochoric, adiabatic reactor with
+// the state y = (C_0, ..., C_{Ns-1}, T) of molar concentrations [kmol/m^3] and
+// temperature:
+//   dC_s/dt = wdot_s,
+//   dT/dt = -sum_s U_s wdot_s / sum_s C_s Cv_s,
+// with the molar internal energies U_s and specific heats Cv_s of the NASA9
+// polynomials of thermo. If J is not nullptr it is set to the analytic Jacobian
+// df/dy, row-major of order Ns+1.
+void chemistryRightHandSide(
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work, double const * y, double * f, double * J
+);
+
+// Right-hand side of chemistryRightHandSide with the Jacobian assembled directly
+// in the entries of the pattern of lu, computed by initChemistrySparseLU, as
+// kineticsMolarRatesSparse does. J is nullptr or has lu.nonzeros entries, and
+// the entries of the fill of lu are set to 0.
+void chemistryRightHandSideSparse(
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  SparseLU const & lu, ChemistryWorkspace & work,
+  double const * y, double * f, double * J
+);
+
+// Advances the mass fractions Y and temperature T of a cell with density rho
+// over dt under the reactions of the mechanism alone, at constant density and
+// internal energy. The integration uses the L-stable three-stage Rosenbrock
+// method ROS3 with the analytic Jacobian, one LU factorization per step, and
+// step size control from its embedded second-order solution, so that stiff
+// mechanisms take steps limited by accuracy rather than stability. With the
+// sparse factorization of integrator the Jacobian is assembled in its entries
+// and only the numeric factorization is done per step; a step whose matrix needs pivoting off the diagonal is factorized
+// as a dense matrix instead. Returns the number of accepted steps, or -1 if the
+// integration did not finish in integrator.maxSteps steps.
+//
+// If S is not nullptr it is set to the sensitivity of the final state to the
+// initial one, dy(dt)/dy(0) for the state y of chemistryRightHandSide,
+// row-major of order Ns+1. It is the product of the derivatives of the
+// accepted steps, each with the Jacobian of the step held fixed, which takes
+// of the order of (Ns+1)^3 operations per step.
+int integrateChemistry(
+  ChemistryIntegrator const & integrator,
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work,
+  double const rho, double const dt, double * Y, double & T,
+  double * S = nullptr
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_CHEMISTRY_INTEGRATOR_HH
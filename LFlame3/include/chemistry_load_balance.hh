@@ -0,0 +1,89 @@
+#ifndef FLAME_CHEMISTRY_LOAD_BALANCE_HH
+#define FLAME_CHEMISTRY_LOAD_BALANCE_HH
+
+#include <chemistry_tabulation.hh>
+
+#include <mpi.h>
+
+#include <vector>
+
+namespace flame {
+
+// Reactors of the cells of a process that are advanced over a time step by
+// integrateChemistryReactors: density, temperature, mass fractions (Ns per
+// reactor) and estimated cost of each. On return the temperature and mass
+// fractions are advanced, steps holds the number of accepted integration steps
+// (-1 if an integration did not finish) and cost the measured cost: [s].
+struct ChemistryReactors {
+  int nSpecies;
+  std::vector<double> density;
+  std::vector<double> temperature;
+  std::vector<double> massFraction;
+  std::vector<double> cost;
+  std::vector<int> steps;
+};
+
+void clearChemistryReactors(ChemistryReactors & reactors, int const Ns);
+
+void addChemistryReactor(
+  ChemistryReactors & reactors, double const rho, double const T,
+  double const * Y, double const cost
+);
+
+// Work to be moved from one process to another, in units of the cost.
+struct ChemistryTransfer {
+  int from;
+  int to;
+  double cost;
+};
+
+// Outcomes of the integrations of a process since the statistics were last
+// reset: measured cost of the reactors integrated by the process, including
+// those of other processes, and the numbers of reactors sent and received.
+struct ChemistryLoadBalanceStatistics {
+  double cost;
+  long sent;
+  long received;
+};
+
+// Dynamic load balancing of the reactors. When enabled and the largest
+// estimated load of a process exceeds the mean by more than the fraction
+// imbalance, the processes above the mean send reactors to those below it,
+// which integrate them and send the results back.
+struct ChemistryLoadBalance {
+  bool enabled;
+  double imbalance;
+  ChemistryLoadBalanceStatistics statistics;
+};
+
+void initChemistryLoadBalance(
+  ChemistryLoadBalance & balance, bool const enabled, double const imbalance
+);
+
+void resetChemistryLoadBalanceStatistics(ChemistryLoadBalance & balance);
+
+// Transfers that even out the loads of the processes: the excess of every
+// process above the mean is moved to the processes below it, the largest
+// excess to the largest deficit first. No transfers are made if the largest
+// load is within the fraction imbalance of the mean. Every process computes
+// the same transfers from the same loads.
+void chemistryTransferPlan(
+  std::vector<double> const & loads, double const imbalance,
+  std::vector<ChemistryTransfer> & transfers
+);
+
+// Advances the reactors over dt as tabulatedChemistry if table is not nullptr
+// and as integrateChemistry otherwise. With an enabled balance the loads of
+// the processes of comm are gathered from the estimated costs and reactors
+// are moved as chemistryTransferPlan; all processes of comm must call it
+// then.
+void integrateChemistryReactors(
+  ChemistryReactors & reactors, ChemistryIntegrator const & integrator,
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work, ChemistryTabulation * table, double const dt,
+  ChemistryLoadBalance * balance, MPI_Comm comm
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_CHEMISTRY_LOAD_BALANCE_HH
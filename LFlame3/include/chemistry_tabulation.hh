@@ -0,0 +1,110 @@
+#ifndef FLAME_CHEMISTRY_TABULATION_HH
+#define FLAME_CHEMISTRY_TABULATION_HH
+
+#include <chemistry_integrator.hh>
+
+#include <vector>
+
+// Temperature by which the temperatures are divided in the coordinates of the
+// tabulation, so that the tolerance applies to the mass fractions and to the
+// temperature in units of this scale: [K].
+#ifndef FLAME_CHEMISTRY_TABULATION_TEMPERATURE_SCALE
+#define FLAME_CHEMISTRY_TABULATION_TEMPERATURE_SCALE 1000.0
+#endif
+
+// Number of most recently used records that are searched when the record
+// found in the binary tree does not cover a query.
+#ifndef FLAME_CHEMISTRY_TABULATION_MRU_SEARCH
+#define FLAME_CHEMISTRY_TABULATION_MRU_SEARCH 8
+#endif
+
+namespace flame {
+
+// Outcomes of the queries of a table since the statistics were last reset.
+// A query is retrieved from a record, or it misses and is integrated, after
+// which a record is grown to cover it or a new record is added. A record is
+// evicted when the table is full.
+struct ChemistryTabulationStatistics {
+  long retrieves;
+  long grows;
+  long adds;
+  long evictions;
+};
+
+// In-situ adaptive tabulation (ISAT, Pope 1997) of the map of the reactor
+// state over a time step dt by integrateChemistry. The query of a cell is
+//   phi = (Y_0, ..., Y_{Ns-1}, T/Tscale, ln(rho), ln(dt)),
+// which is equivalent to (T, P, Y, dt), so that records of different time
+// steps are kept side by side, and the result is
+//   psi = (Y_0, ..., Y_{Ns-1}, T/Tscale).
+// Record r stores a tabulated query phi_r, its result psi_r, the gradient
+// A_r = dpsi/dphi and an ellipsoid of accuracy {phi: dphi^T G_r dphi <= 1},
+// dphi = phi-phi_r, within which psi_r+A_r dphi is taken to be within the
+// tolerance of the result. The records are the leaves of a binary tree of
+// cutting planes and are kept in least recently used order; when the table is
+// full the least recently used one is evicted.
+//
+// A child in the tree is a node index c >= 0 or a record r encoded as -(r+1);
+// the root is such a child unless the table is empty.
+struct ChemistryTabulation {
+  int nSpecies;
+
+  // Dimensions of phi and psi: Ns+3 and Ns+1.
+  int nQuery;
+  int nResult;
+
+  // Largest error of the linear approximation, in the norm of psi.
+  double tolerance;
+  int maxRecords;
+
+  int nRecords;
+  std::vector<double> query;
+  std::vector<double> result;
+  std::vector<double> gradient;
+  std::vector<double> ellipsoid;
+  std::vector<int> leafParent;
+  std::vector<int> lruPrev, lruNext;
+  int lruHead, lruTail;
+  std::vector<int> freeRecords;
+
+  // Cutting planes v.phi = a: the left child is on the side v.phi < a.
+  int root;
+  std::vector<double> normal;
+  std::vector<double> offset;
+  std::vector<int> left, right, nodeParent;
+  std::vector<int> freeNodes;
+
+  ChemistryTabulationStatistics statistics;
+
+  // Scratch arrays of a query.
+  std::vector<double> phi, psi, dphi, Gdphi, S, y, f, C0;
+};
+
+// Sets up an empty table for Ns species with the tolerance and at most memory
+// bytes of records and tree nodes, but room for at least one record.
+void initChemistryTabulation(
+  ChemistryTabulation & table, int const Ns, double const tolerance,
+  double const memory
+);
+
+// Removes all records. The statistics are kept.
+void clearChemistryTabulation(ChemistryTabulation & table);
+
+void resetChemistryTabulationStatistics(ChemistryTabulation & table);
+
+// Advances the mass fractions Y and temperature T of a cell with density rho
+// over dt as integrateChemistry, retrieving the result from the table when a
+// record covers the state and integrating and tabulating it otherwise. A miss
+// is integrated once, with the sensitivity that a new record takes as its
+// gradient. Returns the number of accepted integration steps, 0 for a
+// retrieved result, or -1 if an integration did not finish.
+int tabulatedChemistry(
+  ChemistryTabulation & table, ChemistryIntegrator const & integrator,
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work,
+  double const rho, double const dt, double * Y, double & T
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_CHEMISTRY_TABULATION_HH
@@ -0,0 +1,114 @@
+#ifndef FLAME_DENSE_LU_HH
+#define FLAME_DENSE_LU_HH
+
+#include <cmath>
+
+// Range of matrix orders for which the LU factorization is specialized at
+// compile time. Order Ns+1 is that of the chemistry Jacobian of Ns species.
+#define FLAME_DENSE_LU_MIN_SPECIALIZED_N 3
+#define FLAME_DENSE_LU_MAX_SPECIALIZED_N 33
+
+namespace flame {
+
+// Factorizes the n x n row-major matrix A in place into PA = LU by Gaussian
+// elimination with partial pivoting. L has a unit diagonal and is stored below
+// the diagonal of A, U on and above it. Row k was swapped with row pivot[k] at
+// step k. Returns false if A is singular.
+inline
+bool denseLUFactor(int const n, double * A, int * pivot) {
+  for(int k = 0; k < n; ++k) {
+    int p = k;
+    double amax = std::fabs(A[k*n+k]);
+    for(int i = k+1; i < n; ++i) {
+      double const a = std::fabs(A[i*n+k]);
+      if(a > amax) {
+        amax = a;
+        p = i;
+      }
+    }
+    pivot[k] = p;
+    if(amax == 0.0) {
+      return false;
+    }
+
+    if(p != k) {
+      for(int j = 0; j < n; ++j) {
+        double const t = A[k*n+j];
+        A[k*n+j] = A[p*n+j];
+        A[p*n+j] = t;
+      }
+    }
+
+    double const rpiv = 1.0/A[k*n+k];
+    double const * Ak = A+k*n;
+    for(int i = k+1; i < n; ++i) {
+      double * Ai = A+i*n;
+      double const l = Ai[k]*rpiv;
+      Ai[k] = l;
+      for(int j = k+1; j < n; ++j) {
+        Ai[j] -= l*Ak[j];
+      }
+    }
+  }
+  return true;
+}
+
+// Solves Ax = b with the factorization of denseLUFactor. b is overwritten by x.
+inline
+void denseLUSolve(int const n, double const * A, int const * pivot, double * b) {
+  for(int k = 0; k < n; ++k) {
+    int const p = pivot[k];
+    if(p != k) {
+      double const t = b[k];
+      b[k] = b[p];
+      b[p] = t;
+    }
+  }
+
+  for(int i = 1; i < n; ++i) {
+    double const * Ai = A+i*n;
+    double s = b[i];
+    for(int j = 0; j < i; ++j) {
+      s -= Ai[j]*b[j];
+    }
+    b[i] = s;
+  }
+
+  for(int i = n-1; i >= 0; --i) {
+    double const * Ai = A+i*n;
+    double s = b[i];
+    for(int j = i+1; j < n; ++j) {
+      s -= Ai[j]*b[j];
+    }
+    b[i] = s/Ai[i];
+  }
+}
+
+// Same as above for matrices of order N known at compile time, so that the
+// loops have constant trip counts. The order argument is ignored; it makes the
+// signatures those of the general functions.
+template<int N>
+bool denseLUFactorN(int const /*n*/, double * A, int * pivot) {
+  return denseLUFactor(N, A, pivot);
+}
+
+template<int N>
+void denseLUSolveN(int const /*n*/, double const * A, int const * pivot, double * b) {
+  denseLUSolve(N, A, pivot, b);
+}
+
+// Factorization and solution functions for one matrix order.
+struct DenseLU {
+  bool (*factor)(int const n, double * A, int * pivot);
+  void (*solve)(int const n, double const * A, int const * pivot, double * b);
+};
+
+// Returns the functions specialized for matrices of order n, or the general
+// ones if n is outside the range [FLAME_DENSE_LU_MIN_SPECIALIZED_N,
+// FLAME_DENSE_LU_MAX_SPECIALIZED_N]. Meant to be called once per matrix order
+// rather than once per matrix.
+DenseLU selectDenseLU(int const n);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_DENSE_LU_HH
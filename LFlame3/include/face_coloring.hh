@@ -0,0 +1,43 @@
+#ifndef FLAME_FACE_COLORING_HH
+#define FLAME_FACE_COLORING_HH
+
+#include <Loci.h>
+
+#include <vector>
+
+namespace flame {
+
+/**
+ * Internal faces ordered by color. Faces of color c are faces[offsets[c]] to
+ * faces[offsets[c+1]-1].
+ */
+struct FaceColorGroups {
+  std::vector<Loci::Entity> faces;
+  std::vector<int> offsets;
+};
+
+/**
+ * Colors the internal faces of the grid such that no two faces of the same
+ * color share a cell. Internal faces are the faces whose left and right cells
+ * are both geom_cells. Returns the number of colors used. faceColor is
+ * allocated on the colored faces.
+ */
+int colorInternalFaces(
+  Loci::Map const & cl, Loci::Map const & cr,
+  Loci::entitySet const & faces, Loci::entitySet const & cells,
+  Loci::store<int> & faceColor
+);
+
+/**
+ * Orders the faces of seq by color. On return, faces of color c are
+ * faces[offsets[c]] to faces[offsets[c+1]-1].
+ */
+void groupFacesByColor(
+  Loci::sequence const & seq, Loci::const_store<int> const & faceColor,
+  int const nColors,
+  std::vector<Loci::Entity> & faces, std::vector<int> & offsets
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_FACE_COLORING_HH
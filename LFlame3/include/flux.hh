@@ -3,6 +3,21 @@
 
 #include <Loci.h>
 
+#include <flame.hh>
+#include <simd.hh>
+
+#include <cmath>
+
+// Number of faces evaluated together by the batched flux kernels.
+#ifndef FLAME_FLUX_BLOCK_SIZE
+#define FLAME_FLUX_BLOCK_SIZE 64
+#endif
+
+// Range of species counts for which the multi-species flux is specialized at
+// compile time.
+#define FLAME_FLUX_MIN_SPECIALIZED_NS 2
+#define FLAME_FLUX_MAX_SPECIALIZED_NS 32
+
 namespace flame {
 
 void AUSMPlusUpFluxIdealGas(
@@ -13,6 +28,143 @@ void AUSMPlusUpFluxIdealGas(
   double const Rtilde, double const gamma, double const Minf
 );
 
+// Returns true if the AUSM+up flux of the left and right states is the flux of
+// the right state alone, i.e. both states enter the face from the right side
+// at Mach numbers below -1 with respect to the interface speed of sound. Unl
+// and Unr are the velocities normal to the face, h0l and h0r the total
+// enthalpies Cp*T+|U|^2/2 and gammal and gammar the ratios of specific heats of
+// the states.
+bool AUSMPlusUpRightSupersonic(
+  double const Unl, double const h0l, double const gammal,
+  double const Unr, double const h0r, double const gammar
+);
+
+// Face states and fluxes of a block of faces in structure-of-arrays layout. The
+// flux components are ordered as in AUSMPlusUpFluxIdealGas.
+template<typename T>
+struct IdealGasFaceBlockT {
+  alignas(FLAME_SIMD_ALIGN) T Ulx[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Uly[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Ulz[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Pgl[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Tl[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Urx[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Ury[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Urz[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Pgr[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Tr[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T area_sada[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T area_nx[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T area_ny[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T area_nz[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T Minf[FLAME_FLUX_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) T flux[5][FLAME_FLUX_BLOCK_SIZE];
+};
+
+typedef IdealGasFaceBlockT<double> IdealGasFaceBlock;
+
+// Single precision block used when fluxPrecision is "single".
+typedef IdealGasFaceBlockT<float> IdealGasFaceBlockSP;
+
+// Batched variant of AUSMPlusUpFluxIdealGas. Evaluates the flux at the first n
+// faces (n <= FLAME_FLUX_BLOCK_SIZE) of the block, with the cutoff Mach number
+// of each face taken from block.Minf. Mach number splitting is written without
+// branches so that the loop over faces is vectorized.
+void AUSMPlusUpFluxIdealGasBlock(
+  IdealGasFaceBlock & block, int const n,
+  double const Pambient, double const Rtilde, double const Cp
+);
+
+// Same as above in single precision. Twice as many faces are processed per
+// vector instruction.
+void AUSMPlusUpFluxIdealGasBlock(
+  IdealGasFaceBlockSP & block, int const n,
+  double const Pambient, double const Rtilde, double const Cp
+);
+
+// Cutoff Mach number of a face when cutoffMachSelection is "auto". It is the
+// largest of the reference value Mref, the Mach number of the face velocity
+// (Umag2 is the larger squared velocity magnitude of the two sides) and the
+// Mach number of the pressure jump dP across the face, limited to 1. rho and a2
+// are the average density and squared speed of sound of the two sides. The
+// pressure term keeps the scaling of AUSM+up from vanishing in stagnation
+// regions with strong pressure gradients, e.g. near walls and flame fronts.
+inline
+double autoCutoffMach(
+  double const Mref, double const Umag2, double const dP,
+  double const rho, double const a2
+) {
+  double M2 = Mref*Mref;
+  M2 = Umag2/a2 > M2 ? Umag2/a2 : M2;
+  M2 = std::fabs(dP)/(rho*a2) > M2 ? std::fabs(dP)/(rho*a2) : M2;
+  return M2 < 1.0 ? std::sqrt(M2) : 1.0;
+}
+
+// HLLC flux of Toro for the ideal gas with the wave speed estimates of Davis,
+// and the Rusanov (local Lax-Friedrichs) flux. Arguments and flux components
+// are as in AUSMPlusUpFluxIdealGas; Minf is not used. The Rusanov flux is the
+// cheapest and most dissipative of the upwind fluxes.
+void HLLCFluxIdealGas(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp, double const Minf
+);
+
+void RusanovFluxIdealGas(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp, double const Minf
+);
+
+// Type of AUSMPlusUpFluxIdealGas, HLLCFluxIdealGas and RusanovFluxIdealGas.
+typedef void (*IdealGasFluxFunction)(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp, double const Minf
+);
+
+// Kinetic-energy-preserving central flux of Jameson for the ideal gas, with the
+// flux components ordered as in AUSMPlusUpFluxIdealGas. The mass flux is the
+// product of the average density and the average normal velocity; momentum
+// and total enthalpy are carried with their arithmetic averages. The flux adds
+// no numerical dissipation and is meant for smooth regions only.
+void KEPCentralFluxIdealGas(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp
+);
+
+// Multi-species variant of KEPCentralFluxIdealGas with the flux components
+// ordered as in AUSMPlusUpFluxMultiSpeciesIdealGas. Mass fractions are carried
+// with their arithmetic averages.
+void KEPCentralFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient
+);
+
+// Shock sensor of Ducros et al., div(U)^2/(div(U)^2+|curl(U)|^2+eps), from the
+// velocity gradient gradU and the vorticity magnitude. It is close to 1 at
+// shocks, where the flow is dominated by compression, and close to 0 in
+// vortical turbulence.
+inline
+double ducrosSensor(Loci::tensor3d<double> const & gradU, double const vorticityMagnitude) {
+  double const div = gradU.x.x+gradU.y.y+gradU.z.z;
+  return div*div/(div*div+vorticityMagnitude*vorticityMagnitude+1.0e-30);
+}
+
 void AUSMPlusUpFluxMultiSpeciesIdealGas(
   double * flux,
   int const Ns,
@@ -24,6 +176,122 @@ void AUSMPlusUpFluxMultiSpeciesIdealGas(
   double const Minf
 );
 
+// Same as AUSMPlusUpFluxMultiSpeciesIdealGas with the interface mass flux and
+// pressure computed in single precision. The flux is assembled in double.
+void AUSMPlusUpFluxMultiSpeciesIdealGasSP(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+);
+
+// AUSM+up flux for a multi-species thermally perfect gas whose enthalpy is not
+// Cp*T, e.g. with NASA 9-coefficient polynomials. Cpl and Cpr are the frozen
+// specific heats at Tl and Tr, from which the interface mass flux and pressure
+// are computed as in AUSMPlusUpFluxMultiSpeciesIdealGas. hOffsetl and hOffsetr
+// are the differences h-Cp*T of the mixture enthalpies, which the energy flux
+// carries in addition to Cp*T of the upwind side.
+void AUSMPlusUpFluxMultiSpeciesThermallyPerfectGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl, double const hOffsetl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr, double const hOffsetr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+);
+
+// Type of AUSMPlusUpFluxMultiSpeciesIdealGas and its specializations.
+typedef void (*AUSMPlusUpFluxMultiSpeciesIdealGasFunction)(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+);
+
+// Multi-species variants of HLLCFluxIdealGas and RusanovFluxIdealGas with the
+// arguments and flux components of AUSMPlusUpFluxMultiSpeciesIdealGas.
+void HLLCFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+);
+
+void RusanovFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+);
+
+// Type of the multi-species flux functions of all schemes.
+typedef AUSMPlusUpFluxMultiSpeciesIdealGasFunction MultiSpeciesIdealGasFluxFunction;
+
+// Returns the multi-species flux function specialized for Ns species, or
+// AUSMPlusUpFluxMultiSpeciesIdealGas if Ns is outside the range
+// [FLAME_FLUX_MIN_SPECIALIZED_NS, FLAME_FLUX_MAX_SPECIALIZED_NS]. Meant to be
+// called once per rule execution rather than once per face.
+AUSMPlusUpFluxMultiSpeciesIdealGasFunction selectAUSMPlusUpFluxMultiSpeciesIdealGas(
+  int const Ns
+);
+
+// Newtonian shear stress of the velocity gradient gradU (gradU.i.j is the
+// derivative of velocity component i along j) and viscosity mu, with Stokes'
+// hypothesis for the bulk viscosity.
+void computeShearStress(
+  SymmetricTensor & tau, Loci::tensor3d<double> const & gradU, double const mu
+);
+
+// Force of the shear stress tau on a face: tau.n times the face area.
+Loci::vector3d<double> computeShearForce(
+  SymmetricTensor const & tau,
+  double const area_sada, Loci::vector3d<double> const & area_n
+);
+
+// Heat conducted through a face along its normal by the temperature gradient
+// gradT and conductivity k.
+double computeHeatFlux(
+  Loci::vector3d<double> const & gradT, double const k,
+  double const area_sada, Loci::vector3d<double> const & area_n
+);
+
+// Viscous flux through a face in the layout of viscousFlux_f: momentum
+// x, y, z and energy, from the shear force, the face velocity U and the heat
+// conducted through the face.
+void computeViscousFlux(
+  double * flux,
+  Loci::vector3d<double> const & shearForce, Loci::vector3d<double> const & U,
+  double const heat
+);
+
+// Viscous flux through a face from the velocity and temperature gradients; the
+// composition of the functions above.
+void computeViscousFlux(
+  double * flux,
+  Loci::tensor3d<double> const & gradU, double const mu,
+  Loci::vector3d<double> const & gradT, double const k,
+  Loci::vector3d<double> const & U,
+  double const area_sada, Loci::vector3d<double> const & area_n
+);
+
 //void computeDiffusionVelocityWithRamshawCorrection(
 //  Loci::vector3d<double> * velocityD,
 //  Loci::vector3d<double> const * gradY, double const * Y,
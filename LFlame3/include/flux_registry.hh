@@ -0,0 +1,65 @@
+#ifndef FLAME_FLUX_REGISTRY_HH
+#define FLAME_FLUX_REGISTRY_HH
+
+#include <flux.hh>
+
+#include <string>
+
+namespace flame {
+
+// Convective flux scheme selectable with option convectiveFluxScheme. The
+// single-species flux is evaluated one face at a time. The multi-species flux
+// is obtained from selectMultiSpecies once per rule execution, so a scheme may
+// return a function specialized for the number of species.
+struct ConvectiveFluxScheme {
+  char const * name;
+  IdealGasFluxFunction singleSpecies;
+  MultiSpeciesIdealGasFluxFunction (*selectMultiSpecies)(int const Ns);
+};
+
+class ConvectiveFluxSchemeList {
+public:
+  struct Item {
+    ConvectiveFluxScheme entry;
+    Item * next;
+  };
+  
+  static Item * items;
+  
+  static void insert(ConvectiveFluxScheme const & scheme) {
+    Item * p = new Item;
+    p->next = items;
+    p->entry = scheme;
+    items = p;
+  }
+  
+  // Returns the scheme registered under name, or nullptr if there is none.
+  static ConvectiveFluxScheme const * find(std::string const & name);
+  
+  // Returns the names of the registered schemes separated by ", ".
+  static std::string names();
+};
+
+// Registers a scheme when constructed. Define a static object of this class
+// in the translation unit that implements the scheme, e.g.
+//   registerConvectiveFluxScheme registerHLLC(
+//     "hllc", HLLCFluxIdealGas, selectHLLCFluxMultiSpeciesIdealGas
+//   );
+class registerConvectiveFluxScheme {
+public:
+  registerConvectiveFluxScheme(
+    char const * name,
+    IdealGasFluxFunction singleSpecies,
+    MultiSpeciesIdealGasFluxFunction (*selectMultiSpecies)(int const Ns)
+  ) {
+    ConvectiveFluxScheme scheme;
+    scheme.name = name;
+    scheme.singleSpecies = singleSpecies;
+    scheme.selectMultiSpecies = selectMultiSpecies;
+    ConvectiveFluxSchemeList::insert(scheme);
+  }
+};
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_FLUX_REGISTRY_HH
@@ -0,0 +1,41 @@
+#ifndef FLAME_GRAPH_ORDERING_HH
+#define FLAME_GRAPH_ORDERING_HH
+
+#include <utility>
+#include <vector>
+
+namespace flame {
+
+// Undirected graph in compressed sparse row form. Neighbors of vertex v are
+// adjacency[offsets[v]] to adjacency[offsets[v+1]-1].
+struct AdjacencyGraph {
+  std::vector<int> offsets;
+  std::vector<int> adjacency;
+
+  int numVertices() const {
+    return int(offsets.size())-1;
+  }
+};
+
+// Creates the graph of n vertices with the given edges. Each edge is added in
+// both directions.
+void createAdjacencyGraph(
+  int const n, std::vector<std::pair<int, int>> const & edges,
+  AdjacencyGraph & graph
+);
+
+// Computes the reverse Cuthill-McKee order of the vertices of the graph. Each
+// connected component is started from a pseudo-peripheral vertex. On return,
+// order[k] is the index of the k-th vertex in the new order.
+void reverseCuthillMcKeeOrder(
+  AdjacencyGraph const & graph, std::vector<int> & order
+);
+
+// Returns the bandwidth max |newNumber[u]-newNumber[v]| over the edges of the
+// graph when vertex order[k] is numbered k. An empty order stands for the
+// identity.
+int graphBandwidth(AdjacencyGraph const & graph, std::vector<int> const & order);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_GRAPH_ORDERING_HH
@@ -0,0 +1,47 @@
+#ifndef FLAME_GRID_RENUMBERING_HH
+#define FLAME_GRID_RENUMBERING_HH
+
+#include <Loci.h>
+
+#include <string>
+
+namespace flame {
+
+/**
+ * Renumbers cells and internal faces of the grid in facts as selected by the
+ * gridRenumbering parameter. Cells are ordered by the space-filling curve key
+ * of their centroids, or by reverse Cuthill-McKee ordering of the cell
+ * adjacency graph. Internal faces are ordered by the new numbers of their
+ * adjacent cells. Cells and internal faces keep the entity numbers originally
+ * allocated to them, so all constraints over cells and faces are unchanged as
+ * sets. In a partitioned grid each process renumbers the cells and internal
+ * faces it owns, and the maps of all processes follow the new numbers of the
+ * cells of other processes. Must be called after the grid is read and
+ * distributed and before boundary conditions are set up.
+ */
+void renumberGrid(fact_db & facts);
+
+/**
+ * Writes container var as Loci::writeContainer does, with the values of the
+ * entities renumbered by renumberGrid on this process at the numbers they had
+ * before. The values are thus written in the order of the grid file whatever
+ * the renumbering and the number of processes. Parameters and containers on
+ * entities that were not renumbered are written as they are.
+ */
+void writeRenumberedContainer(
+  hid_t fileId, std::string const & name, Loci::storeRepP var
+);
+
+/**
+ * Reads container var over dom as Loci::readContainer does from a file written
+ * by writeRenumberedContainer, moving the values to the numbers renumberGrid
+ * gave the entities.
+ */
+void readRenumberedContainer(
+  hid_t fileId, std::string const & name, Loci::storeRepP var,
+  Loci::entitySet const & dom
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_GRID_RENUMBERING_HH
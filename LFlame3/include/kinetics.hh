@@ -0,0 +1,231 @@
+#ifndef FLAME_KINETICS_HH
+#define FLAME_KINETICS_HH
+
+#include <mixture.hh>
+#include <simd.hh>
+
+#include <vector>
+
+// Number of cells whose production rates are computed together by
+// kineticsProductionRates. Each reaction is evaluated vectorized over the cells
+// of a block.
+#ifndef FLAME_KINETICS_BLOCK_SIZE
+#define FLAME_KINETICS_BLOCK_SIZE 64
+#endif
+
+// Number of coefficients per species and temperature range of the Gibbs
+// energy polynomials in KineticsTable.
+#define FLAME_KINETICS_NCOEFF 9
+
+// Standard pressure of the NASA9 polynomials: [Pa].
+#define FLAME_KINETICS_PSTD 1.0e5
+
+namespace flame {
+
+struct CompiledMechanism;
+
+enum KineticsReactionType {
+  KINETICS_ELEMENTARY,
+  KINETICS_THIRD_BODY,
+  KINETICS_LINDEMANN,
+  KINETICS_TROE
+};
+
+// Reaction mechanism of a mixture laid out for evaluation over blocks of
+// cells. The rate constants are stored as ln(A), b and the activation
+// temperature Ea/Runiv. The reactants, products, net stoichiometric
+// coefficients and third-body efficiencies of reaction r are the entries
+// [offset[r], offset[r+1]) of the corresponding species and coefficient arrays.
+// Third-body efficiencies are stored as eff-1 of the species whose efficiency
+// differs from 1, so that M = sum_s C_s + sum_e (eff_e-1) C_e.
+//
+// For species s and range k the FLAME_KINETICS_NCOEFF coefficients c starting
+// at gibbsCoefficients[(2*s+k)*FLAME_KINETICS_NCOEFF] give the dimensionless
+// standard-state Gibbs energy
+//   g/(Runiv*T) = c0/T^2 + c1*ln(T)/T + c2*ln(T) + c3/T + c4
+//     + c5*T + c6*T^2 + c7*T^3 + c8*T^4.
+struct KineticsTable {
+  int nSpecies;
+  int nReactions;
+
+  // Species molecular weights: [kg/kmol].
+  std::vector<double> W;
+
+  // Temperature at which species s switches from the lower to the upper range.
+  std::vector<double> tMid;
+  std::vector<double> gibbsCoefficients;
+
+  std::vector<int> type;
+  std::vector<int> reversible;
+  std::vector<double> lnA, b, Ta;
+  std::vector<double> lnA0, b0, Ta0;
+
+  // Troe parameters of reaction r at troe[6*r], such that the center
+  // broadening factor is
+  //   Fcent = t0*exp(-T*t1) + t2*exp(-T*t3) + t4*exp(-t5/T),
+  // i.e. t0 = 1-alpha, t1 = 1/T3, t2 = alpha, t3 = 1/T1, t4 = 1 and t5 = T2. The
+  // weight of a term that the reaction does not have is 0.
+  std::vector<double> troe;
+
+  // Sum of the net stoichiometric coefficients.
+  std::vector<double> dNu;
+
+  std::vector<int> reactantOffset, reactantSpecies;
+  std::vector<double> reactantCoeff;
+  std::vector<int> productOffset, productSpecies;
+  std::vector<double> productCoeff;
+  std::vector<int> netOffset, netSpecies;
+  std::vector<double> netCoeff;
+  std::vector<int> efficiencyOffset, efficiencySpecies;
+  std::vector<double> efficiency;
+
+  // Universal gas constant: [J/kmol.K].
+  double Runiv;
+
+  // ln(FLAME_KINETICS_PSTD/Runiv), so that ln(Pstd/(Runiv*T)) is this less ln(T).
+  double lnPstdByRuniv;
+
+  // True if any reaction is reversible and the Gibbs energies are needed.
+  bool hasReversible;
+
+  // Kernels generated for this mechanism, found in CompiledMechanismList by
+  // the hash of the table, or nullptr to interpret the table.
+  CompiledMechanism const * compiled;
+};
+
+// Builds the table from the reactions of a mixture. The reverse rate constants
+// of reversible reactions follow from the equilibrium constants, which take
+// the NASA9 polynomials of the species. Runiv is the universal gas constant:
+// [J/kmol.K]. If kernels were generated for the mechanism they are used by
+// kineticsProductionRates and kineticsMolarRates.
+void initKineticsTable(
+  KineticsTable & table, Mixture const & mixture, double const Runiv
+);
+
+// Scratch arrays of kineticsProductionRates, allocated once for a table so
+// that no memory is allocated per block.
+struct KineticsWorkspace {
+  std::vector<double> C;
+  std::vector<double> gRT;
+};
+
+void initKineticsWorkspace(KineticsWorkspace & work, KineticsTable const & table);
+
+// Computes the mass production rates omega of the species of n <=
+// FLAME_KINETICS_BLOCK_SIZE cells with density rho, temperature T and species
+// mass fractions Y: [kg/m^3.s]. Species data is in structure-of-arrays layout:
+// Y[s*FLAME_KINETICS_BLOCK_SIZE+i] is the mass fraction of species s in cell i,
+// and likewise for omega. The reactions are evaluated one after the other,
+// each vectorized over the cells of the block.
+void kineticsProductionRates(
+  KineticsTable const & table, KineticsWorkspace & work, int const n,
+  double const * rho, double const * T, double const * Y, double * omega
+);
+
+// Computes the molar production rates wdot of the species of one cell with
+// molar concentrations C and temperature T: [kmol/m^3.s]. If J is not nullptr,
+// it also computes the analytic derivatives of the rates with respect to the
+// concentrations and the temperature, including those of the third-body
+// concentration, the falloff factors and the equilibrium constants: J is
+// row-major with leading dimension ldJ >= nSpecies+1, J[s*ldJ+k] is
+// dwdot_s/dC_k and J[s*ldJ+nSpecies] is dwdot_s/dT. Columns beyond nSpecies
+// are not touched.
+void kineticsMolarRates(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, double * J, int const ldJ
+);
+
+// Computes the molar production rates of kineticsMolarRates with the Jacobian
+// assembled directly in a sparse layout, such as the one of a SparseLU of the
+// pattern of kineticsJacobianPattern. J has nonzeros entries and position maps
+// the row-major dense index s*(nSpecies+1)+k of every entry of the pattern to
+// its entry in J. The entries of J outside the pattern, and the row of index
+// nSpecies, are set to 0. J may be nullptr.
+void kineticsMolarRatesSparse(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, double * J, int const * position, int const nonzeros
+);
+
+// Rows of the Jacobian written by the rate kernels, which add to the entries of
+// a row through Row::operator[]: the dense row-major layout of
+// kineticsMolarRates and the sparse layout of kineticsMolarRatesSparse.
+struct DenseJacobian {
+  typedef double * Row;
+  double * J;
+  int ldJ;
+  Row row(int const s) const {
+    return J+s*ldJ;
+  }
+};
+
+struct SparseJacobian {
+  struct Row {
+    double * J;
+    int const * position;
+    double & operator[](int const k) const {
+      return J[position[k]];
+    }
+  };
+  double * J;
+  int const * position;
+  int n;
+  Row row(int const s) const {
+    Row r = {J, position+s*n};
+    return r;
+  }
+};
+
+// Sets pattern, of order nSpecies+1 and row-major, to the entries of the
+// Jacobian of kineticsMolarRates that may be nonzero: pattern[s*(nSpecies+1)+k]
+// is 1 if dwdot_s/dC_k, or dwdot_s/dT for k = nSpecies, is not zero for every
+// state, and 0 otherwise. The row of index nSpecies is left 0.
+void kineticsJacobianPattern(KineticsTable const & table, std::vector<char> & pattern);
+
+// Criterion of the cells whose reactions are evaluated. A cell is active if
+// its temperature is at least temperature and the sums of the mass fractions
+// of the fuel species and of the oxidizer species are at least massFraction;
+// an empty list of species is not tested. The default criterion, with
+// temperature and massFraction 0, makes every cell active.
+struct ChemistryActivity {
+  double temperature;
+  double massFraction;
+  std::vector<int> fuel;
+  std::vector<int> oxidizer;
+};
+
+inline
+bool chemistryCellActive(
+  ChemistryActivity const & activity, double const T, double const * Y
+) {
+  if(T < activity.temperature) {
+    return false;
+  }
+
+  int const nFuel = activity.fuel.size();
+  if(nFuel > 0) {
+    double sum = 0.0;
+    for(int i = 0; i < nFuel; ++i) {
+      sum += Y[activity.fuel[i]];
+    }
+    if(sum < activity.massFraction) {
+      return false;
+    }
+  }
+
+  int const nOxidizer = activity.oxidizer.size();
+  if(nOxidizer > 0) {
+    double sum = 0.0;
+    for(int i = 0; i < nOxidizer; ++i) {
+      sum += Y[activity.oxidizer[i]];
+    }
+    if(sum < activity.massFraction) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_KINETICS_HH
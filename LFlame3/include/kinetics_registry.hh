@@ -0,0 +1,90 @@
+#ifndef FLAME_KINETICS_REGISTRY_HH
+#define FLAME_KINETICS_REGISTRY_HH
+
+#include <kinetics.hh>
+
+#include <cstdint>
+#include <string>
+
+namespace flame {
+
+// Hash of the contents of a table built by initKineticsTable: its species,
+// reactions, rate constants and Gibbs energy coefficients. Mechanisms that
+// differ in any coefficient, or tables built with a different Runiv, have
+// different hashes.
+std::uint64_t kineticsTableHash(KineticsTable const & table);
+
+typedef void (*CompiledProductionRatesFunction)(
+  KineticsTable const & table, KineticsWorkspace & work, int const n,
+  double const * rho, double const * T, double const * Y, double * omega
+);
+
+typedef void (*CompiledMolarRatesFunction)(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, double * J, int const ldJ
+);
+
+typedef void (*CompiledMolarRatesSparseFunction)(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, double * J, int const * position, int const nonzeros
+);
+
+// Rate kernels generated by LFlame3MechGen for the mechanism of the table with
+// the given hash. The reactions are unrolled into straight-line code with the
+// coefficients as constants. The functions have the interface of
+// kineticsProductionRates, kineticsMolarRates and kineticsMolarRatesSparse,
+// which call them for a table whose compiled kernels are set.
+struct CompiledMechanism {
+  char const * name;
+  std::uint64_t hash;
+  CompiledProductionRatesFunction productionRates;
+  CompiledMolarRatesFunction molarRates;
+  CompiledMolarRatesSparseFunction molarRatesSparse;
+};
+
+class CompiledMechanismList {
+public:
+  struct Item {
+    CompiledMechanism entry;
+    Item * next;
+  };
+
+  static Item * items;
+
+  static void insert(CompiledMechanism const & mechanism) {
+    Item * p = new Item;
+    p->next = items;
+    p->entry = mechanism;
+    items = p;
+  }
+
+  // Returns the mechanism registered with hash, or nullptr if there is none.
+  static CompiledMechanism const * find(std::uint64_t const hash);
+
+  // Returns the names of the registered mechanisms separated by ", ".
+  static std::string names();
+};
+
+// Registers the kernels of a mechanism when constructed. The generated source
+// of a mechanism defines a static object of this class.
+class registerCompiledMechanism {
+public:
+  registerCompiledMechanism(
+    char const * name, std::uint64_t const hash,
+    CompiledProductionRatesFunction productionRates,
+    CompiledMolarRatesFunction molarRates,
+    CompiledMolarRatesSparseFunction molarRatesSparse
+  ) {
+    CompiledMechanism mechanism;
+    mechanism.name = name;
+    mechanism.hash = hash;
+    mechanism.productionRates = productionRates;
+    mechanism.molarRates = molarRates;
+    mechanism.molarRatesSparse = molarRatesSparse;
+    CompiledMechanismList::insert(mechanism);
+  }
+};
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_KINETICS_REGISTRY_HH
@@ -6,6 +6,10 @@
 #include <vector>
 #include <string>
 
+// Universal gas constant of the solver, which the tables of a mechanism and
+// its generated kernels are built with: [J/kmol.K].
+#define FLAME_RUNIV 8314.46261815324
+
 namespace flame {
 
 // =============================================================================
@@ -45,6 +49,12 @@ struct NASA9Thermochemistry {
   double sCoeff[18];
 };
 
+// Rate constant k = A*T^b*exp(-Ea/(Runiv*T)) of a reaction. The rate constants
+// are in units of kmol, m^3 and s, and the activation energy Ea in J/kmol.
+struct ArrheniusRate {
+  double A, b, Ea;
+};
+
 enum ViscosityModel {
   VISCOSITY_CONSTANT,
   VISCOSITY_SUTHERLAND,
@@ -69,6 +79,54 @@ enum ThermochemistryModel {
   THERMOCHEMISTRY_NONE
 };
 
+enum FalloffModel {
+  FALLOFF_LINDEMANN,
+  FALLOFF_TROE,
+  FALLOFF_NONE
+};
+
+// Maximum number of reactants or products of a reaction.
+#ifndef FLAME_MAX_REACTION_SPECIES
+#define FLAME_MAX_REACTION_SPECIES 8
+#endif
+
+// Maximum number of third-body efficiencies of a reaction.
+#ifndef FLAME_MAX_REACTION_EFFICIENCIES
+#define FLAME_MAX_REACTION_EFFICIENCIES 16
+#endif
+
+// A reaction sum_i nu'_i X_i <=> sum_i nu''_i X_i between the species of a
+// mixture. Species are referenced by their index in the mixture.
+struct Reaction {
+  int nReactants;
+  int reactantSpecies[FLAME_MAX_REACTION_SPECIES];
+  double reactantCoeff[FLAME_MAX_REACTION_SPECIES];
+
+  int nProducts;
+  int productSpecies[FLAME_MAX_REACTION_SPECIES];
+  double productCoeff[FLAME_MAX_REACTION_SPECIES];
+
+  // The reverse rate constant follows from the equilibrium constant.
+  int reversible;
+
+  // Rate constant, or its high-pressure limit with falloff.
+  ArrheniusRate rate;
+
+  // Third-body collision partner M with the efficiencies of the listed species.
+  // The efficiency of the other species is 1.
+  int hasThirdBody;
+  int nEfficiencies;
+  int efficiencySpecies[FLAME_MAX_REACTION_EFFICIENCIES];
+  double efficiency[FLAME_MAX_REACTION_EFFICIENCIES];
+
+  // Pressure-dependent falloff between lowPressureRate and rate. troe holds
+  // alpha, T3, T1 and, if nTroe is 4, T2 of the Troe form.
+  FalloffModel falloffModel;
+  ArrheniusRate lowPressureRate;
+  int nTroe;
+  double troe[4];
+};
+
 struct Mixture {
   int nSpecies;
 
@@ -118,8 +176,13 @@ struct Mixture {
   NASA9Thermochemistry nasa9Thermochemistry[FLAME_MAX_NSPECIES];
   int hasNasa9Thermochemistry[FLAME_MAX_NSPECIES];
 
+  // Reaction mechanism
+  int nReactions;
+  Reaction reactions[FLAME_MAX_NREACTIONS];
+
   void clear();
   void clearSpecies(int idx);
+  void clearReaction(int idx);
 };
 
 // =============================================================================
@@ -132,6 +195,8 @@ char const * getDiffusivityModelName(DiffusivityModel m);
 
 char const * getThermochemistryModelName(ThermochemistryModel m);
 
+char const * getFalloffModelName(FalloffModel m);
+
 // =============================================================================
 
 std::ostream & operator<<(std::ostream & s, Mixture const & mix);
@@ -285,6 +350,142 @@ struct data_schema_traits<flame::NASA9Thermochemistry> {
   }
 };
 
+template<>
+struct data_schema_traits<flame::ArrheniusRate> {
+  typedef IDENTITY_CONVERTER Schema_Converter;
+  static DatatypeP get_type() {
+    CompoundDatatypeP cmpd = CompoundFactory(flame::ArrheniusRate());
+    LOCI_INSERT_TYPE(cmpd, flame::ArrheniusRate, A);
+    LOCI_INSERT_TYPE(cmpd, flame::ArrheniusRate, b);
+    LOCI_INSERT_TYPE(cmpd, flame::ArrheniusRate, Ea);
+    return DatatypeP(cmpd);
+  }
+};
+
+template<>
+struct data_schema_traits<flame::FalloffModel> {
+  typedef IDENTITY_CONVERTER Schema_Converter;
+  static DatatypeP get_type() {
+    int a;
+    return getLociType(a);
+  }
+};
+
+template<>
+struct data_schema_traits<flame::Reaction> {
+  typedef IDENTITY_CONVERTER Schema_Converter;
+  static DatatypeP get_type() {
+    flame::Reaction m;
+
+    CompoundDatatypeP cmpd = CompoundFactory(flame::Reaction());
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, nReactants);
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_REACTION_SPECIES};
+      int size = sizeof(int)*FLAME_MAX_REACTION_SPECIES;
+      DatatypeP atom = getLociType(m.reactantSpecies[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "reactantSpecies",
+        offsetof(flame::Reaction, reactantSpecies),
+        DatatypeP(array_t)
+      );
+    }
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_REACTION_SPECIES};
+      int size = sizeof(double)*FLAME_MAX_REACTION_SPECIES;
+      DatatypeP atom = getLociType(m.reactantCoeff[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "reactantCoeff",
+        offsetof(flame::Reaction, reactantCoeff),
+        DatatypeP(array_t)
+      );
+    }
+
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, nProducts);
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_REACTION_SPECIES};
+      int size = sizeof(int)*FLAME_MAX_REACTION_SPECIES;
+      DatatypeP atom = getLociType(m.productSpecies[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "productSpecies",
+        offsetof(flame::Reaction, productSpecies),
+        DatatypeP(array_t)
+      );
+    }
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_REACTION_SPECIES};
+      int size = sizeof(double)*FLAME_MAX_REACTION_SPECIES;
+      DatatypeP atom = getLociType(m.productCoeff[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "productCoeff",
+        offsetof(flame::Reaction, productCoeff),
+        DatatypeP(array_t)
+      );
+    }
+
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, reversible);
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, rate);
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, hasThirdBody);
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, nEfficiencies);
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_REACTION_EFFICIENCIES};
+      int size = sizeof(int)*FLAME_MAX_REACTION_EFFICIENCIES;
+      DatatypeP atom = getLociType(m.efficiencySpecies[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "efficiencySpecies",
+        offsetof(flame::Reaction, efficiencySpecies),
+        DatatypeP(array_t)
+      );
+    }
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_REACTION_EFFICIENCIES};
+      int size = sizeof(double)*FLAME_MAX_REACTION_EFFICIENCIES;
+      DatatypeP atom = getLociType(m.efficiency[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "efficiency",
+        offsetof(flame::Reaction, efficiency),
+        DatatypeP(array_t)
+      );
+    }
+
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, falloffModel);
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, lowPressureRate);
+    LOCI_INSERT_TYPE(cmpd, flame::Reaction, nTroe);
+
+    {
+      int rank = 1;
+      int dim[] = {4};
+      int size = sizeof(double)*4;
+      DatatypeP atom = getLociType(m.troe[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "troe",
+        offsetof(flame::Reaction, troe),
+        DatatypeP(array_t)
+      );
+    }
+
+    return DatatypeP(cmpd);
+  }
+};
+
 template<>
 struct data_schema_traits<flame::ViscosityModel> {
   typedef IDENTITY_CONVERTER Schema_Converter;
@@ -694,6 +895,21 @@ struct data_schema_traits<flame::Mixture> {
       );
     }
 
+    LOCI_INSERT_TYPE(cmpd, flame::Mixture, nReactions);
+
+    {
+      int rank = 1;
+      int dim[] = {FLAME_MAX_NREACTIONS};
+      int size = sizeof(flame::Reaction)*FLAME_MAX_NREACTIONS;
+      DatatypeP atom = getLociType(m.reactions[0]);
+      ArrayDatatypeP array_t = ArrayFactory(atom, size, rank, dim);
+      cmpd->insert(
+        "reactions",
+        offsetof(flame::Mixture, reactions),
+        DatatypeP(array_t)
+      );
+    }
+
     return DatatypeP(cmpd);
   }
 };
@@ -0,0 +1,181 @@
+#ifndef FLAME_NASA9_HH
+#define FLAME_NASA9_HH
+
+#include <mixture.hh>
+#include <simd.hh>
+
+#include <vector>
+
+// Number of cells whose temperature is computed together by
+// nasa9TemperatureFromEnergy. The Newton iteration runs vectorized over the
+// cells of a block.
+#ifndef FLAME_NASA9_BLOCK_SIZE
+#define FLAME_NASA9_BLOCK_SIZE 64
+#endif
+
+// Maximum number of Newton iterations of nasa9TemperatureFromEnergy.
+#ifndef FLAME_NASA9_MAX_ITERATIONS
+#define FLAME_NASA9_MAX_ITERATIONS 20
+#endif
+
+// Relative temperature change at which the Newton iteration of
+// nasa9TemperatureFromEnergy is converged.
+#ifndef FLAME_NASA9_TOLERANCE
+#define FLAME_NASA9_TOLERANCE 1.0e-10
+#endif
+
+// Number of coefficients per species and temperature range in NASA9Table.
+#define FLAME_NASA9_NCOEFF 15
+
+// Number of values per species and temperature in NASA9LookupTable.
+#define FLAME_NASA9_LOOKUP_NVALUES 4
+
+namespace flame {
+
+// Specific heat and specific enthalpy, including the enthalpy of formation, of
+// Ns species with NASA 9-coefficient polynomials at temperature T. sR are the
+// species gas constants: [J/kg.K]. The polynomial of the lower temperature
+// range is used below tRange[1] and that of the upper range above it.
+void nasa9_sCp_sH_from_T(
+  int const Ns, double * sCp, double * sH,
+  NASA9Thermochemistry const * thermo, double const * sR, double const T
+);
+
+// Specific entropy at the standard pressure of 1 bar of Ns species with NASA
+// 9-coefficient polynomials at temperature T: [J/kg.K].
+void nasa9_sS_from_T(
+  int const Ns, double * sS,
+  NASA9Thermochemistry const * thermo, double const * sR, double const T
+);
+
+// NASA 9-coefficient polynomials of the species of a mixture, scaled by the
+// species gas constants and laid out for evaluation over blocks of cells. For
+// species s and range k (0 for the lower and 1 for the upper temperature
+// range) the FLAME_NASA9_NCOEFF coefficients c starting at
+// coefficients[(2*s+k)*FLAME_NASA9_NCOEFF] give
+//   cp = c0/T^2 + c1/T + c2 + c3*T + c4*T^2 + c5*T^3 + c6*T^4,
+//   h = c7/T + c8*ln(T) + c9*T + c10*T^2 + c11*T^3 + c12*T^4 + c13*T^5 + c14.
+struct NASA9Table {
+  int nSpecies;
+
+  // Temperature range in which the polynomials of all species are valid.
+  double tMin;
+  double tMax;
+
+  // Temperature at which species s switches from the lower to the upper range.
+  std::vector<double> tMid;
+
+  std::vector<double> coefficients;
+};
+
+void initNASA9Table(
+  NASA9Table & table, int const Ns,
+  NASA9Thermochemistry const * thermo, double const * sR
+);
+
+// Result of the temperature of a cell computed by nasa9TemperatureFromEnergy.
+enum NASA9TemperatureStatus {
+  NASA9_TEMPERATURE_CONVERGED,
+  // The energy is outside the range of the table and the temperature is
+  // limited to tMin or tMax.
+  NASA9_TEMPERATURE_LIMITED,
+  // The iteration did not converge in FLAME_NASA9_MAX_ITERATIONS iterations.
+  NASA9_TEMPERATURE_NOT_CONVERGED
+};
+
+// Computes the temperature T of n <= FLAME_NASA9_BLOCK_SIZE cells from their
+// specific internal energy e (including the enthalpies of formation), gas
+// constant R and species mass fractions Y by Newton iteration on
+//   sum_s Y_s h_s(T) - R*T = e.
+// On input T holds the initial guess, e.g. the temperature of the previous
+// Runge-Kutta stage. The iterates are limited to [tMin, tMax] of the table.
+// Species data is in structure-of-arrays layout: Y[s*FLAME_NASA9_BLOCK_SIZE+i]
+// is the mass fraction of species s in cell i, and likewise for the species
+// specific heats sCp and specific enthalpies sH, which are returned at the
+// final temperature. Returns the number of Newton iterations carried out, or
+// -1 if the iteration of a cell did not converge. If status is not nullptr,
+// status[i] is set to the result of cell i.
+int nasa9TemperatureFromEnergy(
+  NASA9Table const & table, int const n,
+  double const * e, double const * R, double const * Y,
+  double * T, double * sCp, double * sH,
+  NASA9TemperatureStatus * status = nullptr
+);
+
+// Interpolation of the species properties in NASA9LookupTable.
+enum NASA9Interpolation {
+  NASA9_INTERPOLATION_LINEAR,
+  NASA9_INTERPOLATION_CUBIC
+};
+
+// Species specific heat, enthalpy and entropy tabulated on a uniform grid of
+// nPoints temperatures tMin+k*dT, k = 0, ..., nPoints-1. The values of all
+// species at a temperature are contiguous, so that evaluating a mixture reads
+// two contiguous blocks of the table instead of evaluating a logarithm and
+// reciprocal powers of T for every species. At temperature k the
+// FLAME_NASA9_LOOKUP_NVALUES values v starting at
+// values[(k*nSpecies+s)*FLAME_NASA9_LOOKUP_NVALUES] are cp, dcp/dT, h and s of
+// species s. Cubic interpolation is Hermite interpolation with the exact
+// derivatives dcp/dT, dh/dT = cp and ds/dT = cp/T.
+struct NASA9LookupTable {
+  int nSpecies;
+  int nPoints;
+  NASA9Interpolation interpolation;
+
+  double tMin;
+  double tMax;
+  double dT;
+  double rdT;
+
+  std::vector<double> values;
+};
+
+// Tabulates the species of a mixture over the temperature range in which the
+// polynomials of all species are valid, with a spacing of at most dT. Returns
+// the largest interpolation error at the midpoints of the intervals, relative
+// to cp for cp and s, and to cp*T for h.
+double initNASA9LookupTable(
+  NASA9LookupTable & lookup, int const Ns,
+  NASA9Thermochemistry const * thermo, double const * sR,
+  double const dT, NASA9Interpolation const interpolation
+);
+
+// Specific heat, enthalpy and entropy of the species at temperature T,
+// interpolated from the table. T is limited to [tMin, tMax] of the table.
+void nasa9LookupSpecies(
+  NASA9LookupTable const & lookup, double const T,
+  double * sCp, double * sH, double * sS
+);
+
+// Same as nasa9TemperatureFromEnergy with the species properties interpolated
+// from the lookup table.
+int nasa9TemperatureFromEnergy(
+  NASA9LookupTable const & lookup, int const n,
+  double const * e, double const * R, double const * Y,
+  double * T, double * sCp, double * sH,
+  NASA9TemperatureStatus * status = nullptr
+);
+
+// Species thermodynamics of a mixture with NASA9 polynomials, evaluated from
+// the polynomials or, if useLookup is true, from the lookup table.
+struct NASA9Thermodynamics {
+  bool useLookup;
+  NASA9Table table;
+  NASA9LookupTable lookup;
+};
+
+inline
+int nasa9TemperatureFromEnergy(
+  NASA9Thermodynamics const & thermo, int const n,
+  double const * e, double const * R, double const * Y,
+  double * T, double * sCp, double * sH,
+  NASA9TemperatureStatus * status = nullptr
+) {
+  return thermo.useLookup ?
+    nasa9TemperatureFromEnergy(thermo.lookup, n, e, R, Y, T, sCp, sH, status) :
+    nasa9TemperatureFromEnergy(thermo.table, n, e, R, Y, T, sCp, sH, status);
+}
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_NASA9_HH
@@ -0,0 +1,13 @@
+#ifndef FLAME_PARALLEL_HH
+#define FLAME_PARALLEL_HH
+
+// Marks a loop whose iterations are independent and free of write conflicts so
+// that it is distributed over threads. Without OpenMP support the loop runs
+// serially.
+#if defined(FLAME_HAVE_OPENMP)
+#define FLAME_PARALLEL_FOR _Pragma("omp parallel for schedule(static)")
+#else
+#define FLAME_PARALLEL_FOR
+#endif
+
+#endif // end: #ifndef FLAME_PARALLEL_HH
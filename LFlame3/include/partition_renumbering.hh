@@ -0,0 +1,68 @@
+#ifndef FLAME_PARTITION_RENUMBERING_HH
+#define FLAME_PARTITION_RENUMBERING_HH
+
+#include <mpi.h>
+
+#include <utility>
+#include <vector>
+
+namespace flame {
+
+// Renumbering of the cells and internal faces owned by one process of a
+// partitioned grid. The cells and faces of a process are permuted among the
+// numbers the process owns, so that the partition of the entities is
+// unchanged, and every process learns the new numbers of the cells of other
+// processes that its faces refer to.
+//
+// cells are the cells owned by the process in increasing order and order their
+// new order: cell cells[order[k]] takes number cells[k]. faces are the
+// internal faces owned by the process in increasing order, left and right
+// their cells and leftOwner and rightOwner the processes of comm that own
+// those cells.
+struct PartitionRenumbering {
+  std::vector<int> cells;
+  std::vector<int> order;
+  std::vector<int> faces;
+  std::vector<int> left, right;
+  std::vector<int> leftOwner, rightOwner;
+
+  // (old, new) numbers of the owned cells and faces, sorted by old number.
+  std::vector<std::pair<int, int> > remap;
+
+  // (old, new) numbers of the cells of other processes that the faces refer
+  // to, sorted by old number.
+  std::vector<std::pair<int, int> > remoteRemap;
+};
+
+// Computes remap and remoteRemap. The faces are ordered by the new numbers of
+// their cells, the smaller first, so that the face loops sweep the cells in
+// order. All processes of comm must call it.
+void renumberPartition(PartitionRenumbering & renumbering, MPI_Comm comm);
+
+// Looks up the new numbers of entities of other processes. remap holds the
+// (old, new) numbers of the entities renumbered by this process, sorted by old
+// number. requests[p] lists entities owned by process p of comm; on return
+// numbers[p][i] is the new number of requests[p][i], which is the old one if
+// process p did not renumber it. All processes of comm must call it.
+void exchangeRenumbering(
+  std::vector<std::pair<int, int> > const & remap,
+  std::vector<std::vector<int> > const & requests,
+  std::vector<std::vector<int> > & numbers, MPI_Comm comm
+);
+
+// Returns the new number of entity e in remap, (old, new) numbers sorted by old
+// number, or e if it is not renumbered.
+int renumberedEntity(
+  std::vector<std::pair<int, int> > const & remap, int const e
+);
+
+// Sets inverse to the (new, old) numbers of remap sorted by new number, in
+// which renumberedEntity looks up the old number of an entity.
+void invertRenumbering(
+  std::vector<std::pair<int, int> > const & remap,
+  std::vector<std::pair<int, int> > & inverse
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_PARTITION_RENUMBERING_HH
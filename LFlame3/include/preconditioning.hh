@@ -0,0 +1,40 @@
+#ifndef FLAME_PRECONDITIONING_HH
+#define FLAME_PRECONDITIONING_HH
+
+#include <Loci.h>
+
+namespace flame {
+
+// Low-Mach preconditioning of Weiss and Smith for the thermally perfect gas
+// with primitive variables (p, u, T, Y). The preconditioner replaces the
+// derivative of density with respect to pressure by
+//   theta = 1/Ur^2 + 1/(Cp*T),
+// where Ur is the reference velocity. With Ur equal to the speed of sound the
+// preconditioner is the Jacobian of the conservative variables with respect to
+// the primitive variables and the scheme is unchanged.
+
+// Reference velocity Ur of the preconditioner: the velocity magnitude, bounded
+// below by Mcut times the speed of sound a and above by a.
+double lowMachReferenceVelocity(double const Umag, double const a, double const Mcut);
+
+// Largest eigenvalue magnitude of the preconditioned system in the direction
+// of unit normal n, where Un is the normal velocity.
+double preconditionedSpectralRadius(double const Un, double const a, double const Ur);
+
+// Transforms the residual R in the layout of msResidual (momentum x, y, z,
+// energy, mass, partial densities of the first Ns-1 species) in place into the
+// rate of change of the conservative variables of the preconditioned system.
+// h0 is the specific total enthalpy and a the speed of sound. Y, sh (species
+// specific enthalpies) and sW (species molecular weights) are used only for
+// Ns > 1; mW is the mixture molecular weight. For single-species residuals pass
+// Ns = 1.
+void preconditionResidual(
+  double * R, int const Ns,
+  Loci::vector3d<double> const & U, double const h0,
+  double const Cp, double const T, double const a, double const Ur,
+  double const * Y, double const * sh, double const * sW, double const mW
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_PRECONDITIONING_HH
@@ -0,0 +1,26 @@
+#ifndef FLAME_SIMD_HH
+#define FLAME_SIMD_HH
+
+// Marks a loop whose iterations are independent so that the compiler emits
+// vector code for it. The instruction set used (SSE2, AVX2, AVX-512) is the one
+// the compiler is configured to target, e.g. with -march=native. Without OpenMP
+// SIMD support the loop falls back to scalar code (or to whatever the
+// auto-vectorizer makes of it).
+//
+// FLAME_SIMD_SUM_LOOP(a, b) marks a vector loop that also sums into the scalars
+// a, b, which are then reduced over the vector lanes. A loop that accumulates
+// into a scalar must use it instead of FLAME_SIMD_LOOP.
+#if defined(FLAME_HAVE_OPENMP_SIMD)
+#define FLAME_SIMD_LOOP _Pragma("omp simd")
+#define FLAME_SIMD_PRAGMA(x) _Pragma(#x)
+#define FLAME_SIMD_SUM_LOOP(...) FLAME_SIMD_PRAGMA(omp simd reduction(+:__VA_ARGS__))
+#else
+#define FLAME_SIMD_LOOP
+#define FLAME_SIMD_SUM_LOOP(...)
+#endif
+
+// Alignment of the arrays processed by vector loops. It is the width of an
+// AVX-512 register, which also satisfies narrower instruction sets.
+#define FLAME_SIMD_ALIGN 64
+
+#endif // end: #ifndef FLAME_SIMD_HH
@@ -0,0 +1,46 @@
+#ifndef FLAME_SPACE_FILLING_CURVE_HH
+#define FLAME_SPACE_FILLING_CURVE_HH
+
+#include <Loci.h>
+
+#include <cstdint>
+#include <vector>
+
+// Number of bits per coordinate used for space-filling curve keys.
+#define FLAME_SFC_BITS 21
+
+namespace flame {
+
+enum class SpaceFillingCurve {
+  Morton,
+  Hilbert
+};
+
+// Key of point (x, y, z) on the Morton (Z-order) curve. Coordinates must be
+// less than 2^bits and bits must not exceed FLAME_SFC_BITS.
+std::uint64_t mortonKey(
+  std::uint32_t const x, std::uint32_t const y, std::uint32_t const z,
+  int const bits
+);
+
+// Key of point (x, y, z) on the Hilbert curve. Coordinates must be less than
+// 2^bits and bits must not exceed FLAME_SFC_BITS. Points with consecutive keys
+// are face neighbors.
+std::uint64_t hilbertKey(
+  std::uint32_t const x, std::uint32_t const y, std::uint32_t const z,
+  int const bits
+);
+
+// Computes the order of points along the space-filling curve. The points are
+// quantized on a uniform lattice of 2^FLAME_SFC_BITS points per direction
+// spanning their bounding box. On return, order[k] is the index of the k-th
+// point along the curve. Points with equal keys keep their relative order.
+void spaceFillingCurveOrder(
+  std::vector<Loci::vector3d<double>> const & points,
+  SpaceFillingCurve const curve,
+  std::vector<int> & order
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_SPACE_FILLING_CURVE_HH
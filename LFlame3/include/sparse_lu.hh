@@ -0,0 +1,63 @@
+#ifndef FLAME_SPARSE_LU_HH
+#define FLAME_SPARSE_LU_HH
+
+#include <vector>
+
+namespace flame {
+
+// Symbolic LU factorization of the matrices of order n with a given sparsity
+// pattern, computed once and reused for every matrix with that pattern. The
+// rows and columns are ordered by minimum degree of the symmetrized pattern to
+// reduce the fill, and the pivots are the diagonal entries in that order, so
+// that the pattern of L+U is fixed. The entries of L+U are stored by rows of
+// the permuted matrix in values arrays of nonzeros entries: row i takes
+// [rowStart[i], rowStart[i+1]) with the columns in increasing order, L has a
+// unit diagonal and is stored left of the diagonal, U on and right of it.
+//
+// The numeric factorization follows a list of operations laid out here, so
+// that it does no index search. For entry p = pivotEntry[q] of L in column k
+// it divides by the diagonal entry pivotDiagonal[q] of U in row k, and then
+// subtracts the product with entry updateSource[u] of row k of U from entry
+// updateTarget[u] for u in [updateStart[q], updateStart[q+1]).
+struct SparseLU {
+  int n;
+  int nonzeros;
+
+  // Row or column perm[i] of the matrix is row or column i of the permuted one.
+  std::vector<int> perm;
+
+  std::vector<int> rowStart, column, diagonal;
+
+  // Index of entry p in the row-major dense form of the unpermuted matrix, and
+  // the inverse: the entry of dense index i*n+j, or -1 if (i, j) is not in the
+  // pattern of L+U.
+  std::vector<int> denseIndex;
+  std::vector<int> position;
+
+  std::vector<int> rowPivotStart;
+  std::vector<int> pivotEntry, pivotDiagonal, updateStart;
+  std::vector<int> updateTarget, updateSource;
+};
+
+// Computes the symbolic factorization of the matrices of order n whose entry
+// (i, j) may be nonzero if pattern[i*n+j] is not zero. The diagonal is always
+// part of the pattern.
+void initSparseLU(SparseLU & lu, int const n, std::vector<char> const & pattern);
+
+// Factorizes the matrix with the entries values of the pattern of lu in place.
+// Returns false if a pivot is smaller than pivotTolerance times the largest
+// entry of its row, in which case the matrix needs pivoting off the diagonal
+// and values is left partly factorized.
+bool sparseLUFactor(
+  SparseLU const & lu, double * values, double const pivotTolerance = 1.0e-12
+);
+
+// Solves Ax = b with the factorization of sparseLUFactor. b is overwritten by x;
+// work holds n values.
+void sparseLUSolve(
+  SparseLU const & lu, double const * values, double * b, double * work
+);
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_SPARSE_LU_HH
@@ -0,0 +1,55 @@
+#ifndef FLAME_TRANSPORT_HH
+#define FLAME_TRANSPORT_HH
+
+#include <cmath>
+#include <vector>
+
+namespace flame {
+
+// Factors of the Wilke weighting function
+//   phi_km = (8*(1+W_k/W_m))^(-1/2)*(1+(mu_k/mu_m)^(1/2)*(W_m/W_k)^(1/4))^2
+// of the species pairs (k, m) that depend only on the molecular weights W of
+// the N species: factors[2*(m*N+k)] is (8*(1+W_k/W_m))^(-1/2) and
+// factors[2*(m*N+k)+1] is (W_m/W_k)^(1/4).
+inline
+void initWilkeTransportFactors(
+  int const N, double const * W, std::vector<double> & factors
+) {
+  factors.resize(2*N*N);
+  for(int m = 0; m < N; ++m) {
+    for(int k = 0; k < N; ++k) {
+      double const wratio = W[k]/W[m];
+      factors[2*(m*N+k)] = 1.0/std::sqrt(8.0*(1.0+wratio));
+      factors[2*(m*N+k)+1] = std::pow(1.0/wratio, 0.25);
+    }
+  }
+}
+
+// Sets phi[k][m] to the Wilke weighting function of the species with
+// viscosities mu from the factors of initWilkeTransportFactors. The square
+// roots of the viscosities are taken once per species, so that a pair takes
+// four multiplications and an addition and no transcendental function.
+template<typename Matrix>
+void wilkeTransportPhi(
+  Matrix phi, int const N, double const * factors, double const * mu
+) {
+  double smu[FLAME_MAX_NSPECIES];
+  double rsmu[FLAME_MAX_NSPECIES];
+  for(int k = 0; k < N; ++k) {
+    smu[k] = std::sqrt(mu[k]);
+    rsmu[k] = 1.0/smu[k];
+  }
+
+  for(int m = 0; m < N; ++m) {
+    double const * f = factors+2*m*N;
+    double const r = rsmu[m];
+    for(int k = 0; k < N; ++k) {
+      double const t = 1.0+smu[k]*r*f[2*k+1];
+      phi[k][m] = f[2*k]*t*t;
+    }
+  }
+}
+
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_TRANSPORT_HH
@@ -0,0 +1,481 @@
+#include <chemistry_integrator.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace flame {
+
+namespace {
+
+// Sets the dense Jacobian J of the workspace to the one assembled in the
+// entries of the sparse factorization.
+void scatterSparseJacobian(ChemistryWorkspace & work, SparseLU const & sparse) {
+  int const n = work.n;
+  double * J = &work.J[0];
+  std::fill(J, J+n*n, 0.0);
+  for(int p = 0; p < sparse.nonzeros; ++p) {
+    J[sparse.denseIndex[p]] = work.sparseJ[p];
+  }
+}
+
+// Factorizes the matrix I*diagonal-J of a step with the Jacobian of the
+// workspace: with the sparse factorization if there is one, from the Jacobian
+// assembled in its entries, and the diagonal pivots suffice, as a dense matrix
+// otherwise.
+bool factorStepMatrix(
+  ChemistryWorkspace & work, SparseLU const * sparse, double const diagonal
+) {
+  int const n = work.n;
+
+  if(sparse != nullptr) {
+    double * values = &work.values[0];
+    double const * sparseJ = &work.sparseJ[0];
+    for(int p = 0; p < sparse->nonzeros; ++p) {
+      values[p] = -sparseJ[p];
+    }
+    for(int i = 0; i < n; ++i) {
+      values[sparse->diagonal[i]] += diagonal;
+    }
+    if(sparseLUFactor(*sparse, values)) {
+      work.sparseStep = sparse;
+      return true;
+    }
+    scatterSparseJacobian(work, *sparse);
+  }
+
+  work.sparseStep = nullptr;
+  double const * J = &work.J[0];
+  double * A = &work.A[0];
+  for(int i = 0; i < n*n; ++i) {
+    A[i] = -J[i];
+  }
+  for(int i = 0; i < n; ++i) {
+    A[i*n+i] += diagonal;
+  }
+  return work.lu.factor(n, A, &work.pivot[0]);
+}
+
+// Evaluates the right-hand side f and the Jacobian of the reactor at y: in the
+// entries of the sparse factorization if there is one, and as a dense matrix
+// also if dense is true or there is none.
+void evaluateJacobian(
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  SparseLU const * sparse, ChemistryWorkspace & work,
+  double const * y, double * f, bool const dense
+) {
+  if(sparse == nullptr) {
+    chemistryRightHandSide(kinetics, thermo, work, y, f, &work.J[0]);
+    return;
+  }
+  chemistryRightHandSideSparse(
+    kinetics, thermo, *sparse, work, y, f, &work.sparseJ[0]
+  );
+  if(dense) {
+    scatterSparseJacobian(work, *sparse);
+  }
+}
+
+// Solves a system with the matrix of the step factorized by factorStepMatrix.
+void solveStepMatrix(ChemistryWorkspace & work, double * b) {
+  if(work.sparseStep != nullptr) {
+    sparseLUSolve(*work.sparseStep, &work.values[0], b, &work.solveWork[0]);
+  } else {
+    work.lu.solve(work.n, &work.A[0], &work.pivot[0], b);
+  }
+}
+
+// Multiplies the sensitivity S from the left by the derivative of the accepted
+// ROS3 step with the Jacobian J and the factorization of I/(gamma*h)-J in the
+// workspace. With the Jacobian held fixed the stages give, column by column,
+//   dk1 = (I/(gamma*h)-J)^-1 J,
+//   dk2 = (I/(gamma*h)-J)^-1 (J (I+dk1) + c21/h*dk1),
+//   dk3 = (I/(gamma*h)-J)^-1 (J (I+dk1) + (c31*dk1+c32*dk2)/h),
+// and the step I+m1*dk1+m2*dk2+m3*dk3. The stage vectors of the workspace are
+// free once the step is accepted and hold the columns.
+void accumulateStepSensitivity(
+  ChemistryWorkspace & work, int const n, double const rh,
+  double const c21, double const c31, double const c32,
+  double const m1, double const m2, double const m3, double * S
+) {
+  double const * J = &work.J[0];
+  double * d1 = &work.k1[0];
+  double * d2 = &work.k2[0];
+  double * d3 = &work.k3[0];
+  double * g = &work.y1[0];
+  double * D = &work.stepSensitivity[0];
+  double * P = &work.product[0];
+
+  for(int j = 0; j < n; ++j) {
+    for(int i = 0; i < n; ++i) {
+      d1[i] = J[i*n+j];
+    }
+    solveStepMatrix(work, d1);
+
+    for(int i = 0; i < n; ++i) {
+      double const * Ji = J+i*n;
+      double sum = Ji[j];
+      for(int k = 0; k < n; ++k) {
+        sum += Ji[k]*d1[k];
+      }
+      g[i] = sum;
+      d2[i] = sum+c21*d1[i]*rh;
+    }
+    solveStepMatrix(work, d2);
+
+    for(int i = 0; i < n; ++i) {
+      d3[i] = g[i]+(c31*d1[i]+c32*d2[i])*rh;
+    }
+    solveStepMatrix(work, d3);
+
+    for(int i = 0; i < n; ++i) {
+      D[i*n+j] = (i == j ? 1.0 : 0.0)+m1*d1[i]+m2*d2[i]+m3*d3[i];
+    }
+  }
+
+  for(int i = 0; i < n; ++i) {
+    double * Pi = P+i*n;
+    for(int j = 0; j < n; ++j) {
+      Pi[j] = 0.0;
+    }
+    for(int k = 0; k < n; ++k) {
+      double const Dik = D[i*n+k];
+      double const * Sk = S+k*n;
+      for(int j = 0; j < n; ++j) {
+        Pi[j] += Dik*Sk[j];
+      }
+    }
+  }
+  for(int i = 0; i < n*n; ++i) {
+    S[i] = P[i];
+  }
+}
+
+} // end: namespace
+
+void initChemistryWorkspace(
+  ChemistryWorkspace & work, KineticsTable const & kinetics
+) {
+  int const n = kinetics.nSpecies+1;
+  work.n = n;
+  work.lu = selectDenseLU(n);
+  work.y.resize(n);
+  work.y1.resize(n);
+  work.f.resize(n);
+  work.k1.resize(n);
+  work.k2.resize(n);
+  work.k3.resize(n);
+  work.atol.resize(n);
+  work.J.resize(n*n);
+  work.A.resize(n*n);
+  work.pivot.resize(n);
+  work.sparseStep = nullptr;
+  work.U.resize(n-1);
+  work.Cv.resize(n-1);
+  work.stepSensitivity.resize(n*n);
+  work.product.resize(n*n);
+}
+
+void initChemistrySparseLU(SparseLU & lu, KineticsTable const & kinetics) {
+  int const n = kinetics.nSpecies+1;
+  std::vector<char> pattern;
+  kineticsJacobianPattern(kinetics, pattern);
+  for(int k = 0; k < n; ++k) {
+    pattern[(n-1)*n+k] = 1;
+  }
+  initSparseLU(lu, n, pattern);
+}
+
+namespace {
+
+// Sets f[Ns] of the reactor to the rate of change of the temperature from the
+// molar rates f[0, Ns), and the molar internal energies and specific heats of
+// the species of the workspace. Returns the heat capacity D = sum_s C_s Cv_s
+// and sets its derivative dDdT and that of E = sum_s U_s wdot_s with respect to
+// the temperature at constant rates, dEdT.
+double temperatureRate(
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work, double const * y, double const T, double * f,
+  double & dDdT, double & dEdT
+) {
+  int const Ns = kinetics.nSpecies;
+  double const Runiv = kinetics.Runiv;
+  double const rT = 1.0/T;
+  double const lnT = std::log(T);
+
+  // Molar internal energies and specific heats of the species from the NASA9
+  // polynomials, which are per unit mass in the table.
+  double * U = &work.U[0];
+  double * Cv = &work.Cv[0];
+  double D = 0.0, E = 0.0;
+  dDdT = 0.0;
+  dEdT = 0.0;
+  for(int s = 0; s < Ns; ++s) {
+    int const k = T < thermo.tMid[s] ? 0 : 1;
+    double const * c = &thermo.coefficients[(2*s+k)*FLAME_NASA9_NCOEFF];
+    double const W = kinetics.W[s];
+
+    double const cp =
+      (c[0]*rT+c[1])*rT+c[2]+T*(c[3]+T*(c[4]+T*(c[5]+T*c[6])));
+    double const dcp =
+      (-2.0*c[0]*rT-c[1])*rT*rT+c[3]+T*(2.0*c[4]+T*(3.0*c[5]+T*4.0*c[6]));
+    double const h =
+      c[7]*rT+c[8]*lnT+c[14]+T*(c[9]+T*(c[10]+T*(c[11]+T*(c[12]+T*c[13]))));
+
+    U[s] = W*h-Runiv*T;
+    Cv[s] = W*cp-Runiv;
+    D += y[s]*Cv[s];
+    dDdT += y[s]*W*dcp;
+    E += U[s]*f[s];
+    dEdT += Cv[s]*f[s];
+  }
+
+  f[Ns] = -E/D;
+  return D;
+}
+
+} // end: namespace
+
+void chemistryRightHandSide(
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work, double const * y, double * f, double * J
+) {
+  int const Ns = kinetics.nSpecies;
+  int const n = Ns+1;
+  double const T = std::min(std::max(y[Ns], thermo.tMin), thermo.tMax);
+
+  kineticsMolarRates(kinetics, y, T, f, J, n);
+
+  double dDdT, dEdT;
+  double const D = temperatureRate(kinetics, thermo, work, y, T, f, dDdT, dEdT);
+  double const fT = f[Ns];
+
+  if(J == nullptr) {
+    return;
+  }
+
+  // Row of the temperature: d(-E/D)/dy = -(dE/dy+fT*dD/dy)/D.
+  double const * U = &work.U[0];
+  double const * Cv = &work.Cv[0];
+  double * JT = J+Ns*n;
+  for(int k = 0; k <= Ns; ++k) {
+    JT[k] = 0.0;
+  }
+  for(int s = 0; s < Ns; ++s) {
+    double const Us = U[s];
+    double const * Js = J+s*n;
+    for(int k = 0; k <= Ns; ++k) {
+      JT[k] += Us*Js[k];
+    }
+  }
+  double const rD = 1.0/D;
+  for(int k = 0; k < Ns; ++k) {
+    JT[k] = -(JT[k]+fT*Cv[k])*rD;
+  }
+  JT[Ns] = -(JT[Ns]+dEdT+fT*dDdT)*rD;
+}
+
+void chemistryRightHandSideSparse(
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  SparseLU const & lu, ChemistryWorkspace & work,
+  double const * y, double * f, double * J
+) {
+  int const Ns = kinetics.nSpecies;
+  int const n = Ns+1;
+  double const T = std::min(std::max(y[Ns], thermo.tMin), thermo.tMax);
+  int const * position = &lu.position[0];
+
+  kineticsMolarRatesSparse(kinetics, y, T, f, J, position, lu.nonzeros);
+
+  double dDdT, dEdT;
+  double const D = temperatureRate(kinetics, thermo, work, y, T, f, dDdT, dEdT);
+  double const fT = f[Ns];
+
+  if(J == nullptr) {
+    return;
+  }
+
+  // Row of the temperature as in chemistryRightHandSide, from the entries of
+  // the rows of the species. The row is dense in the pattern and was set to 0.
+  double const * U = &work.U[0];
+  double const * Cv = &work.Cv[0];
+  int const * positionT = position+Ns*n;
+  int const * index = &lu.denseIndex[0];
+  for(int p = 0; p < lu.nonzeros; ++p) {
+    int const s = index[p]/n;
+    if(s < Ns) {
+      J[positionT[index[p]-s*n]] += U[s]*J[p];
+    }
+  }
+  double const rD = 1.0/D;
+  for(int k = 0; k < Ns; ++k) {
+    double & JTk = J[positionT[k]];
+    JTk = -(JTk+fT*Cv[k])*rD;
+  }
+  double & JTT = J[positionT[Ns]];
+  JTT = -(JTT+dEdT+fT*dDdT)*rD;
+}
+
+int integrateChemistry(
+  ChemistryIntegrator const & integrator,
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work,
+  double const rho, double const dt, double * Y, double & T, double * S
+) {
+  int const Ns = kinetics.nSpecies;
+  int const n = work.n;
+  double const rtol = integrator.relativeTolerance;
+
+  // ROS3 of Sandu et al. (1997), an L-stable third-order method with an
+  // embedded second-order solution:
+  //   (I/(gamma*h)-J) k1 = f(y),
+  //   (I/(gamma*h)-J) k2 = f(y+k1)+c21/h*k1,
+  //   (I/(gamma*h)-J) k3 = f(y+k1)+(c31*k1+c32*k2)/h,
+  //   y' = y+m1*k1+m2*k2+m3*k3,
+  // with the error estimate e1*k1+e2*k2+e3*k3. The third stage takes the
+  // right-hand side of the second.
+  double const gamma = 0.43586652150845899941601945119356;
+  double const c21 = -1.0156171083877702091975600115545;
+  double const c31 = 4.0759956452537699824805835358067;
+  double const c32 = 9.2076794298330791242156818474003;
+  double const m1 = 1.0;
+  double const m2 = 6.1697947043828245592553615689730;
+  double const m3 = -0.42772256543218573326238373806514;
+  double const e1 = 0.5;
+  double const e2 = -2.9079558716805469821718236208017;
+  double const e3 = 0.22354069897811569627360909276199;
+
+  double * y = &work.y[0];
+  double * y1 = &work.y1[0];
+  double * f = &work.f[0];
+  double * k1 = &work.k1[0];
+  double * k2 = &work.k2[0];
+  double * k3 = &work.k3[0];
+  SparseLU const * sparse = integrator.sparseLU.get();
+  if(sparse != nullptr) {
+    work.sparseJ.resize(sparse->nonzeros);
+    work.values.resize(sparse->nonzeros);
+    work.solveWork.resize(n);
+  }
+
+  for(int s = 0; s < Ns; ++s) {
+    y[s] = rho*Y[s]/kinetics.W[s];
+  }
+  y[Ns] = T;
+
+  // Error weights: the absolute tolerance of the mass fractions converted to
+  // concentrations, and the relative tolerance.
+  double * atol = &work.atol[0];
+  for(int s = 0; s < Ns; ++s) {
+    atol[s] = integrator.absoluteTolerance*rho/kinetics.W[s];
+  }
+  atol[Ns] = 0.0;
+
+  if(S != nullptr) {
+    for(int i = 0; i < n*n; ++i) {
+      S[i] = 0.0;
+    }
+    for(int i = 0; i < n; ++i) {
+      S[i*n+i] = 1.0;
+    }
+  }
+
+  evaluateJacobian(kinetics, thermo, sparse, work, y, f, S != nullptr);
+
+  // Initial step of Hairer et al., 0.01*|y|/|f| in the weighted norm, so that
+  // the slow initiation of radicals from a state without them is resolved
+  // instead of stepped over.
+  double ny = 0.0, nf = 0.0;
+  for(int i = 0; i < n; ++i) {
+    double const scale = atol[i]+rtol*std::fabs(y[i]);
+    ny += (y[i]/scale)*(y[i]/scale);
+    nf += (f[i]/scale)*(f[i]/scale);
+  }
+  ny = std::sqrt(ny/n);
+  nf = std::sqrt(nf/n);
+
+  double t = 0.0;
+  double h = ny > 1.0e-5 && nf > 1.0e-5 ? std::min(dt, 0.01*ny/nf) : dt;
+  int accepted = 0;
+  bool evaluate = false;
+
+  for(int step = 0; step < integrator.maxSteps; ++step) {
+    bool const last = h >= dt-t;
+    if(last) {
+      h = dt-t;
+    }
+
+    if(evaluate) {
+      evaluateJacobian(kinetics, thermo, sparse, work, y, f, S != nullptr);
+      evaluate = false;
+    }
+
+    double const rh = 1.0/h;
+    if(!factorStepMatrix(work, sparse, rh/gamma)) {
+      h *= 0.5;
+      continue;
+    }
+
+    for(int i = 0; i < n; ++i) {
+      k1[i] = f[i];
+    }
+    solveStepMatrix(work, k1);
+
+    for(int i = 0; i < n; ++i) {
+      y1[i] = y[i]+k1[i];
+    }
+    chemistryRightHandSide(kinetics, thermo, work, y1, k2, nullptr);
+    for(int i = 0; i < n; ++i) {
+      k3[i] = k2[i]+(c31*k1[i])*rh;
+      k2[i] += c21*k1[i]*rh;
+    }
+    solveStepMatrix(work, k2);
+
+    for(int i = 0; i < n; ++i) {
+      k3[i] += c32*k2[i]*rh;
+    }
+    solveStepMatrix(work, k3);
+
+    // Weighted RMS norm of the error estimate.
+    double err = 0.0;
+    for(int i = 0; i < n; ++i) {
+      y1[i] = y[i]+m1*k1[i]+m2*k2[i]+m3*k3[i];
+      double const scale =
+        atol[i]+rtol*std::max(std::fabs(y[i]), std::fabs(y1[i]));
+      double const e = (e1*k1[i]+e2*k2[i]+e3*k3[i])/scale;
+      err += e*e;
+    }
+    err = std::sqrt(err/n);
+
+    double factor;
+    if(err <= 1.0) {
+      t += h;
+      ++accepted;
+      for(int i = 0; i < n; ++i) {
+        y[i] = y1[i];
+      }
+      if(S != nullptr) {
+        accumulateStepSensitivity(
+          work, n, rh, c21, c31, c32, m1, m2, m3, S
+        );
+      }
+      if(last) {
+        for(int s = 0; s < Ns; ++s) {
+          Y[s] = y[s]*kinetics.W[s]/rho;
+        }
+        T = y[Ns];
+        return accepted;
+      }
+      evaluate = true;
+      factor = std::min(6.0, 0.9/std::cbrt(std::max(err, 1.0e-10)));
+    } else if(std::isfinite(err)) {
+      factor = std::max(0.2, 0.9/std::cbrt(err));
+    } else {
+      factor = 0.2;
+    }
+    h *= factor;
+  }
+
+  return -1;
+}
+
+} // end: namespace flame
@@ -0,0 +1,334 @@
+#include <chemistry_load_balance.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace flame {
+
+namespace {
+
+// Message tags of the counts, states and results of the moved reactors.
+int const TAG_COUNT = 7001;
+int const TAG_STATE = 7002;
+int const TAG_RESULT = 7003;
+
+// Advances one reactor and returns its number of steps; cost is set to the
+// time it took.
+int integrateReactor(
+  ChemistryIntegrator const & integrator, KineticsTable const & kinetics,
+  NASA9Table const & thermo, ChemistryWorkspace & work,
+  ChemistryTabulation * table, double const dt,
+  double const rho, double * Y, double & T, double & cost
+) {
+  std::chrono::steady_clock::time_point const start =
+    std::chrono::steady_clock::now();
+  int const steps = table ?
+    tabulatedChemistry(
+      *table, integrator, kinetics, thermo, work, rho, dt, Y, T
+    ) :
+    integrateChemistry(integrator, kinetics, thermo, work, rho, dt, Y, T);
+  cost = std::chrono::duration<double>(
+    std::chrono::steady_clock::now()-start
+  ).count();
+  return steps;
+}
+
+// Ranks sorted by decreasing amount, ties by rank, of those with a positive
+// amount.
+std::vector<int> sortedRanks(std::vector<double> const & amount) {
+  std::vector<int> ranks;
+  for(int p = 0; p < int(amount.size()); ++p) {
+    if(amount[p] > 0.0) {
+      ranks.push_back(p);
+    }
+  }
+  std::stable_sort(
+    ranks.begin(), ranks.end(),
+    [&amount](int const a, int const b) { return amount[a] > amount[b]; }
+  );
+  return ranks;
+}
+
+} // end: namespace
+
+void clearChemistryReactors(ChemistryReactors & reactors, int const Ns) {
+  reactors.nSpecies = Ns;
+  reactors.density.clear();
+  reactors.temperature.clear();
+  reactors.massFraction.clear();
+  reactors.cost.clear();
+  reactors.steps.clear();
+}
+
+void addChemistryReactor(
+  ChemistryReactors & reactors, double const rho, double const T,
+  double const * Y, double const cost
+) {
+  reactors.density.push_back(rho);
+  reactors.temperature.push_back(T);
+  reactors.massFraction.insert(
+    reactors.massFraction.end(), Y, Y+reactors.nSpecies
+  );
+  reactors.cost.push_back(cost);
+  reactors.steps.push_back(0);
+}
+
+void initChemistryLoadBalance(
+  ChemistryLoadBalance & balance, bool const enabled, double const imbalance
+) {
+  balance.enabled = enabled;
+  balance.imbalance = imbalance;
+  resetChemistryLoadBalanceStatistics(balance);
+}
+
+void resetChemistryLoadBalanceStatistics(ChemistryLoadBalance & balance) {
+  balance.statistics.cost = 0.0;
+  balance.statistics.sent = 0;
+  balance.statistics.received = 0;
+}
+
+void chemistryTransferPlan(
+  std::vector<double> const & loads, double const imbalance,
+  std::vector<ChemistryTransfer> & transfers
+) {
+  transfers.clear();
+
+  int const P = loads.size();
+  if(P < 2) {
+    return;
+  }
+
+  double const mean = std::accumulate(loads.begin(), loads.end(), 0.0)/P;
+  double const maxLoad = *std::max_element(loads.begin(), loads.end());
+  if(!(mean > 0.0) || maxLoad <= (1.0+imbalance)*mean) {
+    return;
+  }
+
+  std::vector<double> excess(P), deficit(P);
+  for(int p = 0; p < P; ++p) {
+    excess[p] = std::max(loads[p]-mean, 0.0);
+    deficit[p] = std::max(mean-loads[p], 0.0);
+  }
+
+  std::vector<int> const donors = sortedRanks(excess);
+  std::vector<int> const receivers = sortedRanks(deficit);
+
+  std::size_t d = 0, r = 0;
+  while(d < donors.size() && r < receivers.size()) {
+    int const from = donors[d];
+    int const to = receivers[r];
+    double const cost = std::min(excess[from], deficit[to]);
+    transfers.push_back(ChemistryTransfer{from, to, cost});
+
+    excess[from] -= cost;
+    deficit[to] -= cost;
+    if(excess[from] <= 0.0) {
+      ++d;
+    }
+    if(deficit[to] <= 0.0) {
+      ++r;
+    }
+  }
+}
+
+void integrateChemistryReactors(
+  ChemistryReactors & reactors, ChemistryIntegrator const & integrator,
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work, ChemistryTabulation * table, double const dt,
+  ChemistryLoadBalance * balance, MPI_Comm comm
+) {
+  int const Ns = reactors.nSpecies;
+  int const n = reactors.density.size();
+
+  // Reactors that stay on this process.
+  std::vector<char> moved(n, 0);
+
+  // Transfers from and to this process, and the reactors that are sent.
+  std::vector<ChemistryTransfer> sends, recvs;
+  std::vector<std::vector<int> > sent;
+
+  if(balance && balance->enabled) {
+    int P, me;
+    MPI_Comm_size(comm, &P);
+    MPI_Comm_rank(comm, &me);
+
+    double const load = std::accumulate(
+      reactors.cost.begin(), reactors.cost.end(), 0.0
+    );
+    std::vector<double> loads(P);
+    MPI_Allgather(&load, 1, MPI_DOUBLE, &loads[0], 1, MPI_DOUBLE, comm);
+
+    std::vector<ChemistryTransfer> transfers;
+    chemistryTransferPlan(loads, balance->imbalance, transfers);
+    for(std::size_t t = 0; t < transfers.size(); ++t) {
+      if(transfers[t].from == me) {
+        sends.push_back(transfers[t]);
+      } else if(transfers[t].to == me) {
+        recvs.push_back(transfers[t]);
+      }
+    }
+
+    // The costliest reactors are sent first; a reactor is sent if that
+    // brings the cost sent closer to that of the transfer.
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+      order.begin(), order.end(),
+      [&reactors](int const a, int const b) {
+        return reactors.cost[a] > reactors.cost[b];
+      }
+    );
+    sent.resize(sends.size());
+    for(std::size_t t = 0; t < sends.size(); ++t) {
+      double remaining = sends[t].cost;
+      for(int k = 0; k < n && remaining > 0.0; ++k) {
+        int const i = order[k];
+        double const c = reactors.cost[i];
+        if(!moved[i] && c > 0.0 && c < 2.0*remaining) {
+          moved[i] = 1;
+          sent[t].push_back(i);
+          remaining -= c;
+        }
+      }
+    }
+  }
+
+  int const nSends = sends.size();
+  int const nRecvs = recvs.size();
+  int const stateSize = Ns+2;
+  int const resultSize = Ns+3;
+
+  // Counts of the moved reactors.
+  std::vector<int> sendCounts(nSends), recvCounts(nRecvs);
+  std::vector<MPI_Request> requests;
+  for(int t = 0; t < nRecvs; ++t) {
+    requests.push_back(MPI_Request());
+    MPI_Irecv(
+      &recvCounts[t], 1, MPI_INT, recvs[t].from, TAG_COUNT, comm,
+      &requests.back()
+    );
+  }
+  for(int t = 0; t < nSends; ++t) {
+    sendCounts[t] = sent[t].size();
+    requests.push_back(MPI_Request());
+    MPI_Isend(
+      &sendCounts[t], 1, MPI_INT, sends[t].to, TAG_COUNT, comm,
+      &requests.back()
+    );
+  }
+  if(!requests.empty()) {
+    MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+  }
+  requests.clear();
+
+  // States of the moved reactors: density, temperature and mass fractions.
+  std::vector<std::vector<double> > sendStates(nSends), recvStates(nRecvs);
+  std::vector<MPI_Request> stateRequests;
+  for(int t = 0; t < nRecvs; ++t) {
+    recvStates[t].resize(recvCounts[t]*stateSize);
+    stateRequests.push_back(MPI_Request());
+    MPI_Irecv(
+      recvStates[t].data(), recvStates[t].size(), MPI_DOUBLE, recvs[t].from,
+      TAG_STATE, comm, &stateRequests.back()
+    );
+  }
+  for(int t = 0; t < nSends; ++t) {
+    std::vector<double> & buf = sendStates[t];
+    buf.resize(sendCounts[t]*stateSize);
+    for(int k = 0; k < sendCounts[t]; ++k) {
+      int const i = sent[t][k];
+      double * s = &buf[k*stateSize];
+      s[0] = reactors.density[i];
+      s[1] = reactors.temperature[i];
+      std::copy(
+        &reactors.massFraction[i*Ns], &reactors.massFraction[i*Ns]+Ns, s+2
+      );
+    }
+    requests.push_back(MPI_Request());
+    MPI_Isend(
+      buf.data(), buf.size(), MPI_DOUBLE, sends[t].to, TAG_STATE, comm,
+      &requests.back()
+    );
+  }
+
+  // Results of the sent reactors: steps, cost, temperature and mass fractions.
+  std::vector<std::vector<double> > sendResults(nSends), recvResults(nRecvs);
+  for(int t = 0; t < nSends; ++t) {
+    sendResults[t].resize(sendCounts[t]*resultSize);
+    requests.push_back(MPI_Request());
+    MPI_Irecv(
+      sendResults[t].data(), sendResults[t].size(), MPI_DOUBLE, sends[t].to,
+      TAG_RESULT, comm, &requests.back()
+    );
+  }
+
+  // The received reactors are integrated first, so that their results are
+  // back while the sending process integrates its own.
+  if(!stateRequests.empty()) {
+    MPI_Waitall(
+      stateRequests.size(), &stateRequests[0], MPI_STATUSES_IGNORE
+    );
+  }
+  double cost = 0.0;
+  long received = 0;
+  for(int t = 0; t < nRecvs; ++t) {
+    std::vector<double> & buf = recvResults[t];
+    buf.resize(recvCounts[t]*resultSize);
+    for(int k = 0; k < recvCounts[t]; ++k) {
+      double const * s = &recvStates[t][k*stateSize];
+      double * r = &buf[k*resultSize];
+      double T = s[1];
+      std::copy(s+2, s+2+Ns, r+3);
+      double c;
+      r[0] = integrateReactor(
+        integrator, kinetics, thermo, work, table, dt, s[0], r+3, T, c
+      );
+      r[1] = c;
+      r[2] = T;
+      cost += c;
+    }
+    received += recvCounts[t];
+    requests.push_back(MPI_Request());
+    MPI_Isend(
+      buf.data(), buf.size(), MPI_DOUBLE, recvs[t].from, TAG_RESULT, comm,
+      &requests.back()
+    );
+  }
+
+  for(int i = 0; i < n; ++i) {
+    if(!moved[i]) {
+      reactors.steps[i] = integrateReactor(
+        integrator, kinetics, thermo, work, table, dt, reactors.density[i],
+        &reactors.massFraction[i*Ns], reactors.temperature[i],
+        reactors.cost[i]
+      );
+      cost += reactors.cost[i];
+    }
+  }
+
+  if(!requests.empty()) {
+    MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+  }
+
+  long nSent = 0;
+  for(int t = 0; t < nSends; ++t) {
+    for(int k = 0; k < sendCounts[t]; ++k) {
+      int const i = sent[t][k];
+      double const * r = &sendResults[t][k*resultSize];
+      reactors.steps[i] = int(r[0]);
+      reactors.cost[i] = r[1];
+      reactors.temperature[i] = r[2];
+      std::copy(r+3, r+3+Ns, &reactors.massFraction[i*Ns]);
+    }
+    nSent += sendCounts[t];
+  }
+
+  if(balance) {
+    balance->statistics.cost += cost;
+    balance->statistics.sent += nSent;
+    balance->statistics.received += received;
+  }
+}
+
+} // end: namespace flame
@@ -0,0 +1,454 @@
+#include <chemistry_tabulation.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace flame {
+
+namespace {
+
+double const TSCALE = FLAME_CHEMISTRY_TABULATION_TEMPERATURE_SCALE;
+
+// Moves record r to the front of the least recently used list. If r is not in
+// the list it is inserted.
+void lruTouch(ChemistryTabulation & table, int const r, bool const listed) {
+  if(listed) {
+    if(table.lruHead == r) {
+      return;
+    }
+    int const prev = table.lruPrev[r];
+    int const next = table.lruNext[r];
+    table.lruNext[prev] = next;
+    if(next >= 0) {
+      table.lruPrev[next] = prev;
+    } else {
+      table.lruTail = prev;
+    }
+  }
+
+  table.lruPrev[r] = -1;
+  table.lruNext[r] = table.lruHead;
+  if(table.lruHead >= 0) {
+    table.lruPrev[table.lruHead] = r;
+  } else {
+    table.lruTail = r;
+  }
+  table.lruHead = r;
+}
+
+// Leaf of the binary tree whose side of every cutting plane phi is on.
+int searchTree(ChemistryTabulation const & table, double const * phi) {
+  int const m = table.nQuery;
+  int c = table.root;
+  while(c >= 0) {
+    double const * v = &table.normal[c*m];
+    double vphi = 0.0;
+    for(int i = 0; i < m; ++i) {
+      vphi += v[i]*phi[i];
+    }
+    c = vphi < table.offset[c] ? table.left[c] : table.right[c];
+  }
+  return -c-1;
+}
+
+// Sets dphi = phi-phi_r and returns dphi^T G_r dphi, with G_r dphi in Gdphi.
+double ellipsoidDistance(
+  ChemistryTabulation & table, int const r, double const * phi
+) {
+  int const m = table.nQuery;
+  double const * phir = &table.query[r*m];
+  double const * G = &table.ellipsoid[r*m*m];
+  double * dphi = &table.dphi[0];
+  double * Gdphi = &table.Gdphi[0];
+
+  for(int i = 0; i < m; ++i) {
+    dphi[i] = phi[i]-phir[i];
+  }
+  double d = 0.0;
+  for(int i = 0; i < m; ++i) {
+    double const * Gi = G+i*m;
+    double sum = 0.0;
+    for(int j = 0; j < m; ++j) {
+      sum += Gi[j]*dphi[j];
+    }
+    Gdphi[i] = sum;
+    d += dphi[i]*sum;
+  }
+  return d;
+}
+
+// Linear approximation psi_r+A_r dphi of record r with dphi of the last call
+// of ellipsoidDistance.
+void linearApproximation(
+  ChemistryTabulation const & table, int const r, double * psi
+) {
+  int const m = table.nQuery;
+  int const l = table.nResult;
+  double const * A = &table.gradient[r*l*m];
+  double const * psir = &table.result[r*l];
+  double const * dphi = &table.dphi[0];
+
+  for(int i = 0; i < l; ++i) {
+    double const * Ai = A+i*m;
+    double sum = psir[i];
+    for(int j = 0; j < m; ++j) {
+      sum += Ai[j]*dphi[j];
+    }
+    psi[i] = sum;
+  }
+}
+
+// Removes record r from the tree and the least recently used list. Its parent
+// node is replaced by its sibling.
+void removeRecord(ChemistryTabulation & table, int const r) {
+  int const p = table.leafParent[r];
+  if(p < 0) {
+    table.root = -1;
+  } else {
+    int const sibling = table.left[p] == -r-1 ? table.right[p] : table.left[p];
+    int const g = table.nodeParent[p];
+    if(g < 0) {
+      table.root = sibling;
+    } else if(table.left[g] == p) {
+      table.left[g] = sibling;
+    } else {
+      table.right[g] = sibling;
+    }
+    if(sibling >= 0) {
+      table.nodeParent[sibling] = g;
+    } else {
+      table.leafParent[-sibling-1] = g;
+    }
+    table.freeNodes.push_back(p);
+  }
+
+  int const prev = table.lruPrev[r];
+  int const next = table.lruNext[r];
+  if(prev >= 0) {
+    table.lruNext[prev] = next;
+  } else {
+    table.lruHead = next;
+  }
+  if(next >= 0) {
+    table.lruPrev[next] = prev;
+  } else {
+    table.lruTail = prev;
+  }
+
+  table.freeRecords.push_back(r);
+  --table.nRecords;
+}
+
+// Index of an unused record or node, taken from the free list or appended.
+int allocateRecord(ChemistryTabulation & table) {
+  if(!table.freeRecords.empty()) {
+    int const r = table.freeRecords.back();
+    table.freeRecords.pop_back();
+    return r;
+  }
+
+  int const m = table.nQuery;
+  int const l = table.nResult;
+  int const r = table.leafParent.size();
+  table.query.resize((r+1)*m);
+  table.result.resize((r+1)*l);
+  table.gradient.resize((r+1)*l*m);
+  table.ellipsoid.resize((r+1)*m*m);
+  table.leafParent.resize(r+1);
+  table.lruPrev.resize(r+1);
+  table.lruNext.resize(r+1);
+  return r;
+}
+
+int allocateNode(ChemistryTabulation & table) {
+  if(!table.freeNodes.empty()) {
+    int const c = table.freeNodes.back();
+    table.freeNodes.pop_back();
+    return c;
+  }
+
+  int const c = table.offset.size();
+  table.normal.resize((c+1)*table.nQuery);
+  table.offset.resize(c+1);
+  table.left.resize(c+1);
+  table.right.resize(c+1);
+  table.nodeParent.resize(c+1);
+  return c;
+}
+
+// Adds a record for query phi with result psi and gradient from the
+// sensitivity S = dy(dt)/dy(0) of the reactor state y = (C, T) with initial
+// concentrations C0 and from the right-hand side f = dy/dt at the end of the
+// step. Leaf is the record found in the tree for phi, or -1 if the table is
+// empty; it is split by the plane halfway between the two queries.
+void addRecord(
+  ChemistryTabulation & table, int const leaf, double const rho,
+  double const dt, double const * W, double const * C0
+) {
+  int const Ns = table.nSpecies;
+  int const m = table.nQuery;
+  int const l = table.nResult;
+  int const n = Ns+1;
+  double const * phi = &table.phi[0];
+  double const * psi = &table.psi[0];
+  double const * S = &table.S[0];
+  double const * f = &table.f[0];
+
+  int const r = allocateRecord(table);
+  double * phir = &table.query[r*m];
+  double * psir = &table.result[r*l];
+  double * A = &table.gradient[r*l*m];
+  double * G = &table.ellipsoid[r*m*m];
+
+  for(int i = 0; i < m; ++i) {
+    phir[i] = phi[i];
+  }
+  for(int i = 0; i < l; ++i) {
+    psir[i] = psi[i];
+  }
+
+  // Chain rule from y = (C, T) to phi and psi: C_s = rho*Y_s/W_s, so that
+  // dC_s/dY_s = rho/W_s and dC_s/dln(rho) = C_s, and Y'_s = C'_s*W_s/rho,
+  // which also depends on ln(rho) directly. The derivative with respect to
+  // ln(dt) is dt*f.
+  for(int s = 0; s < Ns; ++s) {
+    double const * Ss = S+s*n;
+    double * As = A+s*m;
+    double const ds = W[s]/rho;
+    double dlnrho = 0.0;
+    for(int k = 0; k < Ns; ++k) {
+      As[k] = Ss[k]*W[s]/W[k];
+      dlnrho += Ss[k]*C0[k];
+    }
+    As[Ns] = ds*Ss[Ns]*TSCALE;
+    As[Ns+1] = ds*dlnrho-psi[s];
+    As[Ns+2] = ds*dt*f[s];
+  }
+  {
+    double const * ST = S+Ns*n;
+    double * AT = A+Ns*m;
+    double dlnrho = 0.0;
+    for(int k = 0; k < Ns; ++k) {
+      AT[k] = ST[k]*rho/W[k]/TSCALE;
+      dlnrho += ST[k]*C0[k];
+    }
+    AT[Ns] = ST[Ns];
+    AT[Ns+1] = dlnrho/TSCALE;
+    AT[Ns+2] = dt*f[Ns]/TSCALE;
+  }
+
+  // Initial ellipsoid of accuracy |A dphi| <= tolerance, bounded by a radius
+  // of twice the tolerance in the directions in which A is small:
+  // G = (A^T A + I/4)/tolerance^2.
+  double const rtol2 = 1.0/(table.tolerance*table.tolerance);
+  for(int i = 0; i < m; ++i) {
+    for(int j = i; j < m; ++j) {
+      double sum = i == j ? 0.25 : 0.0;
+      for(int k = 0; k < l; ++k) {
+        sum += A[k*m+i]*A[k*m+j];
+      }
+      G[i*m+j] = sum*rtol2;
+      G[j*m+i] = sum*rtol2;
+    }
+  }
+
+  if(leaf < 0) {
+    table.root = -r-1;
+    table.leafParent[r] = -1;
+  } else {
+    int const c = allocateNode(table);
+    double const * phil = &table.query[leaf*m];
+    double * v = &table.normal[c*m];
+    double a = 0.0;
+    for(int i = 0; i < m; ++i) {
+      v[i] = phi[i]-phil[i];
+      a += v[i]*0.5*(phi[i]+phil[i]);
+    }
+    table.offset[c] = a;
+    table.left[c] = -leaf-1;
+    table.right[c] = -r-1;
+
+    int const p = table.leafParent[leaf];
+    table.nodeParent[c] = p;
+    if(p < 0) {
+      table.root = c;
+    } else if(table.left[p] == -leaf-1) {
+      table.left[p] = c;
+    } else {
+      table.right[p] = c;
+    }
+    table.leafParent[leaf] = c;
+    table.leafParent[r] = c;
+  }
+
+  lruTouch(table, r, false);
+  ++table.nRecords;
+}
+
+} // end: namespace
+
+void initChemistryTabulation(
+  ChemistryTabulation & table, int const Ns, double const tolerance,
+  double const memory
+) {
+  int const m = Ns+3;
+  int const l = Ns+1;
+
+  table.nSpecies = Ns;
+  table.nQuery = m;
+  table.nResult = l;
+  table.tolerance = tolerance;
+
+  // A record and the tree node above it.
+  double const bytes =
+    sizeof(double)*(m+l+l*m+m*m) + 3*sizeof(int) +
+    sizeof(double)*(m+1) + 3*sizeof(int);
+  table.maxRecords = std::max(1.0, std::floor(memory/bytes));
+
+  table.phi.resize(m);
+  table.psi.resize(l);
+  table.dphi.resize(m);
+  table.Gdphi.resize(m);
+  table.S.resize(l*l);
+  table.y.resize(l);
+  table.f.resize(l);
+  table.C0.resize(Ns);
+
+  clearChemistryTabulation(table);
+  resetChemistryTabulationStatistics(table);
+}
+
+void clearChemistryTabulation(ChemistryTabulation & table) {
+  table.nRecords = 0;
+  table.query.clear();
+  table.result.clear();
+  table.gradient.clear();
+  table.ellipsoid.clear();
+  table.leafParent.clear();
+  table.lruPrev.clear();
+  table.lruNext.clear();
+  table.lruHead = -1;
+  table.lruTail = -1;
+  table.freeRecords.clear();
+  table.root = -1;
+  table.normal.clear();
+  table.offset.clear();
+  table.left.clear();
+  table.right.clear();
+  table.nodeParent.clear();
+  table.freeNodes.clear();
+}
+
+void resetChemistryTabulationStatistics(ChemistryTabulation & table) {
+  table.statistics.retrieves = 0;
+  table.statistics.grows = 0;
+  table.statistics.adds = 0;
+  table.statistics.evictions = 0;
+}
+
+int tabulatedChemistry(
+  ChemistryTabulation & table, ChemistryIntegrator const & integrator,
+  KineticsTable const & kinetics, NASA9Table const & thermo,
+  ChemistryWorkspace & work,
+  double const rho, double const dt, double * Y, double & T
+) {
+  int const Ns = table.nSpecies;
+  int const m = table.nQuery;
+  double * phi = &table.phi[0];
+  double * psi = &table.psi[0];
+
+  for(int s = 0; s < Ns; ++s) {
+    phi[s] = Y[s];
+  }
+  phi[Ns] = T/TSCALE;
+  phi[Ns+1] = std::log(rho);
+  phi[Ns+2] = std::log(dt);
+
+  // Retrieve from the record of the tree or from one of the most recently
+  // used records.
+  int const leaf = table.nRecords == 0 ? -1 : searchTree(table, phi);
+  int covering = -1;
+  if(leaf >= 0 && ellipsoidDistance(table, leaf, phi) <= 1.0) {
+    covering = leaf;
+  }
+  int r = table.lruHead;
+  for(int i = 0; covering < 0 && r >= 0 &&
+    i < FLAME_CHEMISTRY_TABULATION_MRU_SEARCH; ++i, r = table.lruNext[r]) {
+    if(r != leaf && ellipsoidDistance(table, r, phi) <= 1.0) {
+      covering = r;
+    }
+  }
+
+  if(covering >= 0) {
+    linearApproximation(table, covering, psi);
+    for(int s = 0; s < Ns; ++s) {
+      Y[s] = psi[s];
+    }
+    T = psi[Ns]*TSCALE;
+    lruTouch(table, covering, true);
+    ++table.statistics.retrieves;
+    return 0;
+  }
+
+  // Integrate with the sensitivity, which a new record needs, and grow the
+  // ellipsoid of the record of the tree instead if its linear approximation
+  // is within the tolerance.
+  double * C0 = &table.C0[0];
+  for(int s = 0; s < Ns; ++s) {
+    C0[s] = rho*Y[s]/kinetics.W[s];
+  }
+  int const steps = integrateChemistry(
+    integrator, kinetics, thermo, work, rho, dt, Y, T, &table.S[0]
+  );
+  if(steps < 0) {
+    return steps;
+  }
+
+  if(leaf >= 0) {
+    double const d = ellipsoidDistance(table, leaf, phi);
+    linearApproximation(table, leaf, psi);
+    double err = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      err += (psi[s]-Y[s])*(psi[s]-Y[s]);
+    }
+    err += (psi[Ns]-T/TSCALE)*(psi[Ns]-T/TSCALE);
+
+    if(err <= table.tolerance*table.tolerance) {
+      // Smallest ellipsoid that contains the old one and phi: the axis along
+      // G dphi is stretched to reach phi.
+      double * G = &table.ellipsoid[leaf*m*m];
+      double const * Gdphi = &table.Gdphi[0];
+      double const factor = (1.0-1.0/d)/d;
+      for(int i = 0; i < m; ++i) {
+        for(int j = 0; j < m; ++j) {
+          G[i*m+j] -= factor*Gdphi[i]*Gdphi[j];
+        }
+      }
+      lruTouch(table, leaf, true);
+      ++table.statistics.grows;
+      return steps;
+    }
+  }
+
+  // Add a record, evicting the least recently used record if the table is
+  // full.
+  double * y = &table.y[0];
+  for(int s = 0; s < Ns; ++s) {
+    psi[s] = Y[s];
+    y[s] = rho*Y[s]/kinetics.W[s];
+  }
+  psi[Ns] = T/TSCALE;
+  y[Ns] = T;
+  chemistryRightHandSide(kinetics, thermo, work, y, &table.f[0], nullptr);
+
+  if(table.nRecords >= table.maxRecords) {
+    removeRecord(table, table.lruTail);
+    ++table.statistics.evictions;
+  }
+  int const split = table.nRecords == 0 ? -1 : searchTree(table, phi);
+  addRecord(table, split, rho, dt, &kinetics.W[0], C0);
+  ++table.statistics.adds;
+  return steps;
+}
+
+} // end: namespace flame
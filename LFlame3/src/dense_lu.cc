@@ -0,0 +1,33 @@
+#include <dense_lu.hh>
+
+namespace flame {
+
+namespace {
+
+// Returns the specialization for order n if n is in the range [N,
+// FLAME_DENSE_LU_MAX_SPECIALIZED_N], and the general functions otherwise.
+template<int N>
+DenseLU selectDenseLUN(int const n) {
+  if constexpr(N > FLAME_DENSE_LU_MAX_SPECIALIZED_N) {
+    DenseLU lu;
+    lu.factor = &denseLUFactor;
+    lu.solve = &denseLUSolve;
+    return lu;
+  } else {
+    if(n == N) {
+      DenseLU lu;
+      lu.factor = &denseLUFactorN<N>;
+      lu.solve = &denseLUSolveN<N>;
+      return lu;
+    }
+    return selectDenseLUN<N+1>(n);
+  }
+}
+
+} // end: namespace
+
+DenseLU selectDenseLU(int const n) {
+  return selectDenseLUN<FLAME_DENSE_LU_MIN_SPECIALIZED_N>(n);
+}
+
+} // end: namespace flame
@@ -0,0 +1,153 @@
+#include <face_coloring.hh>
+#include <grid_post_processor.hh>
+
+#include <algorithm>
+#include <cstdint>
+
+#define GLOG_USE_GLOG_EXPORT
+#include <glog/logging.h>
+
+namespace flame {
+
+int colorInternalFaces(
+  Loci::Map const & cl, Loci::Map const & cr,
+  Loci::entitySet const & faces, Loci::entitySet const & cells,
+  Loci::store<int> & faceColor
+) {
+  faceColor.allocate(faces);
+  
+  if(faces == EMPTY) {
+    return 0;
+  }
+  
+  Loci::Entity const cellMin = cells.Min();
+  int const nCells = cells.Max()-cellMin+1;
+  
+  // A face conflicts with at most the other faces of its two cells, so
+  // 2*maxFaces-1 colors always suffice.
+  std::vector<int> nCellFaces(nCells, 0);
+  for(Loci::entitySet::const_iterator fi = faces.begin(); fi != faces.end(); ++fi) {
+    ++nCellFaces[cl[*fi]-cellMin];
+    ++nCellFaces[cr[*fi]-cellMin];
+  }
+  int const maxFaces = *std::max_element(nCellFaces.begin(), nCellFaces.end());
+  int const nWords = (2*maxFaces-1+63)/64;
+  
+  // Bit mask of colors used by the faces of each cell.
+  std::vector<std::uint64_t> used(std::size_t(nCells)*nWords, 0);
+  
+  int nColors = 0;
+  for(Loci::entitySet::const_iterator fi = faces.begin(); fi != faces.end(); ++fi) {
+    std::uint64_t * usedl = &used[std::size_t(cl[*fi]-cellMin)*nWords];
+    std::uint64_t * usedr = &used[std::size_t(cr[*fi]-cellMin)*nWords];
+    
+    int color = -1;
+    for(int w = 0; w < nWords && color < 0; ++w) {
+      std::uint64_t const avail = ~(usedl[w] | usedr[w]);
+      if(avail != 0) {
+        color = 64*w+__builtin_ctzll(avail);
+      }
+    }
+    
+    usedl[color/64] |= std::uint64_t(1) << (color%64);
+    usedr[color/64] |= std::uint64_t(1) << (color%64);
+    faceColor[*fi] = color;
+    nColors = std::max(nColors, color+1);
+  }
+  
+  return nColors;
+}
+
+void groupFacesByColor(
+  Loci::sequence const & seq, Loci::const_store<int> const & faceColor,
+  int const nColors,
+  std::vector<Loci::Entity> & faces, std::vector<int> & offsets
+) {
+  offsets.assign(nColors+1, 0);
+  for(Loci::sequence::const_iterator fi = seq.begin(); fi != seq.end(); ++fi) {
+    ++offsets[faceColor[*fi]+1];
+  }
+  for(int c = 0; c < nColors; ++c) {
+    offsets[c+1] += offsets[c];
+  }
+  
+  faces.resize(offsets[nColors]);
+  std::vector<int> next(offsets.begin(), offsets.end()-1);
+  for(Loci::sequence::const_iterator fi = seq.begin(); fi != seq.end(); ++fi) {
+    faces[next[faceColor[*fi]]++] = *fi;
+  }
+}
+
+// =============================================================================
+// Grid post processor that colors the internal faces when the residual is
+// assembled by colored scatter. Creates facts faceColor, nFaceColors and
+// faceColorGroups, the faces grouped by color once for all residual rules.
+// Only the faces whose cells are both cells of this process are colored, so
+// colored assembly is limited to a single process.
+// =============================================================================
+
+class FaceColoring : public GridPostProcessor {
+public:
+  virtual void processData(fact_db & facts, rule_db & rdb) const {
+    Loci::storeRepP rap = facts.get_variable("residualAssembly");
+    if(rap == 0 || rap->RepType() != Loci::PARAMETER) {
+      return;
+    }
+    
+    param<std::string> residualAssembly;
+    residualAssembly.setRep(rap);
+    if(*residualAssembly != "colored") {
+      return;
+    }
+    
+    // In a partitioned grid the faces on the partition boundaries have a cell
+    // of another process, which the coloring does not see.
+    if(Loci::MPI_processes > 1) {
+      if(Loci::MPI_rank == 0) {
+        LOG(ERROR) << "residualAssembly colored requires a single process, "
+          << "use gather with multiple processes";
+      }
+      Loci::Abort();
+    }
+    
+    Map cl, cr;
+    cl = facts.get_variable("cl");
+    cr = facts.get_variable("cr");
+    
+    constraint geom_cells;
+    geom_cells = facts.get_variable("geom_cells");
+    Loci::entitySet const cells = *geom_cells;
+    
+    Loci::entitySet faces;
+    Loci::entitySet const crdom = cr.domain();
+    for(Loci::entitySet::const_iterator fi = crdom.begin(); fi != crdom.end(); ++fi) {
+      if(cells.inSet(cl[*fi]) && cells.inSet(cr[*fi])) {
+        faces += *fi;
+      }
+    }
+    
+    store<int> faceColor;
+    int const nLocalColors = colorInternalFaces(cl, cr, faces, cells, faceColor);
+    
+    param<int> nFaceColors;
+    *nFaceColors = Loci::GLOBAL_MAX(nLocalColors);
+    
+    blackbox<FaceColorGroups> faceColorGroups;
+    groupFacesByColor(
+      Loci::sequence(faces), faceColor, *nFaceColors,
+      faceColorGroups->faces, faceColorGroups->offsets
+    );
+    
+    facts.create_fact("faceColor", faceColor);
+    facts.create_fact("nFaceColors", nFaceColors);
+    facts.create_fact("faceColorGroups", faceColorGroups);
+    
+    if(Loci::MPI_rank == 0) {
+      LOG(INFO) << "Colored internal faces using " << *nFaceColors << " colors";
+    }
+  }
+};
+
+registerGridPostProcessor<FaceColoring> registerFaceColoring;
+
+} // end: namespace flame
@@ -1,5 +1,8 @@
 #include <flux.hh>
 
+#include <algorithm>
+#include <cmath>
+
 namespace flame {
 
 void AUSMPlusUpFluxIdealGas(
@@ -142,56 +145,233 @@ void AUSMPlusUpFluxIdealGas(
   }
 }
 
-void AUSMPlusUpFluxMultiSpeciesIdealGas(
-  double * flux,
-  int const Ns,
-  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
-  double const Rtildel, double const Cpl,
-  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
-  double const Rtilder, double const Cpr,
-  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
-  double const Minf
+bool AUSMPlusUpRightSupersonic(
+  double const Unl, double const h0l, double const gammal,
+  double const Unr, double const h0r, double const gammar
 ) {
-  double const Pl = Pgl+Pambient;
-  double const Pr = Pgr+Pambient;
+  // Interface speed of sound as in AUSMPlusUpFluxIdealGas.
+  double const clstar2 = 2.0*(gammal-1.0)/(gammal+1.0)*h0l;
+  double const crstar2 = 2.0*(gammar-1.0)/(gammar+1.0)*h0r;
+  double const clstar = sqrt(clstar2);
+  double const crstar = sqrt(crstar2);
+  double const cltilde = Unl > clstar ? clstar2/Unl : clstar;
+  double const crtilde = (-Unr) > crstar ? crstar2/(-Unr) : crstar;
+  double const chalf = cltilde < crtilde ? cltilde : crtilde;
+  
+  // With both Mach numbers below -1 the split Mach numbers and pressures take
+  // the right state alone, and the pressure and velocity diffusion terms
+  // vanish because the average Mach number exceeds 1.
+  return Unl < -chalf && Unr < -chalf;
+}
+
+namespace {
+
+// Body of the batched kernels. Arithmetic is carried out in type T, the type of
+// the block arrays.
+template<typename T, typename Block>
+void AUSMPlusUpFluxIdealGasBlockT(
+  Block & block, int const n,
+  double const PambientD, double const RtildeD, double const CpD
+) {
+  T const Pambient = T(PambientD);
+  T const Rtilde = T(RtildeD);
+  T const Cp = T(CpD);
+  
+  T const Cv = Cp-Rtilde;
+  T const gamma = Cp/Cv;
+  
+  T const gm1 = gamma-T(1);
+  T const gp1 = gamma+T(1);
+  
+  // some constants
+  T const Kp = T(0.25);
+  T const Ku = T(0.75);
+  T const sigma = T(1);
+  T const beta = T(1)/T(8);
+  
+  T const * const Ulx = block.Ulx;
+  T const * const Uly = block.Uly;
+  T const * const Ulz = block.Ulz;
+  T const * const Pgl = block.Pgl;
+  T const * const Tl = block.Tl;
+  T const * const Urx = block.Urx;
+  T const * const Ury = block.Ury;
+  T const * const Urz = block.Urz;
+  T const * const Pgr = block.Pgr;
+  T const * const Tr = block.Tr;
+  T const * const area_sada = block.area_sada;
+  T const * const area_nx = block.area_nx;
+  T const * const area_ny = block.area_ny;
+  T const * const area_nz = block.area_nz;
+  T const * const Minf = block.Minf;
+  T * const flux0 = block.flux[0];
+  T * const flux1 = block.flux[1];
+  T * const flux2 = block.flux[2];
+  T * const flux3 = block.flux[3];
+  T * const flux4 = block.flux[4];
+  
+  FLAME_SIMD_LOOP
+  for(int i = 0; i < n; ++i) {
+    T const Pl = Pgl[i]+Pambient;
+    T const Pr = Pgr[i]+Pambient;
+    
+    T const rl = Pl/(Rtilde*Tl[i]);
+    T const rr = Pr/(Rtilde*Tr[i]);
+    
+    T const Ulmag2 = Ulx[i]*Ulx[i]+Uly[i]*Uly[i]+Ulz[i]*Ulz[i];
+    T const Urmag2 = Urx[i]*Urx[i]+Ury[i]*Ury[i]+Urz[i]*Urz[i];
+    
+    T const Unl = Ulx[i]*area_nx[i]+Uly[i]*area_ny[i]+Ulz[i]*area_nz[i];
+    T const Unr = Urx[i]*area_nx[i]+Ury[i]*area_ny[i]+Urz[i]*area_nz[i];
+    
+    T const h0l = Cp*Tl[i]+T(0.5)*Ulmag2;
+    T const h0r = Cp*Tr[i]+T(0.5)*Urmag2;
+    
+    T const clstar2 = T(2)*gm1/gp1*h0l;
+    T const crstar2 = T(2)*gm1/gp1*h0r;
+    
+    T const clstar = std::sqrt(clstar2);
+    T const crstar = std::sqrt(crstar2);
+    
+    // Entropy fix, see AUSMPlusUpFluxIdealGas.
+    T const cltilde = clstar2/(Unl > clstar ? Unl : clstar);
+    T const crtilde = crstar2/((-Unr) > crstar ? (-Unr) : crstar);
+    
+    T const chalf = cltilde < crtilde ? cltilde : crtilde;
+    
+    T const Mavg2 = T(0.5)*(Unl*Unl+Unr*Unr)/(chalf*chalf);
+    T const Minf2 = Minf[i]*Minf[i];
+    T const M02 = Mavg2 > T(1) || Minf2 > T(1) ? T(1) : (Mavg2 > Minf2 ? Mavg2 : Minf2);
+    T const M0 = std::sqrt(M02);
+    T const fa = M0*(T(2)-M0);
+    
+    T const alpha = T(3)/T(16)*(T(-4)+T(5)*fa*fa);
+    
+    T const rhalf = T(0.5)*(rl+rr);
+    
+    T const Ml = Unl/chalf;
+    T const Mr = Unr/chalf;
+    
+    // Subsonic polynomials are evaluated for every face and then masked by
+    // the supersonic values where |M| > 1.
+    T const tmpl1 = Ml+T(1), tmpl2 = Ml*Ml-T(1);
+    T const tmpl12 = tmpl1*tmpl1, tmpl22 = tmpl2*tmpl2;
+    bool const lsup = std::fabs(Ml) > T(1);
+    T const Mlp = lsup ? T(0.5)*(Ml+std::fabs(Ml)) : T(0.25)*tmpl12+beta*tmpl22;
+    T const Pp = lsup ? (Ml > T(0) ? T(1) : T(0)) :
+      (T(0.25)*tmpl12*(T(2)-Ml)+alpha*Ml*tmpl22);
+    T const Plp = Pl*Pp;
+    
+    T const tmpr1 = Mr-T(1), tmpr2 = Mr*Mr-T(1);
+    T const tmpr12 = tmpr1*tmpr1, tmpr22 = tmpr2*tmpr2;
+    bool const rsup = std::fabs(Mr) > T(1);
+    T const Mrm = rsup ? T(0.5)*(Mr-std::fabs(Mr)) : T(-0.25)*tmpr12-beta*tmpr22;
+    T const Pm = rsup ? (Mr < T(0) ? T(1) : T(0)) :
+      (T(0.25)*tmpr12*(T(2)+Mr)-alpha*Mr*tmpr22);
+    T const Prm = Pr*Pm;
+    
+    T const Fa = T(1)-sigma*Mavg2;
+    T const Mp = -Kp/fa*(Fa > T(0) ? Fa : T(0))*(Pr-Pl)/(rhalf*chalf*chalf);
+    T const Pu = -Ku*Pp*Pm*(rl+rr)*fa*chalf*(Unr-Unl);
+    
+    T const Mhalf = Mlp+Mrm+Mp;
+    T const Phalf = Plp+Prm+Pu;
+    
+    bool const upl = Mhalf >= T(0);
+    T const ut = Mhalf*chalf;
+    T const mdot = area_sada[i]*(upl ? rl : rr)*ut;
+    T const pg = Phalf-Pambient;
+    
+    flux0[i] = mdot*(upl ? Ulx[i] : Urx[i])+area_sada[i]*pg*area_nx[i];
+    flux1[i] = mdot*(upl ? Uly[i] : Ury[i])+area_sada[i]*pg*area_ny[i];
+    flux2[i] = mdot*(upl ? Ulz[i] : Urz[i])+area_sada[i]*pg*area_nz[i];
+    flux3[i] = mdot*(upl ? h0l : h0r);
+    flux4[i] = mdot;
+  }
+}
+
+} // end: namespace
+
+void AUSMPlusUpFluxIdealGasBlock(
+  IdealGasFaceBlock & block, int const n,
+  double const Pambient, double const Rtilde, double const Cp
+) {
+  AUSMPlusUpFluxIdealGasBlockT<double>(block, n, Pambient, Rtilde, Cp);
+}
+
+void AUSMPlusUpFluxIdealGasBlock(
+  IdealGasFaceBlockSP & block, int const n,
+  double const Pambient, double const Rtilde, double const Cp
+) {
+  AUSMPlusUpFluxIdealGasBlockT<float>(block, n, Pambient, Rtilde, Cp);
+}
+
+namespace {
+
+// Computes the AUSM+up interface mass flux and gage pressure for the
+// multi-species ideal gas. upwindLeft is true if the interface state is taken
+// from the left side. Arithmetic is carried out in type T.
+template<typename T>
+inline
+void AUSMPlusUpInterfaceMultiSpeciesIdealGas(
+  double & mdotD, double & pgD, bool & upwindLeft, double & h0lD, double & h0rD,
+  Loci::vector3d<double> const & UlD, double const PglD, double const TlD,
+  double const RtildelD, double const CplD,
+  Loci::vector3d<double> const & UrD, double const PgrD, double const TrD,
+  double const RtilderD, double const CprD,
+  double const area_sadaD, Loci::vector3d<double> const & area_nD, double const PambientD,
+  double const MinfD
+) {
+  Loci::vector3d<T> const Ul(T(UlD.x), T(UlD.y), T(UlD.z));
+  Loci::vector3d<T> const Ur(T(UrD.x), T(UrD.y), T(UrD.z));
+  Loci::vector3d<T> const area_n(T(area_nD.x), T(area_nD.y), T(area_nD.z));
+  T const Tl = T(TlD), Tr = T(TrD);
+  T const Rtildel = T(RtildelD), Rtilder = T(RtilderD);
+  T const Cpl = T(CplD), Cpr = T(CprD);
+  T const area_sada = T(area_sadaD);
+  T const Pambient = T(PambientD);
+  T const Minf = T(MinfD);
   
-  double const rl = Pl/(Rtildel*Tl);
-  double const rr = Pr/(Rtilder*Tr);
+  T const Pl = T(PglD)+Pambient;
+  T const Pr = T(PgrD)+Pambient;
   
-  double const hl = Cpl*Tl;
-  double const hr = Cpr*Tr;
+  T const rl = Pl/(Rtildel*Tl);
+  T const rr = Pr/(Rtilder*Tr);
   
-  double const Cvl = Cpl-Rtildel;
-  double const Cvr = Cpr-Rtilder;
+  T const hl = Cpl*Tl;
+  T const hr = Cpr*Tr;
   
-  double const gammal = Cpl/Cvl;
-  double const gammar = Cpr/Cvr;
+  T const Cvl = Cpl-Rtildel;
+  T const Cvr = Cpr-Rtilder;
   
-  double const gm1l = gammal-1.0;
-  double const gm1r = gammar-1.0;
+  T const gammal = Cpl/Cvl;
+  T const gammar = Cpr/Cvr;
   
-  double const gp1l = gammal+1.0;
-  double const gp1r = gammar+1.0;
+  T const gm1l = gammal-T(1);
+  T const gm1r = gammar-T(1);
   
-  double const Ulmag2 = dot(Ul, Ul);
-  double const Urmag2 = dot(Ur, Ur);
+  T const gp1l = gammal+T(1);
+  T const gp1r = gammar+T(1);
   
-  double const Unl = dot(Ul, area_n);
-  double const Unr = dot(Ur, area_n);
+  T const Ulmag2 = dot(Ul, Ul);
+  T const Urmag2 = dot(Ur, Ur);
   
-  //double const h0l = Rtildel*Tl*gammal/gm1l+0.5*Ulmag2;
-  //double const h0r = Rtilder*Tr*gammar/gm1r+0.5*Urmag2;
-  double const h0l = hl+0.5*Ulmag2;
-  double const h0r = hr+0.5*Urmag2;
+  T const Unl = dot(Ul, area_n);
+  T const Unr = dot(Ur, area_n);
   
-  //double const e0l = h0l - Rtildel*Tl;
-  //double const e0r = h0r - Rtilder*Tr;
+  //T const h0l = Rtildel*Tl*gammal/gm1l+0.5*Ulmag2;
+  //T const h0r = Rtilder*Tr*gammar/gm1r+0.5*Urmag2;
+  T const h0l = hl+T(0.5)*Ulmag2;
+  T const h0r = hr+T(0.5)*Urmag2;
   
-  double const clstar2 = 2.0*gm1l/gp1l*h0l;
-  double const crstar2 = 2.0*gm1r/gp1r*h0r;
+  //T const e0l = h0l - Rtildel*Tl;
+  //T const e0r = h0r - Rtilder*Tr;
   
-  double const clstar = sqrt(clstar2);
-  double const crstar = sqrt(crstar2);
+  T const clstar2 = T(2)*gm1l/gp1l*h0l;
+  T const crstar2 = T(2)*gm1r/gp1r*h0r;
+  
+  T const clstar = std::sqrt(clstar2);
+  T const crstar = std::sqrt(crstar2);
   
   // This defnition leads to entropy violation.
   // See paper "A sequel to AUSM, Part II", Liou, 2006
@@ -199,78 +379,163 @@ void AUSMPlusUpFluxMultiSpeciesIdealGas(
   //real const crtilde = crstar2/max(fabs(Unr), crstar);
   
   // This definition is the entropy fix, according to the paper.
-  double const cltilde = Unl > clstar ? clstar2/Unl : clstar2/clstar; // clstar2/max(Unl, clstar);
-  double const crtilde = (-Unr) > crstar ? crstar2/(-Unr) : crstar2/crstar; // crstar2/max(-Unr, crstar);
+  T const cltilde = Unl > clstar ? clstar2/Unl : clstar2/clstar; // clstar2/max(Unl, clstar);
+  T const crtilde = (-Unr) > crstar ? crstar2/(-Unr) : crstar2/crstar; // crstar2/max(-Unr, crstar);
   
-  double const chalf = cltilde < crtilde ? cltilde : crtilde; // min(cltilde, crtilde);
+  T const chalf = cltilde < crtilde ? cltilde : crtilde; // min(cltilde, crtilde);
   
-  double const Minf2 = Minf*Minf;
-  double const Mavg2 = 0.5*(Unl*Unl+Unr*Unr)/(chalf*chalf);
-  double const M02 = Mavg2 > 1.0 ? 1.0 : (Minf2 > 1.0 ? 1.0 : Mavg2 > Minf2 ? Mavg2 : Minf2); // min(1.0, max(Mavg2, Minf*Minf));
-  double const M0 = sqrt(M02);
-  double const fa = M0*(2.0-M0);
+  T const Minf2 = Minf*Minf;
+  T const Mavg2 = T(0.5)*(Unl*Unl+Unr*Unr)/(chalf*chalf);
+  T const M02 = Mavg2 > T(1) ? T(1) : (Minf2 > T(1) ? T(1) : Mavg2 > Minf2 ? Mavg2 : Minf2); // min(1.0, max(Mavg2, Minf*Minf));
+  T const M0 = std::sqrt(M02);
+  T const fa = M0*(T(2)-M0);
   
   // some constants
-  double const Kp = 0.25;
-  double const Ku = 0.75;
-  double const sigma = 1.0;
-  double const beta = 1.0/8.0;
-  //double const alpha = 3.0/16.0;
-  double const alpha = 3.0/16.0*(-4.0+5.0*fa*fa);
-  
-  double const rhalf = 0.5*(rl+rr);
-  
-  double const Ml = Unl/chalf;
-  double const Mr = Unr/chalf;
-  
-  double Mlp, Plp;
-  double Pp, Pm;
-  if(Ml < -1.0) {
-    Mlp = 0.0;
-    Pp = 0.0;
-    Plp = 0.0;
-  } else if(Ml <= 1.0) {
-    double const tmp1 = Ml+1.0, tmp2 = Ml*Ml-1.0;
-    double const tmp12 = tmp1*tmp1, tmp22 = tmp2*tmp2;
-    Mlp = 0.25*tmp12+beta*tmp22;
-    Pp = (0.25*tmp12*(2.0-Ml)+alpha*Ml*tmp22);
+  T const Kp = T(0.25);
+  T const Ku = T(0.75);
+  T const sigma = T(1);
+  T const beta = T(1)/T(8);
+  //T const alpha = 3.0/16.0;
+  T const alpha = T(3)/T(16)*(T(-4)+T(5)*fa*fa);
+  
+  T const rhalf = T(0.5)*(rl+rr);
+  
+  T const Ml = Unl/chalf;
+  T const Mr = Unr/chalf;
+  
+  T Mlp, Plp;
+  T Pp, Pm;
+  if(Ml < T(-1)) {
+    Mlp = T(0);
+    Pp = T(0);
+    Plp = T(0);
+  } else if(Ml <= T(1)) {
+    T const tmp1 = Ml+T(1), tmp2 = Ml*Ml-T(1);
+    T const tmp12 = tmp1*tmp1, tmp22 = tmp2*tmp2;
+    Mlp = T(0.25)*tmp12+beta*tmp22;
+    Pp = (T(0.25)*tmp12*(T(2)-Ml)+alpha*Ml*tmp22);
     Plp = Pl*Pp;
   } else {
     Mlp = Ml;
-    Pp = 1.0;
+    Pp = T(1);
     Plp = Pl;
   }
   
-  double Mrm, Prm;
-  if(Mr < -1.0) {
+  T Mrm, Prm;
+  if(Mr < T(-1)) {
     Mrm = Mr;
-    Pm = 1.0;
+    Pm = T(1);
     Prm = Pr;
-  } else if(Mr <= 1.0) {
-    double const tmp1 = Mr-1.0, tmp2 = Mr*Mr-1.0;
-    double const tmp12 = tmp1*tmp1, tmp22 = tmp2*tmp2;
-    Mrm = -0.25*tmp12-beta*tmp22;
-    Pm = (0.25*tmp12*(2.0+Mr)-alpha*Mr*tmp22);
+  } else if(Mr <= T(1)) {
+    T const tmp1 = Mr-T(1), tmp2 = Mr*Mr-T(1);
+    T const tmp12 = tmp1*tmp1, tmp22 = tmp2*tmp2;
+    Mrm = T(-0.25)*tmp12-beta*tmp22;
+    Pm = (T(0.25)*tmp12*(T(2)+Mr)-alpha*Mr*tmp22);
     Prm = Pr*Pm;
   } else {
-    Mrm = 0.0;
-    Pm = 0.0;
-    Prm = 0.0;
+    Mrm = T(0);
+    Pm = T(0);
+    Prm = T(0);
   }
   
   //T const Mp = -Kp/fa*max(1.0-sigma*Mavg2, 0.0)*(Pr-Pl)/(rhalf*chalf*chalf);
-  double const Fa = 1.0-sigma*Mavg2;
-  double const Mp = -Kp/fa*(Fa > 0.0 ? Fa : 0.0)*(Pr-Pl)/(rhalf*chalf*chalf);
-  double const Pu = -Ku*Pp*Pm*(rl+rr)*fa*chalf*(Unr-Unl);
+  T const Fa = T(1)-sigma*Mavg2;
+  T const Mp = -Kp/fa*(Fa > T(0) ? Fa : T(0))*(Pr-Pl)/(rhalf*chalf*chalf);
+  T const Pu = -Ku*Pp*Pm*(rl+rr)*fa*chalf*(Unr-Unl);
   
-  double const Mhalf = Mlp+Mrm+Mp;
-  double const Phalf = Plp+Prm+Pu;
+  T const Mhalf = Mlp+Mrm+Mp;
+  T const Phalf = Plp+Prm+Pu;
   
-  if(Mhalf >= 0.0) {
-    double const ut = Mhalf*chalf; //-us_n;
-    double const mdot = area_sada*rl*ut;
-    double pg = Phalf-Pambient;
-    
+  upwindLeft = Mhalf >= T(0);
+  
+  T const ut = Mhalf*chalf; //-us_n;
+  mdotD = area_sada*(upwindLeft ? rl : rr)*ut;
+  pgD = Phalf-Pambient;
+  h0lD = h0l;
+  h0rD = h0r;
+}
+
+// Multi-species flux specialized for NS species. The species loop has a
+// compile-time trip count and the flux is assembled in a fixed-size array
+// before it is written out. Ns is ignored; it is there so that the function
+// has the same signature as AUSMPlusUpFluxMultiSpeciesIdealGas.
+template<int NS>
+void AUSMPlusUpFluxMultiSpeciesIdealGasNs(
+  double * flux,
+  int const /*Ns*/,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+) {
+  double mdot, pg, h0l, h0r;
+  bool upwindLeft;
+  AUSMPlusUpInterfaceMultiSpeciesIdealGas<double>(
+    mdot, pg, upwindLeft, h0l, h0r,
+    Ul, Pgl, Tl, Rtildel, Cpl,
+    Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient, Minf
+  );
+  
+  Loci::vector3d<double> const & U = upwindLeft ? Ul : Ur;
+  double const * Y = upwindLeft ? Yl : Yr;
+  
+  double f[NS+4];
+  f[0] = mdot*U.x+area_sada*pg*area_n.x;
+  f[1] = mdot*U.y+area_sada*pg*area_n.y;
+  f[2] = mdot*U.z+area_sada*pg*area_n.z;
+  f[3] = mdot*(upwindLeft ? h0l : h0r);
+  f[4] = mdot;
+  for(int i = 0; i < NS-1; ++i) {
+    f[5+i] = mdot*Y[i];
+  }
+  
+  for(int i = 0; i < NS+4; ++i) {
+    flux[i] = f[i];
+  }
+}
+
+// Returns the specialization for Ns if Ns is in the range [NS,
+// FLAME_FLUX_MAX_SPECIALIZED_NS] and nullptr otherwise.
+template<int NS>
+AUSMPlusUpFluxMultiSpeciesIdealGasFunction selectAUSMPlusUpFluxMultiSpeciesIdealGasNs(
+  int const Ns
+) {
+  if constexpr(NS > FLAME_FLUX_MAX_SPECIALIZED_NS) {
+    return nullptr;
+  } else {
+    if(Ns == NS) {
+      return &AUSMPlusUpFluxMultiSpeciesIdealGasNs<NS>;
+    }
+    return selectAUSMPlusUpFluxMultiSpeciesIdealGasNs<NS+1>(Ns);
+  }
+}
+
+// Multi-species flux for any number of species. The interface mass flux and
+// pressure are computed in type T and the flux is assembled in double.
+template<typename T>
+void AUSMPlusUpFluxMultiSpeciesIdealGasT(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+) {
+  double mdot, pg, h0l, h0r;
+  bool upwindLeft;
+  AUSMPlusUpInterfaceMultiSpeciesIdealGas<T>(
+    mdot, pg, upwindLeft, h0l, h0r,
+    Ul, Pgl, Tl, Rtildel, Cpl,
+    Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient, Minf
+  );
+  
+  if(upwindLeft) {
     flux[0] = mdot*Ul.x+area_sada*pg*area_n.x;
     flux[1] = mdot*Ul.y+area_sada*pg*area_n.y;
     flux[2] = mdot*Ul.z+area_sada*pg*area_n.z;
@@ -282,10 +547,6 @@ void AUSMPlusUpFluxMultiSpeciesIdealGas(
       flux[5+i] = mdot*Yl[i];
     }
   } else {
-    double const ut = Mhalf*chalf; //-us_n;
-    double const mdot = area_sada*rr*ut;
-    double pg = Phalf-Pambient;
-    
     flux[0] = mdot*Ur.x+area_sada*pg*area_n.x;
     flux[1] = mdot*Ur.y+area_sada*pg*area_n.y;
     flux[2] = mdot*Ur.z+area_sada*pg*area_n.z;
@@ -299,6 +560,352 @@ void AUSMPlusUpFluxMultiSpeciesIdealGas(
   }
 }
 
+} // end: namespace
+
+
+void AUSMPlusUpFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+) {
+  AUSMPlusUpFluxMultiSpeciesIdealGasT<double>(
+    flux, Ns,
+    Yl, Ul, Pgl, Tl, Rtildel, Cpl,
+    Yr, Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient, Minf
+  );
+}
+
+void AUSMPlusUpFluxMultiSpeciesIdealGasSP(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+) {
+  AUSMPlusUpFluxMultiSpeciesIdealGasT<float>(
+    flux, Ns,
+    Yl, Ul, Pgl, Tl, Rtildel, Cpl,
+    Yr, Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient, Minf
+  );
+}
+
+void AUSMPlusUpFluxMultiSpeciesThermallyPerfectGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl, double const hOffsetl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr, double const hOffsetr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Minf
+) {
+  AUSMPlusUpFluxMultiSpeciesIdealGasT<double>(
+    flux, Ns,
+    Yl, Ul, Pgl, Tl, Rtildel, Cpl,
+    Yr, Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient, Minf
+  );
+  
+  // The mass flux flux[4] is positive if the upwind side is the left one.
+  flux[3] += flux[4]*(flux[4] >= 0.0 ? hOffsetl : hOffsetr);
+}
+
+AUSMPlusUpFluxMultiSpeciesIdealGasFunction selectAUSMPlusUpFluxMultiSpeciesIdealGas(
+  int const Ns
+) {
+  AUSMPlusUpFluxMultiSpeciesIdealGasFunction fn =
+    selectAUSMPlusUpFluxMultiSpeciesIdealGasNs<FLAME_FLUX_MIN_SPECIALIZED_NS>(Ns);
+  return fn != nullptr ? fn : &AUSMPlusUpFluxMultiSpeciesIdealGas;
+}
+
+namespace {
+
+// State of one side of a face used by the HLLC and Rusanov fluxes.
+struct IdealGasSideState {
+  double rho, Un, P, a, h0, E;
+};
+
+inline
+IdealGasSideState idealGasSideState(
+  Loci::vector3d<double> const & U, double const Pg, double const T,
+  double const Rtilde, double const Cp,
+  Loci::vector3d<double> const & area_n, double const Pambient
+) {
+  IdealGasSideState s;
+  s.P = Pg+Pambient;
+  s.rho = s.P/(Rtilde*T);
+  s.Un = dot(U, area_n);
+  s.a = std::sqrt(Cp/(Cp-Rtilde)*Rtilde*T);
+  s.h0 = Cp*T+0.5*dot(U, U);
+  s.E = s.h0-s.P/s.rho;
+  return s;
+}
+
+// HLLC flux for single-species (Ns = 1) and multi-species states. Flux is
+// either Loci::Array<double, 5> or double *.
+template<typename Flux>
+void HLLCFluxIdealGasT(
+  Flux & flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient
+) {
+  IdealGasSideState const l = idealGasSideState(Ul, Pgl, Tl, Rtildel, Cpl, area_n, Pambient);
+  IdealGasSideState const r = idealGasSideState(Ur, Pgr, Tr, Rtilder, Cpr, area_n, Pambient);
+  
+  double const SL = std::min(l.Un-l.a, r.Un-r.a);
+  double const SR = std::max(l.Un+l.a, r.Un+r.a);
+  double const Sstar = (r.P-l.P+l.rho*l.Un*(SL-l.Un)-r.rho*r.Un*(SR-r.Un))/
+    (l.rho*(SL-l.Un)-r.rho*(SR-r.Un));
+  
+  // The flux is F_K+S*(Q*_K-Q_K) of the side K of the contact wave that
+  // contains the face, with S = 0 if all waves move away from the face.
+  bool const left = Sstar >= 0.0;
+  IdealGasSideState const & k = left ? l : r;
+  Loci::vector3d<double> const & U = left ? Ul : Ur;
+  double const * Y = left ? Yl : Yr;
+  double const SK = left ? SL : SR;
+  double const S = left ? std::min(SL, 0.0) : std::max(SR, 0.0);
+  
+  double const c = k.rho*(SK-k.Un)/(SK-Sstar);
+  double const dUn = Sstar-k.Un;
+  double const dE = c*(k.E+dUn*(Sstar+k.P/(k.rho*(SK-k.Un))))-k.rho*k.E;
+  
+  double const mdot = k.rho*k.Un;
+  double const pg = k.P-Pambient;
+  
+  flux[0] = area_sada*(mdot*U.x+pg*area_n.x+S*(c*(U.x+dUn*area_n.x)-k.rho*U.x));
+  flux[1] = area_sada*(mdot*U.y+pg*area_n.y+S*(c*(U.y+dUn*area_n.y)-k.rho*U.y));
+  flux[2] = area_sada*(mdot*U.z+pg*area_n.z+S*(c*(U.z+dUn*area_n.z)-k.rho*U.z));
+  flux[3] = area_sada*(mdot*k.h0+S*dE);
+  flux[4] = area_sada*(mdot+S*(c-k.rho));
+  for(int i = 0; i < Ns-1; ++i) {
+    flux[5+i] = flux[4]*Y[i];
+  }
+}
+
+// Rusanov flux for single-species (Ns = 1) and multi-species states.
+template<typename Flux>
+void RusanovFluxIdealGasT(
+  Flux & flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient
+) {
+  IdealGasSideState const l = idealGasSideState(Ul, Pgl, Tl, Rtildel, Cpl, area_n, Pambient);
+  IdealGasSideState const r = idealGasSideState(Ur, Pgr, Tr, Rtilder, Cpr, area_n, Pambient);
+  
+  double const lambda = std::max(std::fabs(l.Un)+l.a, std::fabs(r.Un)+r.a);
+  double const mdotl = l.rho*l.Un;
+  double const mdotr = r.rho*r.Un;
+  double const pg = Pgl+Pgr;
+  double const half = 0.5*area_sada;
+  
+  flux[0] = half*(mdotl*Ul.x+mdotr*Ur.x+pg*area_n.x-lambda*(r.rho*Ur.x-l.rho*Ul.x));
+  flux[1] = half*(mdotl*Ul.y+mdotr*Ur.y+pg*area_n.y-lambda*(r.rho*Ur.y-l.rho*Ul.y));
+  flux[2] = half*(mdotl*Ul.z+mdotr*Ur.z+pg*area_n.z-lambda*(r.rho*Ur.z-l.rho*Ul.z));
+  flux[3] = half*(mdotl*l.h0+mdotr*r.h0-lambda*(r.rho*r.E-l.rho*l.E));
+  flux[4] = half*(mdotl+mdotr-lambda*(r.rho-l.rho));
+  for(int i = 0; i < Ns-1; ++i) {
+    flux[5+i] = half*(mdotl*Yl[i]+mdotr*Yr[i]-lambda*(r.rho*Yr[i]-l.rho*Yl[i]));
+  }
+}
+
+} // end: namespace
+
+void HLLCFluxIdealGas(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp, double const /*Minf*/
+) {
+  HLLCFluxIdealGasT(
+    flux, 1,
+    nullptr, Ul, Pgl, Tl, Rtilde, Cp,
+    nullptr, Ur, Pgr, Tr, Rtilde, Cp,
+    area_sada, area_n, Pambient
+  );
+}
+
+void RusanovFluxIdealGas(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp, double const /*Minf*/
+) {
+  RusanovFluxIdealGasT(
+    flux, 1,
+    nullptr, Ul, Pgl, Tl, Rtilde, Cp,
+    nullptr, Ur, Pgr, Tr, Rtilde, Cp,
+    area_sada, area_n, Pambient
+  );
+}
+
+void HLLCFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const /*Minf*/
+) {
+  HLLCFluxIdealGasT(
+    flux, Ns,
+    Yl, Ul, Pgl, Tl, Rtildel, Cpl,
+    Yr, Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient
+  );
+}
+
+void RusanovFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const /*Minf*/
+) {
+  RusanovFluxIdealGasT(
+    flux, Ns,
+    Yl, Ul, Pgl, Tl, Rtildel, Cpl,
+    Yr, Ur, Pgr, Tr, Rtilder, Cpr,
+    area_sada, area_n, Pambient
+  );
+}
+
+void KEPCentralFluxIdealGas(
+  Loci::Array<double, 5> & flux,
+  Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient,
+  double const Rtilde, double const Cp
+) {
+  double const rl = (Pgl+Pambient)/(Rtilde*Tl);
+  double const rr = (Pgr+Pambient)/(Rtilde*Tr);
+  
+  double const h0l = Cp*Tl+0.5*dot(Ul, Ul);
+  double const h0r = Cp*Tr+0.5*dot(Ur, Ur);
+  
+  Loci::vector3d<double> const U = 0.5*(Ul+Ur);
+  double const mdot = area_sada*0.5*(rl+rr)*dot(U, area_n);
+  double const pg = 0.5*(Pgl+Pgr);
+  
+  flux[0] = mdot*U.x+area_sada*pg*area_n.x;
+  flux[1] = mdot*U.y+area_sada*pg*area_n.y;
+  flux[2] = mdot*U.z+area_sada*pg*area_n.z;
+  flux[3] = mdot*0.5*(h0l+h0r);
+  flux[4] = mdot;
+}
+
+void KEPCentralFluxMultiSpeciesIdealGas(
+  double * flux,
+  int const Ns,
+  double const * Yl, Loci::vector3d<double> const & Ul, double const Pgl, double const Tl,
+  double const Rtildel, double const Cpl,
+  double const * Yr, Loci::vector3d<double> const & Ur, double const Pgr, double const Tr,
+  double const Rtilder, double const Cpr,
+  double const area_sada, Loci::vector3d<double> const & area_n, double const Pambient
+) {
+  double const rl = (Pgl+Pambient)/(Rtildel*Tl);
+  double const rr = (Pgr+Pambient)/(Rtilder*Tr);
+  
+  double const h0l = Cpl*Tl+0.5*dot(Ul, Ul);
+  double const h0r = Cpr*Tr+0.5*dot(Ur, Ur);
+  
+  Loci::vector3d<double> const U = 0.5*(Ul+Ur);
+  double const mdot = area_sada*0.5*(rl+rr)*dot(U, area_n);
+  double const pg = 0.5*(Pgl+Pgr);
+  
+  flux[0] = mdot*U.x+area_sada*pg*area_n.x;
+  flux[1] = mdot*U.y+area_sada*pg*area_n.y;
+  flux[2] = mdot*U.z+area_sada*pg*area_n.z;
+  flux[3] = mdot*0.5*(h0l+h0r);
+  flux[4] = mdot;
+  for(int i = 0; i < Ns-1; ++i) {
+    flux[5+i] = mdot*0.5*(Yl[i]+Yr[i]);
+  }
+}
+
+void computeShearStress(
+  SymmetricTensor & tau, Loci::tensor3d<double> const & gradU, double const mu
+) {
+  double const divm = (gradU.x.x+gradU.y.y+gradU.z.z)*(1./3.);
+  
+  tau.xx = 2.0*mu*(gradU.x.x-divm);
+  tau.yy = 2.0*mu*(gradU.y.y-divm);
+  tau.zz = 2.0*mu*(gradU.z.z-divm);
+  
+  tau.xy = mu*(gradU.x.y+gradU.y.x);
+  tau.xz = mu*(gradU.x.z+gradU.z.x);
+  tau.yz = mu*(gradU.y.z+gradU.z.y);
+}
+
+Loci::vector3d<double> computeShearForce(
+  SymmetricTensor const & tau,
+  double const area_sada, Loci::vector3d<double> const & area_n
+) {
+  return Loci::vector3d<double>(
+    (tau.xx*area_n.x + tau.xy*area_n.y + tau.xz*area_n.z),
+    (tau.xy*area_n.x + tau.yy*area_n.y + tau.yz*area_n.z),
+    (tau.xz*area_n.x + tau.yz*area_n.y + tau.zz*area_n.z)
+  )*area_sada;
+}
+
+double computeHeatFlux(
+  Loci::vector3d<double> const & gradT, double const k,
+  double const area_sada, Loci::vector3d<double> const & area_n
+) {
+  return -k*area_sada*dot(gradT, area_n);
+}
+
+void computeViscousFlux(
+  double * flux,
+  Loci::vector3d<double> const & shearForce, Loci::vector3d<double> const & U,
+  double const heat
+) {
+  flux[0] = shearForce.x;
+  flux[1] = shearForce.y;
+  flux[2] = shearForce.z;
+  flux[3] = dot(U, shearForce) - heat;
+}
+
+void computeViscousFlux(
+  double * flux,
+  Loci::tensor3d<double> const & gradU, double const mu,
+  Loci::vector3d<double> const & gradT, double const k,
+  Loci::vector3d<double> const & U,
+  double const area_sada, Loci::vector3d<double> const & area_n
+) {
+  SymmetricTensor tau;
+  computeShearStress(tau, gradU, mu);
+  computeViscousFlux(
+    flux, computeShearForce(tau, area_sada, area_n), U,
+    computeHeatFlux(gradT, k, area_sada, area_n)
+  );
+}
+
 //void computeDiffusionVelocityWithRamshawCorrection(
 //  Loci::vector3d<double> * velocityD,
 //  Loci::vector3d<double> const * gradY, double const * Y,
@@ -331,5 +938,5 @@ void computeSpeciesDiffusionFluxWithRamshawCorrection(
     flux[i] -= Y[i]*correction;
   }
 }
-  
+
 } // end: namespace flame
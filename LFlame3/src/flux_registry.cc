@@ -0,0 +1,51 @@
+#include <flux_registry.hh>
+
+namespace flame {
+
+ConvectiveFluxSchemeList::Item * ConvectiveFluxSchemeList::items = nullptr;
+
+ConvectiveFluxScheme const * ConvectiveFluxSchemeList::find(std::string const & name) {
+  for(Item const * p = items; p != nullptr; p = p->next) {
+    if(name == p->entry.name) {
+      return &p->entry;
+    }
+  }
+  return nullptr;
+}
+
+std::string ConvectiveFluxSchemeList::names() {
+  std::string result;
+  for(Item const * p = items; p != nullptr; p = p->next) {
+    if(!result.empty()) {
+      result += ", ";
+    }
+    result += p->entry.name;
+  }
+  return result;
+}
+
+namespace {
+
+MultiSpeciesIdealGasFluxFunction selectHLLCFluxMultiSpeciesIdealGas(int const /*Ns*/) {
+  return HLLCFluxMultiSpeciesIdealGas;
+}
+
+MultiSpeciesIdealGasFluxFunction selectRusanovFluxMultiSpeciesIdealGas(int const /*Ns*/) {
+  return RusanovFluxMultiSpeciesIdealGas;
+}
+
+registerConvectiveFluxScheme registerAUSMPlusUp(
+  "ausmPlusUp", AUSMPlusUpFluxIdealGas, selectAUSMPlusUpFluxMultiSpeciesIdealGas
+);
+
+registerConvectiveFluxScheme registerHLLC(
+  "hllc", HLLCFluxIdealGas, selectHLLCFluxMultiSpeciesIdealGas
+);
+
+registerConvectiveFluxScheme registerRusanov(
+  "rusanov", RusanovFluxIdealGas, selectRusanovFluxMultiSpeciesIdealGas
+);
+
+} // end: namespace
+
+} // end: namespace flame
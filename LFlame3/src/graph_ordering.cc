@@ -0,0 +1,144 @@
+#include <graph_ordering.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+namespace flame {
+
+namespace {
+
+int degree(AdjacencyGraph const & graph, int const v) {
+  return graph.offsets[v+1]-graph.offsets[v];
+}
+
+// Breadth-first search from root over unvisited vertices. Appends the visited
+// vertices to queue in Cuthill-McKee order, i.e. neighbors of a vertex in
+// increasing order of degree, and sets their level. Returns the number of
+// levels.
+int cuthillMcKee(
+  AdjacencyGraph const & graph, int const root,
+  std::vector<int> & level, std::vector<int> & queue
+) {
+  std::size_t head = queue.size();
+  queue.push_back(root);
+  level[root] = 0;
+  
+  std::vector<int> neighbors;
+  while(head < queue.size()) {
+    int const v = queue[head++];
+    
+    neighbors.clear();
+    for(int i = graph.offsets[v]; i < graph.offsets[v+1]; ++i) {
+      int const u = graph.adjacency[i];
+      if(level[u] < 0) {
+        level[u] = level[v]+1;
+        neighbors.push_back(u);
+      }
+    }
+    std::stable_sort(
+      neighbors.begin(), neighbors.end(),
+      [&graph](int const a, int const b) {
+        return degree(graph, a) < degree(graph, b);
+      }
+    );
+    
+    queue.insert(queue.end(), neighbors.begin(), neighbors.end());
+  }
+  
+  return level[queue.back()]+1;
+}
+
+} // end: anonymous namespace
+
+void createAdjacencyGraph(
+  int const n, std::vector<std::pair<int, int>> const & edges,
+  AdjacencyGraph & graph
+) {
+  graph.offsets.assign(n+1, 0);
+  for(std::size_t e = 0; e < edges.size(); ++e) {
+    ++graph.offsets[edges[e].first+1];
+    ++graph.offsets[edges[e].second+1];
+  }
+  for(int v = 0; v < n; ++v) {
+    graph.offsets[v+1] += graph.offsets[v];
+  }
+  
+  graph.adjacency.resize(graph.offsets[n]);
+  std::vector<int> next(graph.offsets.begin(), graph.offsets.end()-1);
+  for(std::size_t e = 0; e < edges.size(); ++e) {
+    graph.adjacency[next[edges[e].first]++] = edges[e].second;
+    graph.adjacency[next[edges[e].second]++] = edges[e].first;
+  }
+}
+
+void reverseCuthillMcKeeOrder(
+  AdjacencyGraph const & graph, std::vector<int> & order
+) {
+  int const n = graph.numVertices();
+  
+  std::vector<int> level(n, -1);
+  std::vector<int> component;
+  order.clear();
+  order.reserve(n);
+  
+  for(int start = 0; start < n; ++start) {
+    if(level[start] >= 0) {
+      continue;
+    }
+    
+    // Search from a vertex of minimum degree in the last level until the
+    // number of levels stops growing. The last search starts from a
+    // pseudo-peripheral vertex of the component.
+    component.clear();
+    int nLevels = cuthillMcKee(graph, start, level, component);
+    while(true) {
+      int root = -1;
+      for(std::size_t k = 0; k < component.size(); ++k) {
+        int const v = component[k];
+        if(level[v] == nLevels-1 && (root < 0 || degree(graph, v) < degree(graph, root))) {
+          root = v;
+        }
+      }
+      
+      for(std::size_t k = 0; k < component.size(); ++k) {
+        level[component[k]] = -1;
+      }
+      component.clear();
+      
+      int const nRootLevels = cuthillMcKee(graph, root, level, component);
+      if(nRootLevels <= nLevels) {
+        break;
+      }
+      nLevels = nRootLevels;
+    }
+    
+    order.insert(order.end(), component.begin(), component.end());
+  }
+  
+  std::reverse(order.begin(), order.end());
+}
+
+int graphBandwidth(AdjacencyGraph const & graph, std::vector<int> const & order) {
+  int const n = graph.numVertices();
+  
+  std::vector<int> newNumber(n);
+  if(order.empty()) {
+    std::iota(newNumber.begin(), newNumber.end(), 0);
+  } else {
+    for(int k = 0; k < n; ++k) {
+      newNumber[order[k]] = k;
+    }
+  }
+  
+  int bandwidth = 0;
+  for(int v = 0; v < n; ++v) {
+    for(int i = graph.offsets[v]; i < graph.offsets[v+1]; ++i) {
+      bandwidth = std::max(bandwidth, std::abs(newNumber[v]-newNumber[graph.adjacency[i]]));
+    }
+  }
+  
+  return bandwidth;
+}
+
+} // end: namespace flame
@@ -0,0 +1,358 @@
+#include <grid_renumbering.hh>
+#include <space_filling_curve.hh>
+#include <graph_ordering.hh>
+#include <partition_renumbering.hh>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define GLOG_USE_GLOG_EXPORT
+#include <glog/logging.h>
+
+namespace flame {
+
+namespace {
+
+// (old, new) numbers of the cells and internal faces this process renumbered,
+// sorted by old number, and the (new, old) numbers sorted by new number.
+struct RenumberedEntities {
+  std::vector<std::pair<int, int> > remap;
+  std::vector<std::pair<int, int> > inverse;
+};
+
+RenumberedEntities & renumberedEntities() {
+  static RenumberedEntities entities;
+  return entities;
+}
+
+// Sets map to the map of the entities of dom by the (from, to) numbers of
+// remap, sorted by from, and to themselves if they are not in remap. Returns
+// the image of dom.
+Loci::entitySet renumberingMap(
+  std::vector<std::pair<int, int> > const & remap, Loci::entitySet const & dom,
+  dMap & map
+) {
+  Loci::entitySet image = EMPTY;
+  for(Loci::entitySet::const_iterator ei = dom.begin(); ei != dom.end(); ++ei) {
+    int const e = renumberedEntity(remap, *ei);
+    map[*ei] = e;
+    image += e;
+  }
+  return image;
+}
+
+// Approximates the centroid of each cell by the average of the centers of its
+// faces. Face centers are the average of the face nodes. In a partitioned grid
+// only the faces of this process are averaged, which still places the point in
+// or on the cell.
+void cellCentroids(
+  fact_db & facts, std::vector<Loci::Entity> const & cells,
+  std::vector<Loci::vector3d<double>> & centroids
+) {
+  store<Loci::vector3d<double>> pos;
+  pos = facts.get_variable("pos");
+  multiMap face2node;
+  face2node = facts.get_variable("face2node");
+  Map cl, cr;
+  cl = facts.get_variable("cl");
+  cr = facts.get_variable("cr");
+  
+  Loci::Entity const cellMin = cells.front();
+  int const nCells = cells.back()-cellMin+1;
+  
+  std::vector<Loci::vector3d<double>> sum(nCells, Loci::vector3d<double>(0.0, 0.0, 0.0));
+  std::vector<int> count(nCells, 0);
+  
+  Loci::entitySet const faces = cl.domain();
+  for(Loci::entitySet::const_iterator fi = faces.begin(); fi != faces.end(); ++fi) {
+    int const nn = face2node.num_elems(*fi);
+    Loci::vector3d<double> center(0.0, 0.0, 0.0);
+    for(int i = 0; i < nn; ++i) {
+      center += pos[face2node[*fi][i]];
+    }
+    center *= 1.0/nn;
+    
+    int const l = cl[*fi]-cellMin;
+    if(l >= 0 && l < nCells) {
+      sum[l] += center;
+      ++count[l];
+    }
+    
+    int const r = cr[*fi]-cellMin;
+    if(r >= 0 && r < nCells) {
+      sum[r] += center;
+      ++count[r];
+    }
+  }
+  
+  centroids.resize(cells.size());
+  for(std::size_t i = 0; i < cells.size(); ++i) {
+    int const c = cells[i]-cellMin;
+    centroids[i] = sum[c]/double(std::max(count[c], 1));
+  }
+}
+
+// Creates the adjacency graph of cells connected by internal faces. Vertex i
+// of the graph is cells[i].
+void cellAdjacencyGraph(
+  Map const & cl, Map const & cr, std::vector<Loci::Entity> const & cells,
+  AdjacencyGraph & graph
+) {
+  Loci::Entity const cellMin = cells.front();
+  std::vector<int> index(cells.back()-cellMin+1, -1);
+  for(std::size_t i = 0; i < cells.size(); ++i) {
+    index[cells[i]-cellMin] = i;
+  }
+  
+  std::vector<std::pair<int, int>> edges;
+  Loci::entitySet const crdom = cr.domain();
+  for(Loci::entitySet::const_iterator fi = crdom.begin(); fi != crdom.end(); ++fi) {
+    int const l = cl[*fi]-cellMin, r = cr[*fi]-cellMin;
+    if(l >= 0 && l < int(index.size()) && index[l] >= 0 &&
+      r >= 0 && r < int(index.size()) && index[r] >= 0) {
+      edges.push_back(std::make_pair(index[l], index[r]));
+    }
+  }
+  
+  createAdjacencyGraph(cells.size(), edges, graph);
+}
+
+} // end: anonymous namespace
+
+void renumberGrid(fact_db & facts) {
+  std::string method = "none";
+  {
+    Loci::storeRepP rep = facts.get_variable("gridRenumbering");
+    if(rep != 0 && rep->RepType() == Loci::PARAMETER) {
+      param<std::string> gridRenumbering;
+      gridRenumbering.setRep(rep);
+      method = *gridRenumbering;
+    }
+  }
+  
+  if(method == "none") {
+    return;
+  }
+  
+  if(method != "morton" && method != "hilbert" && method != "rcm") {
+    if(Loci::MPI_rank == 0) {
+      LOG(ERROR) << "invalid value of gridRenumbering: " << method;
+    }
+    Loci::Abort();
+  }
+  
+  int const P = Loci::MPI_processes, me = Loci::MPI_rank;
+  
+  // Each process renumbers the cells and faces it owns among their numbers, so
+  // that the partition of the grid is unchanged.
+  std::vector<Loci::entitySet> ptn;
+  Loci::entitySet owned = ~EMPTY;
+  if(P > 1) {
+    ptn = facts.get_init_ptn();
+    owned = ptn[me];
+  }
+  
+  // Returns the process that owns entity e, or -1 if e is not an entity of
+  // the grid, e.g. cr of a boundary face.
+  auto owner = [&ptn, P](Loci::Entity const e) {
+    for(int p = 0; p < P && !ptn.empty(); ++p) {
+      if(ptn[p].inSet(e)) {
+        return p;
+      }
+    }
+    return -1;
+  };
+  
+  constraint geom_cells;
+  geom_cells = facts.get_variable("geom_cells");
+  Map cl, cr;
+  cl = facts.get_variable("cl");
+  cr = facts.get_variable("cr");
+  
+  Loci::entitySet const cellSet = *geom_cells & owned;
+  
+  // Order cells by the selected method. The k-th cell in the new order takes
+  // the k-th smallest cell number.
+  PartitionRenumbering renumbering;
+  std::vector<int> & cells = renumbering.cells;
+  std::vector<int> & order = renumbering.order;
+  cells.assign(cellSet.begin(), cellSet.end());
+  int bandwidth[2] = {0, 0};
+  if(cellSet != EMPTY && method == "rcm") {
+    AdjacencyGraph graph;
+    cellAdjacencyGraph(cl, cr, cells, graph);
+    reverseCuthillMcKeeOrder(graph, order);
+    bandwidth[0] = graphBandwidth(graph, std::vector<int>());
+    bandwidth[1] = graphBandwidth(graph, order);
+  } else if(cellSet != EMPTY) {
+    std::vector<Loci::vector3d<double>> centroids;
+    cellCentroids(facts, cells, centroids);
+    spaceFillingCurveOrder(
+      centroids,
+      method == "hilbert" ? SpaceFillingCurve::Hilbert : SpaceFillingCurve::Morton,
+      order
+    );
+  }
+  
+  if(method == "rcm") {
+    int maxBandwidth[2];
+    MPI_Allreduce(bandwidth, maxBandwidth, 2, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if(me == 0) {
+      LOG(INFO) << "Cell adjacency bandwidth reduced from " << maxBandwidth[0]
+        << " to " << maxBandwidth[1];
+    }
+  }
+  
+  // Internal faces are the faces with a cell on either side, which may be
+  // owned by another process. They are ordered by the new numbers of their
+  // left and right cells so that the face loops sweep the cells in order.
+  Loci::entitySet const crdom = cr.domain() & owned;
+  for(Loci::entitySet::const_iterator fi = crdom.begin(); fi != crdom.end(); ++fi) {
+    int const lo = cellSet.inSet(cl[*fi]) ? me : owner(cl[*fi]);
+    int const ro = cellSet.inSet(cr[*fi]) ? me : owner(cr[*fi]);
+    if(lo >= 0 && ro >= 0) {
+      renumbering.faces.push_back(*fi);
+      renumbering.left.push_back(cl[*fi]);
+      renumbering.right.push_back(cr[*fi]);
+      renumbering.leftOwner.push_back(lo);
+      renumbering.rightOwner.push_back(ro);
+    }
+  }
+  renumberPartition(renumbering, MPI_COMM_WORLD);
+  
+  RenumberedEntities & entities = renumberedEntities();
+  entities.remap = renumbering.remap;
+  invertRenumbering(entities.remap, entities.inverse);
+  
+  dMap remap;
+  for(std::size_t i = 0; i < renumbering.remap.size(); ++i) {
+    remap[renumbering.remap[i].first] = renumbering.remap[i].second;
+  }
+  for(std::size_t i = 0; i < renumbering.remoteRemap.size(); ++i) {
+    remap[renumbering.remoteRemap[i].first] = renumbering.remoteRemap[i].second;
+  }
+  
+  Loci::variableSet const vars = facts.get_typed_variables();
+  
+  // New numbers of the other entities of other processes in the image of a
+  // map, e.g. the cells of boundary faces.
+  if(P > 1) {
+    Loci::entitySet remote = EMPTY;
+    for(Loci::variableSet::const_iterator vi = vars.begin(); vi != vars.end(); ++vi) {
+      Loci::storeRepP rep = facts.get_variable(*vi);
+      if(rep != 0 && rep->RepType() == Loci::MAP && rep->domain() != ~EMPTY) {
+        remote += Loci::MapRepP(rep->getRep())->image(rep->domain());
+      }
+    }
+    remote -= owned;
+    remote -= remap.domain();
+    
+    std::vector<std::vector<int> > requests(P), numbers;
+    for(int p = 0; p < P; ++p) {
+      if(p != me) {
+        Loci::entitySet const r = remote & ptn[p];
+        requests[p].assign(r.begin(), r.end());
+      }
+    }
+    exchangeRenumbering(renumbering.remap, requests, numbers, MPI_COMM_WORLD);
+    for(int p = 0; p < P; ++p) {
+      for(std::size_t i = 0; i < requests[p].size(); ++i) {
+        if(numbers[p][i] != requests[p][i]) {
+          remap[requests[p][i]] = numbers[p][i];
+        }
+      }
+    }
+  }
+  
+  Loci::entitySet const renumbered = remap.domain();
+  
+  // Remap the domain of every container that lives on renumbered entities and
+  // the image of every map. All other entities are mapped to themselves.
+  for(Loci::variableSet::const_iterator vi = vars.begin(); vi != vars.end(); ++vi) {
+    Loci::storeRepP rep = facts.get_variable(*vi);
+    if(rep == 0) {
+      continue;
+    }
+    
+    int const type = rep->RepType();
+    if(type == Loci::PARAMETER || type == Loci::BLACKBOX) {
+      continue;
+    }
+    
+    Loci::entitySet const dom = rep->domain();
+    if(dom == ~EMPTY) {
+      continue;
+    }
+    
+    Loci::entitySet img = EMPTY;
+    if(type == Loci::MAP) {
+      img = Loci::MapRepP(rep->getRep())->image(dom);
+    }
+    
+    if((dom & renumbered) == EMPTY && (img & renumbered) == EMPTY) {
+      continue;
+    }
+    
+    Loci::entitySet const identity = (dom+img)-renumbered;
+    for(Loci::entitySet::const_iterator ei = identity.begin(); ei != identity.end(); ++ei) {
+      remap[*ei] = *ei;
+    }
+    
+    Loci::storeRepP newRep = rep->remap(remap);
+    if(type == Loci::MAP) {
+      Loci::MapRepP(newRep->getRep())->compose(remap, newRep->domain());
+    }
+    facts.replace_fact(*vi, newRep);
+  }
+  
+  int counts[2] = {int(cells.size()), int(renumbering.faces.size())};
+  int totals[2];
+  MPI_Allreduce(counts, totals, 2, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  if(me == 0) {
+    LOG(INFO) << "Renumbered " << totals[0] << " cells and " << totals[1]
+      << " internal faces using " << method << " ordering";
+  }
+}
+
+void writeRenumberedContainer(
+  hid_t fileId, std::string const & name, Loci::storeRepP var
+) {
+  RenumberedEntities const & entities = renumberedEntities();
+  int const type = var->RepType();
+  if(entities.remap.empty() || type == Loci::PARAMETER || type == Loci::BLACKBOX) {
+    Loci::writeContainer(fileId, name, var);
+    return;
+  }
+  
+  dMap original;
+  renumberingMap(entities.inverse, var->domain(), original);
+  Loci::writeContainer(fileId, name, var->remap(original));
+}
+
+void readRenumberedContainer(
+  hid_t fileId, std::string const & name, Loci::storeRepP var,
+  Loci::entitySet const & dom
+) {
+  RenumberedEntities const & entities = renumberedEntities();
+  int const type = var->RepType();
+  if(entities.remap.empty() || type == Loci::PARAMETER || type == Loci::BLACKBOX) {
+    Loci::readContainer(fileId, name, var, dom);
+    return;
+  }
+  
+  // Read the values at the numbers before renumbering and move them to the
+  // new numbers.
+  dMap original;
+  Loci::entitySet const originalDom = renumberingMap(entities.inverse, dom, original);
+  Loci::storeRepP file = var->new_store(originalDom);
+  Loci::readContainer(fileId, name, file, originalDom);
+  
+  dMap renumbered;
+  renumberingMap(entities.remap, originalDom, renumbered);
+  Loci::storeRepP values = file->remap(renumbered);
+  var->copy(values, dom);
+}
+
+} // end: namespace flame
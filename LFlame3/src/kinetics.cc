@@ -0,0 +1,662 @@
+#include <kinetics.hh>
+#include <kinetics_registry.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace flame {
+
+void initKineticsTable(
+  KineticsTable & table, Mixture const & mixture, double const Runiv
+) {
+  int const Ns = mixture.nSpecies;
+  int const Nr = mixture.nReactions;
+
+  table.nSpecies = Ns;
+  table.nReactions = Nr;
+  table.Runiv = Runiv;
+  table.lnPstdByRuniv = std::log(FLAME_KINETICS_PSTD/Runiv);
+  table.hasReversible = false;
+
+  table.W.resize(Ns);
+  table.tMid.resize(Ns);
+  table.gibbsCoefficients.resize(2*Ns*FLAME_KINETICS_NCOEFF);
+
+  for(int s = 0; s < Ns; ++s) {
+    NASA9Thermochemistry const & thermo = mixture.nasa9Thermochemistry[s];
+    table.W[s] = mixture.molecularWeight[s];
+    table.tMid[s] = thermo.tRange[1];
+
+    // g/(Runiv*T) = h/(Runiv*T) - s/Runiv of the NASA9 polynomials.
+    for(int k = 0; k < 2; ++k) {
+      double const * a = &thermo.cpCoeff[9*k];
+      double * c = &table.gibbsCoefficients[(2*s+k)*FLAME_KINETICS_NCOEFF];
+
+      c[0] = -0.5*a[0];
+      c[1] = a[1];
+      c[2] = -a[2];
+      c[3] = a[1]+a[7];
+      c[4] = a[2]-a[8];
+      c[5] = -a[3]/2.0;
+      c[6] = -a[4]/6.0;
+      c[7] = -a[5]/12.0;
+      c[8] = -a[6]/20.0;
+    }
+  }
+
+  table.type.resize(Nr);
+  table.reversible.resize(Nr);
+  table.lnA.resize(Nr);
+  table.b.resize(Nr);
+  table.Ta.resize(Nr);
+  table.lnA0.resize(Nr);
+  table.b0.resize(Nr);
+  table.Ta0.resize(Nr);
+  table.troe.assign(6*Nr, 0.0);
+  table.dNu.resize(Nr);
+
+  table.reactantOffset.assign(1, 0);
+  table.productOffset.assign(1, 0);
+  table.netOffset.assign(1, 0);
+  table.efficiencyOffset.assign(1, 0);
+  table.reactantSpecies.clear();
+  table.reactantCoeff.clear();
+  table.productSpecies.clear();
+  table.productCoeff.clear();
+  table.netSpecies.clear();
+  table.netCoeff.clear();
+  table.efficiencySpecies.clear();
+  table.efficiency.clear();
+
+  std::vector<double> nu(Ns);
+
+  for(int r = 0; r < Nr; ++r) {
+    Reaction const & reaction = mixture.reactions[r];
+
+    if(reaction.falloffModel == FALLOFF_TROE) {
+      table.type[r] = KINETICS_TROE;
+    } else if(reaction.falloffModel == FALLOFF_LINDEMANN) {
+      table.type[r] = KINETICS_LINDEMANN;
+    } else if(reaction.hasThirdBody) {
+      table.type[r] = KINETICS_THIRD_BODY;
+    } else {
+      table.type[r] = KINETICS_ELEMENTARY;
+    }
+
+    table.reversible[r] = reaction.reversible;
+    table.hasReversible = table.hasReversible || reaction.reversible;
+
+    table.lnA[r] = std::log(reaction.rate.A);
+    table.b[r] = reaction.rate.b;
+    table.Ta[r] = reaction.rate.Ea/Runiv;
+    table.lnA0[r] = std::log(reaction.lowPressureRate.A);
+    table.b0[r] = reaction.lowPressureRate.b;
+    table.Ta0[r] = reaction.lowPressureRate.Ea/Runiv;
+
+    if(reaction.falloffModel == FALLOFF_TROE) {
+      double const alpha = reaction.troe[0];
+      double const T3 = reaction.troe[1];
+      double const T1 = reaction.troe[2];
+      double * t = &table.troe[6*r];
+      if(T3 != 0.0) {
+        t[0] = 1.0-alpha;
+        t[1] = 1.0/T3;
+      }
+      if(T1 != 0.0) {
+        t[2] = alpha;
+        t[3] = 1.0/T1;
+      }
+      if(reaction.nTroe == 4) {
+        t[4] = 1.0;
+        t[5] = reaction.troe[3];
+      }
+    }
+
+    std::fill(nu.begin(), nu.end(), 0.0);
+    for(int j = 0; j < reaction.nReactants; ++j) {
+      table.reactantSpecies.push_back(reaction.reactantSpecies[j]);
+      table.reactantCoeff.push_back(reaction.reactantCoeff[j]);
+      nu[reaction.reactantSpecies[j]] -= reaction.reactantCoeff[j];
+    }
+    for(int j = 0; j < reaction.nProducts; ++j) {
+      table.productSpecies.push_back(reaction.productSpecies[j]);
+      table.productCoeff.push_back(reaction.productCoeff[j]);
+      nu[reaction.productSpecies[j]] += reaction.productCoeff[j];
+    }
+
+    table.dNu[r] = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      if(nu[s] != 0.0) {
+        table.netSpecies.push_back(s);
+        table.netCoeff.push_back(nu[s]);
+        table.dNu[r] += nu[s];
+      }
+    }
+
+    if(reaction.hasThirdBody || reaction.falloffModel != FALLOFF_NONE) {
+      for(int j = 0; j < reaction.nEfficiencies; ++j) {
+        table.efficiencySpecies.push_back(reaction.efficiencySpecies[j]);
+        table.efficiency.push_back(reaction.efficiency[j]-1.0);
+      }
+    }
+
+    table.reactantOffset.push_back(table.reactantSpecies.size());
+    table.productOffset.push_back(table.productSpecies.size());
+    table.netOffset.push_back(table.netSpecies.size());
+    table.efficiencyOffset.push_back(table.efficiencySpecies.size());
+  }
+
+  table.compiled = CompiledMechanismList::find(kineticsTableHash(table));
+}
+
+void initKineticsWorkspace(KineticsWorkspace & work, KineticsTable const & table) {
+  work.C.resize(table.nSpecies*FLAME_KINETICS_BLOCK_SIZE);
+  work.gRT.resize(table.hasReversible ? table.nSpecies*FLAME_KINETICS_BLOCK_SIZE : 0);
+}
+
+namespace {
+
+// Multiplies the rates q of n cells by the concentrations C of the species of
+// a reaction raised to their stoichiometric coefficients. Coefficients 1 and 2
+// are multiplied out instead of calling pow.
+void multiplyConcentrations(
+  int const n, int const begin, int const end,
+  int const * species, double const * coeff, double const * C, double * q
+) {
+  int const B = FLAME_KINETICS_BLOCK_SIZE;
+
+  for(int j = begin; j < end; ++j) {
+    double const * Cs = &C[species[j]*B];
+    double const nu = coeff[j];
+    if(nu == 1.0) {
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        q[i] *= Cs[i];
+      }
+    } else if(nu == 2.0) {
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        q[i] *= Cs[i]*Cs[i];
+      }
+    } else {
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        q[i] *= std::pow(Cs[i], nu);
+      }
+    }
+  }
+}
+
+} // end: namespace
+
+void kineticsProductionRates(
+  KineticsTable const & table, KineticsWorkspace & work, int const n,
+  double const * rho, double const * T, double const * Y, double * omega
+) {
+  if(table.compiled != nullptr) {
+    table.compiled->productionRates(table, work, n, rho, T, Y, omega);
+    return;
+  }
+
+  int const Ns = table.nSpecies;
+  int const Nr = table.nReactions;
+  int const B = FLAME_KINETICS_BLOCK_SIZE;
+  double const ln10 = std::log(10.0);
+
+  // Largest exponent of the reverse rate constant, which keeps it finite when
+  // the forward rate constant of a strongly exothermic reaction underflows.
+  double const maxExponent = 600.0;
+
+  double * C = &work.C[0];
+  double * gRT = table.hasReversible ? &work.gRT[0] : nullptr;
+
+  alignas(FLAME_SIMD_ALIGN) double rT[B];
+  alignas(FLAME_SIMD_ALIGN) double lnT[B];
+  alignas(FLAME_SIMD_ALIGN) double lnPRT[B];
+  alignas(FLAME_SIMD_ALIGN) double Ctot[B];
+  alignas(FLAME_SIMD_ALIGN) double x[B];
+  alignas(FLAME_SIMD_ALIGN) double fac[B];
+  alignas(FLAME_SIMD_ALIGN) double M[B];
+  alignas(FLAME_SIMD_ALIGN) double qf[B];
+  alignas(FLAME_SIMD_ALIGN) double qr[B];
+
+  FLAME_SIMD_LOOP
+  for(int i = 0; i < n; ++i) {
+    rT[i] = 1.0/T[i];
+    lnT[i] = std::log(T[i]);
+    lnPRT[i] = table.lnPstdByRuniv-lnT[i];
+    Ctot[i] = 0.0;
+  }
+
+  // Molar concentrations: [kmol/m^3]. Small negative mass fractions of the
+  // transport are clipped so that the rates stay defined.
+  for(int s = 0; s < Ns; ++s) {
+    double const rW = 1.0/table.W[s];
+    double const * Ys = &Y[s*B];
+    double * Cs = &C[s*B];
+    double * omegas = &omega[s*B];
+    FLAME_SIMD_LOOP
+    for(int i = 0; i < n; ++i) {
+      Cs[i] = std::max(0.0, rho[i]*Ys[i]*rW);
+      Ctot[i] += Cs[i];
+      omegas[i] = 0.0;
+    }
+  }
+
+  // Dimensionless Gibbs energies, with the coefficients of the lower and upper
+  // range blended with a weight of 1 or 0 as in the NASA9 evaluation.
+  if(table.hasReversible) {
+    for(int s = 0; s < Ns; ++s) {
+      double const tMid = table.tMid[s];
+      double const * c0 = &table.gibbsCoefficients[2*s*FLAME_KINETICS_NCOEFF];
+      double const * c1 = c0+FLAME_KINETICS_NCOEFF;
+      double * g = &gRT[s*B];
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        double const t = T[i];
+        double const w = t < tMid ? 1.0 : 0.0;
+        g[i] =
+          ((c1[0]+w*(c0[0]-c1[0]))*rT[i]+(c1[1]+w*(c0[1]-c1[1]))*lnT[i]+
+          (c1[3]+w*(c0[3]-c1[3])))*rT[i]+(c1[2]+w*(c0[2]-c1[2]))*lnT[i]+
+          (c1[4]+w*(c0[4]-c1[4]))+t*((c1[5]+w*(c0[5]-c1[5]))+
+          t*((c1[6]+w*(c0[6]-c1[6]))+t*((c1[7]+w*(c0[7]-c1[7]))+
+          t*(c1[8]+w*(c0[8]-c1[8])))));
+      }
+    }
+  }
+
+  for(int r = 0; r < Nr; ++r) {
+    int const type = table.type[r];
+    double const lnA = table.lnA[r];
+    double const b = table.b[r];
+    double const Ta = table.Ta[r];
+
+    // Arrhenius rate constant, or its high-pressure limit.
+    FLAME_SIMD_LOOP
+    for(int i = 0; i < n; ++i) {
+      x[i] = lnA+b*lnT[i]-Ta*rT[i];
+      fac[i] = 1.0;
+    }
+
+    if(type != KINETICS_ELEMENTARY) {
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        M[i] = Ctot[i];
+      }
+      for(int j = table.efficiencyOffset[r]; j < table.efficiencyOffset[r+1]; ++j) {
+        double const e = table.efficiency[j];
+        double const * Cs = &C[table.efficiencySpecies[j]*B];
+        FLAME_SIMD_LOOP
+        for(int i = 0; i < n; ++i) {
+          M[i] += e*Cs[i];
+        }
+      }
+    }
+
+    if(type == KINETICS_THIRD_BODY) {
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        fac[i] = M[i];
+      }
+    } else if(type == KINETICS_LINDEMANN) {
+      double const lnA0 = table.lnA0[r];
+      double const b0 = table.b0[r];
+      double const Ta0 = table.Ta0[r];
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        double const Pr = std::exp(lnA0+b0*lnT[i]-Ta0*rT[i]-x[i])*M[i];
+        fac[i] = Pr/(1.0+Pr);
+      }
+    } else if(type == KINETICS_TROE) {
+      double const lnA0 = table.lnA0[r];
+      double const b0 = table.b0[r];
+      double const Ta0 = table.Ta0[r];
+      double const * t = &table.troe[6*r];
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        double const Pr = std::exp(lnA0+b0*lnT[i]-Ta0*rT[i]-x[i])*M[i];
+        double const Fcent =
+          t[0]*std::exp(-T[i]*t[1])+t[2]*std::exp(-T[i]*t[3])+
+          t[4]*std::exp(-t[5]*rT[i]);
+        double const logFcent = std::log10(std::max(Fcent, 1.0e-300));
+        double const logPr = std::log10(std::max(Pr, 1.0e-300));
+        double const c = -0.4-0.67*logFcent;
+        double const m = 0.75-1.27*logFcent;
+        double const f = (logPr+c)/(m-0.14*(logPr+c));
+        double const F = std::exp(ln10*logFcent/(1.0+f*f));
+        fac[i] = Pr/(1.0+Pr)*F;
+      }
+    }
+
+    FLAME_SIMD_LOOP
+    for(int i = 0; i < n; ++i) {
+      qf[i] = std::exp(x[i])*fac[i];
+    }
+    multiplyConcentrations(
+      n, table.reactantOffset[r], table.reactantOffset[r+1],
+      &table.reactantSpecies[0], &table.reactantCoeff[0], C, qf
+    );
+
+    // Reverse rate constant kr = kf/Kc with
+    //   ln(Kc) = -sum_s nu_s g_s/(Runiv*T) + dNu*ln(Pstd/(Runiv*T)).
+    if(table.reversible[r]) {
+      double const dNu = table.dNu[r];
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        qr[i] = x[i]-dNu*lnPRT[i];
+      }
+      for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+        double const nu = table.netCoeff[j];
+        double const * g = &gRT[table.netSpecies[j]*B];
+        FLAME_SIMD_LOOP
+        for(int i = 0; i < n; ++i) {
+          qr[i] += nu*g[i];
+        }
+      }
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        qr[i] = std::exp(std::min(qr[i], maxExponent))*fac[i];
+      }
+      multiplyConcentrations(
+        n, table.productOffset[r], table.productOffset[r+1],
+        &table.productSpecies[0], &table.productCoeff[0], C, qr
+      );
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        qf[i] -= qr[i];
+      }
+    }
+
+    for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+      int const s = table.netSpecies[j];
+      double const Wnu = table.W[s]*table.netCoeff[j];
+      double * omegas = &omega[s*B];
+      FLAME_SIMD_LOOP
+      for(int i = 0; i < n; ++i) {
+        omegas[i] += Wnu*qf[i];
+      }
+    }
+  }
+}
+
+namespace {
+
+// Product P of the concentrations C of the species [begin, end) of a reaction
+// raised to their stoichiometric coefficients, and the derivatives dP[j-begin]
+// of P with respect to the concentration of entry j.
+double concentrationProduct(
+  int const begin, int const end,
+  int const * species, double const * coeff, double const * C, double * dP
+) {
+  double p[FLAME_MAX_REACTION_SPECIES];
+  double dp[FLAME_MAX_REACTION_SPECIES];
+  int const n = end-begin;
+
+  for(int j = 0; j < n; ++j) {
+    double const c = C[species[begin+j]];
+    double const nu = coeff[begin+j];
+    if(nu == 1.0) {
+      p[j] = c;
+      dp[j] = 1.0;
+    } else if(nu == 2.0) {
+      p[j] = c*c;
+      dp[j] = 2.0*c;
+    } else {
+      p[j] = std::pow(c, nu);
+      dp[j] = nu*std::pow(c, nu-1.0);
+    }
+  }
+
+  double P = 1.0;
+  for(int j = 0; j < n; ++j) {
+    P *= p[j];
+    dP[j] = dp[j];
+    for(int i = 0; i < n; ++i) {
+      if(i != j) {
+        dP[j] *= p[i];
+      }
+    }
+  }
+  return P;
+}
+
+// Molar rates of kineticsMolarRates with the derivatives added to the rows of
+// jacobian, if it is not nullptr.
+template<class Jacobian>
+void molarRates(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, Jacobian const * jacobian
+) {
+  int const Ns = table.nSpecies;
+  int const Nr = table.nReactions;
+  double const ln10 = std::log(10.0);
+  double const maxExponent = 600.0;
+
+  double const rT = 1.0/T;
+  double const lnT = std::log(T);
+  double const lnPRT = table.lnPstdByRuniv-lnT;
+
+  double Cc[FLAME_MAX_NSPECIES];
+  double gRT[FLAME_MAX_NSPECIES];
+  double dgRT[FLAME_MAX_NSPECIES];
+  double dPf[FLAME_MAX_REACTION_SPECIES];
+  double dPr[FLAME_MAX_REACTION_SPECIES];
+
+  double Ctot = 0.0;
+  for(int s = 0; s < Ns; ++s) {
+    Cc[s] = std::max(0.0, C[s]);
+    Ctot += Cc[s];
+    wdot[s] = 0.0;
+  }
+
+  // Dimensionless Gibbs energies and their temperature derivatives.
+  if(table.hasReversible) {
+    for(int s = 0; s < Ns; ++s) {
+      int const k = T < table.tMid[s] ? 0 : 1;
+      double const * c = &table.gibbsCoefficients[(2*s+k)*FLAME_KINETICS_NCOEFF];
+      gRT[s] =
+        (c[0]*rT+c[1]*lnT+c[3])*rT+c[2]*lnT+c[4]+
+        T*(c[5]+T*(c[6]+T*(c[7]+T*c[8])));
+      dgRT[s] =
+        ((-2.0*c[0]*rT+c[1]*(1.0-lnT)-c[3])*rT+c[2])*rT+
+        c[5]+T*(2.0*c[6]+T*(3.0*c[7]+T*4.0*c[8]));
+    }
+  }
+
+  for(int r = 0; r < Nr; ++r) {
+    int const type = table.type[r];
+    double const x = table.lnA[r]+table.b[r]*lnT-table.Ta[r]*rT;
+    double const dxdT = (table.b[r]+table.Ta[r]*rT)*rT;
+    double const kf = std::exp(x);
+
+    // Factor of the rate from the third body or falloff, and its derivatives
+    // with respect to M and T.
+    double fac = 1.0, dfacdM = 0.0, dfacdT = 0.0;
+
+    if(type != KINETICS_ELEMENTARY) {
+      double M = Ctot;
+      for(int j = table.efficiencyOffset[r]; j < table.efficiencyOffset[r+1]; ++j) {
+        M += table.efficiency[j]*Cc[table.efficiencySpecies[j]];
+      }
+
+      if(type == KINETICS_THIRD_BODY) {
+        fac = M;
+        dfacdM = 1.0;
+      } else {
+        double const x0 = table.lnA0[r]+table.b0[r]*lnT-table.Ta0[r]*rT;
+        double const dx0dT = (table.b0[r]+table.Ta0[r]*rT)*rT;
+        double const ratio = std::exp(x0-x);
+        double const Pr = ratio*M;
+
+        double dfacdPr;
+        if(type == KINETICS_LINDEMANN) {
+          fac = Pr/(1.0+Pr);
+          dfacdPr = 1.0/((1.0+Pr)*(1.0+Pr));
+        } else {
+          double const * t = &table.troe[6*r];
+          double const e1 = t[0]*std::exp(-T*t[1]);
+          double const e2 = t[2]*std::exp(-T*t[3]);
+          double const e3 = t[4]*std::exp(-t[5]*rT);
+          double const Fcent = std::max(e1+e2+e3, 1.0e-300);
+          double const dFcentdT = -t[1]*e1-t[3]*e2+t[5]*rT*rT*e3;
+
+          double const L = std::log10(Fcent);
+          double const logPr = std::log10(std::max(Pr, 1.0e-300));
+          double const a = logPr-0.4-0.67*L;
+          double const d = 0.75-1.27*L-0.14*a;
+          double const f = a/d;
+          double const g = 1.0/(1.0+f*f);
+          double const F = std::exp(ln10*L*g);
+
+          // Derivatives of log10(F) with respect to log10(Pr) and log10(Fcent).
+          double const dlogFdlogPr = -2.0*L*f*g*g*(0.75-1.27*L)/(d*d);
+          double const dlogFdL = g-2.0*L*f*g*g*(-0.67*d+1.1762*a)/(d*d);
+
+          fac = Pr/(1.0+Pr)*F;
+          dfacdPr = F/((1.0+Pr)*(1.0+Pr))+F*dlogFdlogPr/(1.0+Pr);
+          dfacdT = fac*dlogFdL*dFcentdT/Fcent;
+        }
+
+        dfacdM = dfacdPr*ratio;
+        dfacdT += dfacdPr*Pr*(dx0dT-dxdT);
+      }
+    }
+
+    double const Pf = concentrationProduct(
+      table.reactantOffset[r], table.reactantOffset[r+1],
+      &table.reactantSpecies[0], &table.reactantCoeff[0], Cc, dPf
+    );
+    double q0 = kf*Pf;
+    double dq0dT = kf*dxdT*Pf;
+
+    double kr = 0.0;
+    if(table.reversible[r]) {
+      double xr = x-table.dNu[r]*lnPRT;
+      double dxrdT = dxdT+table.dNu[r]*rT;
+      for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+        double const nu = table.netCoeff[j];
+        xr += nu*gRT[table.netSpecies[j]];
+        dxrdT += nu*dgRT[table.netSpecies[j]];
+      }
+      if(xr > maxExponent) {
+        xr = maxExponent;
+        dxrdT = 0.0;
+      }
+      kr = std::exp(xr);
+
+      double const Pr = concentrationProduct(
+        table.productOffset[r], table.productOffset[r+1],
+        &table.productSpecies[0], &table.productCoeff[0], Cc, dPr
+      );
+      q0 -= kr*Pr;
+      dq0dT -= kr*dxrdT*Pr;
+    }
+
+    double const q = fac*q0;
+    double const dqdT = fac*dq0dT+q0*dfacdT;
+
+    for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+      int const s = table.netSpecies[j];
+      double const nu = table.netCoeff[j];
+      wdot[s] += nu*q;
+
+      if(jacobian == nullptr) {
+        continue;
+      }
+
+      typename Jacobian::Row const Js = jacobian->row(s);
+      Js[Ns] += nu*dqdT;
+
+      double const a = nu*fac;
+      for(int i = table.reactantOffset[r]; i < table.reactantOffset[r+1]; ++i) {
+        Js[table.reactantSpecies[i]] += a*kf*dPf[i-table.reactantOffset[r]];
+      }
+      if(table.reversible[r]) {
+        for(int i = table.productOffset[r]; i < table.productOffset[r+1]; ++i) {
+          Js[table.productSpecies[i]] -= a*kr*dPr[i-table.productOffset[r]];
+        }
+      }
+
+      if(type != KINETICS_ELEMENTARY) {
+        double const b = nu*q0*dfacdM;
+        for(int k = 0; k < Ns; ++k) {
+          Js[k] += b;
+        }
+        for(int i = table.efficiencyOffset[r]; i < table.efficiencyOffset[r+1]; ++i) {
+          Js[table.efficiencySpecies[i]] += b*table.efficiency[i];
+        }
+      }
+    }
+  }
+}
+
+} // end: namespace
+
+void kineticsMolarRates(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, double * J, int const ldJ
+) {
+  if(table.compiled != nullptr) {
+    table.compiled->molarRates(table, C, T, wdot, J, ldJ);
+    return;
+  }
+
+  if(J == nullptr) {
+    molarRates<DenseJacobian>(table, C, T, wdot, nullptr);
+    return;
+  }
+  int const Ns = table.nSpecies;
+  for(int s = 0; s < Ns; ++s) {
+    std::fill(J+s*ldJ, J+s*ldJ+Ns+1, 0.0);
+  }
+  DenseJacobian const jacobian = {J, ldJ};
+  molarRates(table, C, T, wdot, &jacobian);
+}
+
+void kineticsMolarRatesSparse(
+  KineticsTable const & table, double const * C, double const T,
+  double * wdot, double * J, int const * position, int const nonzeros
+) {
+  if(table.compiled != nullptr) {
+    table.compiled->molarRatesSparse(table, C, T, wdot, J, position, nonzeros);
+    return;
+  }
+
+  if(J == nullptr) {
+    molarRates<SparseJacobian>(table, C, T, wdot, nullptr);
+    return;
+  }
+  std::fill(J, J+nonzeros, 0.0);
+  SparseJacobian const jacobian = {J, position, table.nSpecies+1};
+  molarRates(table, C, T, wdot, &jacobian);
+}
+
+void kineticsJacobianPattern(KineticsTable const & table, std::vector<char> & pattern) {
+  int const Ns = table.nSpecies;
+  int const n = Ns+1;
+  pattern.assign(n*n, 0);
+
+  for(int r = 0; r < table.nReactions; ++r) {
+    for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+      char * row = &pattern[table.netSpecies[j]*n];
+      row[Ns] = 1;
+      for(int i = table.reactantOffset[r]; i < table.reactantOffset[r+1]; ++i) {
+        row[table.reactantSpecies[i]] = 1;
+      }
+      if(table.reversible[r]) {
+        for(int i = table.productOffset[r]; i < table.productOffset[r+1]; ++i) {
+          row[table.productSpecies[i]] = 1;
+        }
+      }
+
+      // The third-body concentration depends on every species.
+      if(table.type[r] != KINETICS_ELEMENTARY) {
+        for(int k = 0; k < Ns; ++k) {
+          row[k] = 1;
+        }
+      }
+    }
+  }
+}
+
+} // end: namespace flame
@@ -0,0 +1,79 @@
+#include <kinetics_registry.hh>
+
+#include <vector>
+
+namespace flame {
+
+CompiledMechanismList::Item * CompiledMechanismList::items = nullptr;
+
+CompiledMechanism const * CompiledMechanismList::find(std::uint64_t const hash) {
+  for(Item const * p = items; p != nullptr; p = p->next) {
+    if(p->entry.hash == hash) {
+      return &p->entry;
+    }
+  }
+  return nullptr;
+}
+
+std::string CompiledMechanismList::names() {
+  std::string result;
+  for(Item const * p = items; p != nullptr; p = p->next) {
+    if(!result.empty()) {
+      result += ", ";
+    }
+    result += p->entry.name;
+  }
+  return result;
+}
+
+namespace {
+
+// 64-bit FNV-1a hash of bytes, continued from h.
+std::uint64_t hashBytes(std::uint64_t h, void const * data, std::size_t size) {
+  unsigned char const * p = static_cast<unsigned char const *>(data);
+  for(std::size_t i = 0; i < size; ++i) {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+template<typename T>
+std::uint64_t hashVector(std::uint64_t h, std::vector<T> const & v) {
+  std::uint64_t const size = v.size();
+  h = hashBytes(h, &size, sizeof(size));
+  return v.empty() ? h : hashBytes(h, &v[0], sizeof(T)*v.size());
+}
+
+} // end: namespace
+
+std::uint64_t kineticsTableHash(KineticsTable const & table) {
+  std::uint64_t h = 14695981039346656037ull;
+  h = hashBytes(h, &table.nSpecies, sizeof(table.nSpecies));
+  h = hashBytes(h, &table.nReactions, sizeof(table.nReactions));
+  h = hashBytes(h, &table.Runiv, sizeof(table.Runiv));
+  h = hashVector(h, table.W);
+  h = hashVector(h, table.tMid);
+  h = hashVector(h, table.gibbsCoefficients);
+  h = hashVector(h, table.type);
+  h = hashVector(h, table.reversible);
+  h = hashVector(h, table.lnA);
+  h = hashVector(h, table.b);
+  h = hashVector(h, table.Ta);
+  h = hashVector(h, table.lnA0);
+  h = hashVector(h, table.b0);
+  h = hashVector(h, table.Ta0);
+  h = hashVector(h, table.troe);
+  h = hashVector(h, table.reactantOffset);
+  h = hashVector(h, table.reactantSpecies);
+  h = hashVector(h, table.reactantCoeff);
+  h = hashVector(h, table.productOffset);
+  h = hashVector(h, table.productSpecies);
+  h = hashVector(h, table.productCoeff);
+  h = hashVector(h, table.efficiencyOffset);
+  h = hashVector(h, table.efficiencySpecies);
+  h = hashVector(h, table.efficiency);
+  return h;
+}
+
+} // end: namespace flame
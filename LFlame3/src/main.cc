@@ -3,6 +3,8 @@
 #include <utils.hh>
 #include <plot.hh>
 #include <boundary_checker.hh>
+#include <grid_post_processor.hh>
+#include <grid_renumbering.hh>
 #include <signal_handler.hh>
 
 #include <iostream>
@@ -172,6 +174,39 @@ int main(int argc, char * argv[]) {
     }
   }
   
+  // Partition the cells with the weights of the chemistry cost written at the
+  // restart in the initial conditions directory.
+  if(arg.icDirectory.size() > 0) {
+    bool weighted = false;
+    Loci::storeRepP wp = facts.get_variable("chemistryWeightedPartition");
+    if(wp != 0 && wp->RepType() == Loci::PARAMETER) {
+      param<bool> chemistryWeightedPartition;
+      chemistryWeightedPartition.setRep(wp);
+      weighted = *chemistryWeightedPartition;
+    }
+  
+    if(weighted) {
+      std::string const name = "/chemistryCost_" + arg.caseName;
+      std::string filename = std::string("restart/") + arg.icDirectory + name;
+      struct stat statbuf;
+      if(stat(filename.c_str(), &statbuf)) {
+        filename = arg.icDirectory + name;
+      }
+  
+      if(stat(filename.c_str(), &statbuf) == 0) {
+        Loci::load_cell_weights = true;
+        Loci::cell_weight_file = filename;
+        if(Loci::MPI_rank == 0) {
+          LOG(INFO) << "Partitioning with cell weights of \"" << filename
+            << "\"";
+        }
+      } else if(Loci::MPI_rank == 0) {
+        LOG(WARNING) << "No chemistry cost in \"" << arg.icDirectory
+          << "\", partitioning without cell weights";
+      }
+    }
+  }
+  
   // Read grid file
   {
     std::stringstream ss;
@@ -207,9 +242,21 @@ int main(int argc, char * argv[]) {
     Loci::Abort();
   }
   
+  // Renumber cells and faces for locality of face loops.
+  flame::renumberGrid(facts);
+  
   Loci::setupBoundaryConditions(facts);
   Loci::createLowerUpper(facts);
   
+  // Run the registered grid post processors.
+  {
+    flame::GridPostProcessorList::Item * p = flame::GridPostProcessorList::items;
+    while(p != nullptr) {
+      p->entry->processData(facts, rdb);
+      p = p->next;
+    }
+  }
+  
   // Check for initial conditions directory and create necessary facts.
   if(arg.icDirectory.size() > 0) {
     std::string icDirectory = arg.icDirectory;
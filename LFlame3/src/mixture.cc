@@ -3,6 +3,7 @@
 #include <libxml/SAX.h>
 #include <libxml/xmlschemas.h>
 
+#include <cstdlib>
 #include <cstring>
 
 #include <sys/stat.h>
@@ -69,11 +70,30 @@ char const * getThermochemistryModelName(ThermochemistryModel m) {
   return "";
 }
 
+char const * getFalloffModelName(FalloffModel m) {
+  switch(m) {
+  case FALLOFF_LINDEMANN:
+    return "lindemann";
+    break;
+  case FALLOFF_TROE:
+    return "troe";
+    break;
+  case FALLOFF_NONE:
+    return "none";
+    break;
+  }
+  return "";
+}
+
 void Mixture::clear() {
   nSpecies = 0;
   for(int i = 0; i < FLAME_MAX_NSPECIES; ++i) {
     clearSpecies(i);
   }
+  nReactions = 0;
+  for(int i = 0; i < FLAME_MAX_NREACTIONS; ++i) {
+    clearReaction(i);
+  }
 }
 
 void Mixture::clearSpecies(int idx) {
@@ -133,6 +153,41 @@ void Mixture::clearSpecies(int idx) {
   hasNasa9Thermochemistry[idx] = 0;
 }
 
+void Mixture::clearReaction(int idx) {
+  Reaction & r = reactions[idx];
+
+  r.nReactants = 0;
+  r.nProducts = 0;
+  for(int i = 0; i < FLAME_MAX_REACTION_SPECIES; ++i) {
+    r.reactantSpecies[i] = 0;
+    r.reactantCoeff[i] = 0.0;
+    r.productSpecies[i] = 0;
+    r.productCoeff[i] = 0.0;
+  }
+
+  r.reversible = 1;
+
+  r.rate.A = 0.0;
+  r.rate.b = 0.0;
+  r.rate.Ea = 0.0;
+
+  r.hasThirdBody = 0;
+  r.nEfficiencies = 0;
+  for(int i = 0; i < FLAME_MAX_REACTION_EFFICIENCIES; ++i) {
+    r.efficiencySpecies[i] = 0;
+    r.efficiency[i] = 0.0;
+  }
+
+  r.falloffModel = FALLOFF_NONE;
+  r.lowPressureRate.A = 0.0;
+  r.lowPressureRate.b = 0.0;
+  r.lowPressureRate.Ea = 0.0;
+  r.nTroe = 0;
+  for(int i = 0; i < 4; ++i) {
+    r.troe[i] = 0.0;
+  }
+}
+
 std::ostream & operator<<(std::ostream & s, Mixture const & mix) {
   s << "mixture: {" << std::endl;
   for(int i = 0; i < mix.nSpecies; ++i) {
@@ -238,6 +293,50 @@ std::ostream & operator<<(std::ostream & s, Mixture const & mix) {
 
     s << "  }" << std::endl;
   }
+  for(int i = 0; i < mix.nReactions; ++i) {
+    Reaction const & r = mix.reactions[i];
+    s << "  reaction: {" << std::endl;
+    s << "    equation: '";
+    for(int j = 0; j < r.nReactants; ++j) {
+      s << (j > 0 ? " + " : "") << r.reactantCoeff[j] << " "
+        << mix.speciesName[r.reactantSpecies[j]];
+    }
+    s << (r.reversible ? " <=> " : " => ");
+    for(int j = 0; j < r.nProducts; ++j) {
+      s << (j > 0 ? " + " : "") << r.productCoeff[j] << " "
+        << mix.speciesName[r.productSpecies[j]];
+    }
+    s << "'" << std::endl;
+    s << "    arrhenius: ("
+      << "A: " << r.rate.A << ", "
+      << "b: " << r.rate.b << ", "
+      << "Ea: " << r.rate.Ea
+      << ")" << std::endl;
+    if(r.hasThirdBody) {
+      s << "    thirdBody: (";
+      for(int j = 0; j < r.nEfficiencies; ++j) {
+        s << (j > 0 ? ", " : "") << mix.speciesName[r.efficiencySpecies[j]]
+          << ": " << r.efficiency[j];
+      }
+      s << ")" << std::endl;
+    }
+    if(r.falloffModel != FALLOFF_NONE) {
+      s << "    falloff: " << getFalloffModelName(r.falloffModel)
+        << "("
+        << "A: " << r.lowPressureRate.A << ", "
+        << "b: " << r.lowPressureRate.b << ", "
+        << "Ea: " << r.lowPressureRate.Ea;
+      if(r.falloffModel == FALLOFF_TROE) {
+        s << ", troe=[";
+        for(int j = 0; j < r.nTroe; ++j) {
+          s << r.troe[j] << " ";
+        }
+        s << "]";
+      }
+      s << ")" << std::endl;
+    }
+    s << "  }" << std::endl;
+  }
   s << "}" << std::endl;
 
   return s;
@@ -280,6 +379,19 @@ enum ParserFSM {
   MIXTURE_SPECIES_THERMOCHEMISTRY_NASA9_POLYNOMIAL,
   MIXTURE_SPECIES_THERMOCHEMISTRY_NASA9_POLYNOMIAL_TEMPERATURE_RANGES,
   MIXTURE_SPECIES_THERMOCHEMISTRY_NASA9_POLYNOMIAL_COEFFICIENTS,
+  MIXTURE_REACTIONS,
+  MIXTURE_REACTIONS_REACTION,
+  MIXTURE_REACTIONS_REACTION_REACTANTS,
+  MIXTURE_REACTIONS_REACTION_PRODUCTS,
+  MIXTURE_REACTIONS_REACTION_ARRHENIUS,
+  MIXTURE_REACTIONS_REACTION_THIRD_BODY,
+  MIXTURE_REACTIONS_REACTION_THIRD_BODY_EFFICIENCIES,
+  MIXTURE_REACTIONS_REACTION_FALLOFF,
+  MIXTURE_REACTIONS_REACTION_FALLOFF_LOW_PRESSURE,
+  MIXTURE_REACTIONS_REACTION_FALLOFF_TROE,
+  ARRHENIUS_PRE_EXPONENTIAL_FACTOR,
+  ARRHENIUS_TEMPERATURE_EXPONENT,
+  ARRHENIUS_ACTIVATION_ENERGY,
   ParserFSM_NONE
 };
 
@@ -292,6 +404,64 @@ class MixtureParserData {
   std::string charData;
   int speciesIndex;
 
+  // Reaction being parsed, the rate constant that the arrhenius elements are
+  // read into and the factor converting the activation energy to J/kmol.
+  Reaction reaction;
+  ArrheniusRate * rate;
+  double energyFactor;
+
+  // First error found in the content, e.g. an unknown species in a reaction.
+  std::string error;
+
+  void setError(std::string const & msg) {
+    if(error.empty()) {
+      error = msg;
+    }
+  }
+
+  int findSpecies(std::string const & name) const {
+    for(int i = 0; i < mixture.nSpecies; ++i) {
+      if(name == mixture.speciesName[i]) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Parses a list of species, NAME or NAME:value separated by spaces, into
+  // species indices and values. The value of a species without one is 1.
+  int parseSpeciesList(
+    std::string const & list, int const maxCount, int * species, double * values
+  ) {
+    std::stringstream ss(list);
+    std::string token;
+    int count = 0;
+    while(ss >> token) {
+      std::string::size_type const colon = token.find(':');
+      std::string const name = token.substr(0, colon);
+      double value = 1.0;
+      if(colon != std::string::npos) {
+        value = std::atof(token.c_str()+colon+1);
+      }
+
+      int const idx = findSpecies(name);
+      if(idx < 0) {
+        setError("reaction[" + std::to_string(mixture.nReactions) +
+          "] references unknown species '" + name + "'");
+        continue;
+      }
+      if(count == maxCount) {
+        setError("reaction[" + std::to_string(mixture.nReactions) +
+          "] has more than " + std::to_string(maxCount) + " species in a list");
+        break;
+      }
+      species[count] = idx;
+      values[count] = value;
+      ++count;
+    }
+    return count;
+  }
+
 public:
   MixtureParserData() {
     init();
@@ -301,12 +471,19 @@ public:
     return mixture;
   }
 
+  std::string const & getError() const {
+    return error;
+  }
+
   void init() {
     elementStack.clear();
     fsm = std::stack<ParserFSM>();
     mixture.clear();
     charData.clear();
     speciesIndex = -1;
+    rate = nullptr;
+    energyFactor = 1.0;
+    error.clear();
   }
 
   void pushElement(Element const & elem) {
@@ -383,6 +560,62 @@ public:
     } else if(path == "/mixture/species/thermochemistry/NASA9Polynomial/coefficients") {
       fsm.push(MIXTURE_SPECIES_THERMOCHEMISTRY_NASA9_POLYNOMIAL_COEFFICIENTS);
       charData.clear();
+    } else if(path == "/mixture/reactions") {
+      fsm.push(MIXTURE_REACTIONS);
+    } else if(path == "/mixture/reactions/reaction") {
+      fsm.push(MIXTURE_REACTIONS_REACTION);
+      std::memset(&reaction, 0, sizeof(reaction));
+      reaction.reversible = 1;
+      reaction.falloffModel = FALLOFF_NONE;
+      for(auto const & a : elem.attributes) {
+        if(a.name == "reversible") {
+          reaction.reversible = (a.value == "true" || a.value == "1") ? 1 : 0;
+        }
+      }
+    } else if(path == "/mixture/reactions/reaction/reactants") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_REACTANTS);
+      charData.clear();
+    } else if(path == "/mixture/reactions/reaction/products") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_PRODUCTS);
+      charData.clear();
+    } else if(path == "/mixture/reactions/reaction/arrhenius") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_ARRHENIUS);
+      rate = &reaction.rate;
+    } else if(path == "/mixture/reactions/reaction/thirdBody") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_THIRD_BODY);
+    } else if(path == "/mixture/reactions/reaction/thirdBody/efficiencies") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_THIRD_BODY_EFFICIENCIES);
+      charData.clear();
+    } else if(path == "/mixture/reactions/reaction/falloff") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_FALLOFF);
+    } else if(path == "/mixture/reactions/reaction/falloff/lowPressure") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_FALLOFF_LOW_PRESSURE);
+      rate = &reaction.lowPressureRate;
+    } else if(path == "/mixture/reactions/reaction/falloff/troe") {
+      fsm.push(MIXTURE_REACTIONS_REACTION_FALLOFF_TROE);
+      charData.clear();
+    } else if(path == "/mixture/reactions/reaction/arrhenius/preExponentialFactor" ||
+              path == "/mixture/reactions/reaction/falloff/lowPressure/preExponentialFactor") {
+      fsm.push(ARRHENIUS_PRE_EXPONENTIAL_FACTOR);
+      charData.clear();
+    } else if(path == "/mixture/reactions/reaction/arrhenius/temperatureExponent" ||
+              path == "/mixture/reactions/reaction/falloff/lowPressure/temperatureExponent") {
+      fsm.push(ARRHENIUS_TEMPERATURE_EXPONENT);
+      charData.clear();
+    } else if(path == "/mixture/reactions/reaction/arrhenius/activationEnergy" ||
+              path == "/mixture/reactions/reaction/falloff/lowPressure/activationEnergy") {
+      fsm.push(ARRHENIUS_ACTIVATION_ENERGY);
+      charData.clear();
+      energyFactor = 1.0;
+      for(auto const & a : elem.attributes) {
+        if(a.name == "unit") {
+          if(a.value == "J/mol") {
+            energyFactor = 1.0e3;
+          } else if(a.value == "cal/mol") {
+            energyFactor = 4184.0;
+          }
+        }
+      }
     } else {
       std::cerr << "Unprocessed path: " << path << std::endl;
     }
@@ -505,6 +738,60 @@ public:
         mixture.nasa9Thermochemistry[speciesIndex].sCoeff[j+8] = mixture.nasa9Thermochemistry[speciesIndex].cpCoeff[j+8];
       }
       break;
+    case MIXTURE_REACTIONS:
+      break;
+    case MIXTURE_REACTIONS_REACTION:
+      if(mixture.nReactions < FLAME_MAX_NREACTIONS) {
+        mixture.reactions[mixture.nReactions] = reaction;
+        mixture.nReactions++;
+      } else {
+        setError("number of reactions exceeds FLAME_MAX_NREACTIONS = " +
+          std::to_string(FLAME_MAX_NREACTIONS));
+      }
+      break;
+    case MIXTURE_REACTIONS_REACTION_REACTANTS:
+      reaction.nReactants = parseSpeciesList(
+        charData, FLAME_MAX_REACTION_SPECIES,
+        reaction.reactantSpecies, reaction.reactantCoeff
+      );
+      break;
+    case MIXTURE_REACTIONS_REACTION_PRODUCTS:
+      reaction.nProducts = parseSpeciesList(
+        charData, FLAME_MAX_REACTION_SPECIES,
+        reaction.productSpecies, reaction.productCoeff
+      );
+      break;
+    case MIXTURE_REACTIONS_REACTION_ARRHENIUS:
+      break;
+    case MIXTURE_REACTIONS_REACTION_THIRD_BODY:
+      reaction.hasThirdBody = 1;
+      break;
+    case MIXTURE_REACTIONS_REACTION_THIRD_BODY_EFFICIENCIES:
+      reaction.nEfficiencies = parseSpeciesList(
+        charData, FLAME_MAX_REACTION_EFFICIENCIES,
+        reaction.efficiencySpecies, reaction.efficiency
+      );
+      break;
+    case MIXTURE_REACTIONS_REACTION_FALLOFF:
+      reaction.falloffModel = reaction.nTroe > 0 ? FALLOFF_TROE : FALLOFF_LINDEMANN;
+      break;
+    case MIXTURE_REACTIONS_REACTION_FALLOFF_LOW_PRESSURE:
+      break;
+    case MIXTURE_REACTIONS_REACTION_FALLOFF_TROE:
+      while(reaction.nTroe < 4 && ss >> reaction.troe[reaction.nTroe]) {
+        reaction.nTroe++;
+      }
+      break;
+    case ARRHENIUS_PRE_EXPONENTIAL_FACTOR:
+      ss >> rate->A;
+      break;
+    case ARRHENIUS_TEMPERATURE_EXPONENT:
+      ss >> rate->b;
+      break;
+    case ARRHENIUS_ACTIVATION_ENERGY:
+      ss >> rate->Ea;
+      rate->Ea *= energyFactor;
+      break;
     }
 
     elementStack.pop_back();
@@ -576,6 +863,39 @@ public:
     case MIXTURE_SPECIES_THERMOCHEMISTRY_NASA9_POLYNOMIAL_COEFFICIENTS:
       charData += value;
       break;
+    case MIXTURE_REACTIONS:
+      break;
+    case MIXTURE_REACTIONS_REACTION:
+      break;
+    case MIXTURE_REACTIONS_REACTION_REACTANTS:
+      charData += value;
+      break;
+    case MIXTURE_REACTIONS_REACTION_PRODUCTS:
+      charData += value;
+      break;
+    case MIXTURE_REACTIONS_REACTION_ARRHENIUS:
+      break;
+    case MIXTURE_REACTIONS_REACTION_THIRD_BODY:
+      break;
+    case MIXTURE_REACTIONS_REACTION_THIRD_BODY_EFFICIENCIES:
+      charData += value;
+      break;
+    case MIXTURE_REACTIONS_REACTION_FALLOFF:
+      break;
+    case MIXTURE_REACTIONS_REACTION_FALLOFF_LOW_PRESSURE:
+      break;
+    case MIXTURE_REACTIONS_REACTION_FALLOFF_TROE:
+      charData += value;
+      break;
+    case ARRHENIUS_PRE_EXPONENTIAL_FACTOR:
+      charData += value;
+      break;
+    case ARRHENIUS_TEMPERATURE_EXPONENT:
+      charData += value;
+      break;
+    case ARRHENIUS_ACTIVATION_ENERGY:
+      charData += value;
+      break;
     }
   }
 };
@@ -778,7 +1098,10 @@ int parseFromXML(
     xmlSchemaSetValidErrors(validSchema, schemaErrorHandler, schemaWarningHandler, NULL);
     xmlSchemaValidateSetFilename(validSchema, mixtureFile.c_str());
     int ret = xmlSchemaValidateStream(validSchema, buffer, XML_CHAR_ENCODING_NONE, &handler, (void *)parserData);
-    if(ret == 0) {
+    if(ret == 0 && !parserData->getError().empty()) {
+      msg << mixtureFile << ": " << parserData->getError();
+      throw 12;
+    } else if(ret == 0) {
       mixture = parserData->getMixture();
     } else if (ret > 0) {
       msg << mixtureFile << " fails to validate";
@@ -0,0 +1,400 @@
+#include <nasa9.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace flame {
+
+void nasa9_sCp_sH_from_T(
+  int const Ns, double * sCp, double * sH,
+  NASA9Thermochemistry const * thermo, double const * sR, double const T
+) {
+  double const rT = 1.0/T;
+  double const lnT = std::log(T);
+  
+  for(int s = 0; s < Ns; ++s) {
+    int const k = T < thermo[s].tRange[1] ? 0 : 9;
+    double const * a = &thermo[s].cpCoeff[k];
+    double const * b = &thermo[s].hCoeff[k];
+    
+    sCp[s] = sR[s]*(
+      (a[0]*rT+a[1])*rT+a[2]+T*(a[3]+T*(a[4]+T*(a[5]+T*a[6])))
+    );
+    sH[s] = sR[s]*(
+      b[0]*rT+b[1]*lnT+b[7]+T*(b[2]+T*(b[3]+T*(b[4]+T*(b[5]+T*b[6]))))
+    );
+  }
+}
+
+void nasa9_sS_from_T(
+  int const Ns, double * sS,
+  NASA9Thermochemistry const * thermo, double const * sR, double const T
+) {
+  double const rT = 1.0/T;
+  double const lnT = std::log(T);
+  
+  for(int s = 0; s < Ns; ++s) {
+    int const k = T < thermo[s].tRange[1] ? 0 : 9;
+    double const * c = &thermo[s].sCoeff[k];
+    
+    sS[s] = sR[s]*(
+      (c[0]*rT+c[1])*rT+c[2]*lnT+c[8]+T*(c[3]+T*(c[4]+T*(c[5]+T*c[6])))
+    );
+  }
+}
+
+void initNASA9Table(
+  NASA9Table & table, int const Ns,
+  NASA9Thermochemistry const * thermo, double const * sR
+) {
+  table.nSpecies = Ns;
+  table.tMin = thermo[0].tRange[0];
+  table.tMax = thermo[0].tRange[2];
+  table.tMid.resize(Ns);
+  table.coefficients.resize(2*Ns*FLAME_NASA9_NCOEFF);
+  
+  for(int s = 0; s < Ns; ++s) {
+    table.tMin = std::max(table.tMin, thermo[s].tRange[0]);
+    table.tMax = std::min(table.tMax, thermo[s].tRange[2]);
+    table.tMid[s] = thermo[s].tRange[1];
+    
+    for(int k = 0; k < 2; ++k) {
+      double const * a = &thermo[s].cpCoeff[9*k];
+      double const * b = &thermo[s].hCoeff[9*k];
+      double * c = &table.coefficients[(2*s+k)*FLAME_NASA9_NCOEFF];
+      
+      for(int j = 0; j < 7; ++j) {
+        c[j] = sR[s]*a[j];
+      }
+      for(int j = 0; j < 8; ++j) {
+        c[7+j] = sR[s]*b[j];
+      }
+    }
+  }
+}
+
+namespace {
+
+// Specific heat sCp and specific enthalpy sH of one species at the temperatures
+// T of n cells, with rT = 1/T and lnT = ln(T). The species contributions, with
+// mass fractions Y, are added to the mixture specific heat cp and enthalpy h.
+// The coefficients c of the lower and upper range are blended with a weight of
+// 1 or 0, so that the loop over cells has no branches.
+void addSpeciesCpEnthalpy(
+  int const n, double const tMid, double const * c,
+  double const * Y, double const * T, double const * rT, double const * lnT,
+  double * sCp, double * sH, double * cp, double * h
+) {
+  double const * c0 = c;
+  double const * c1 = c+FLAME_NASA9_NCOEFF;
+  
+  FLAME_SIMD_LOOP
+  for(int i = 0; i < n; ++i) {
+    double const t = T[i];
+    double const w = t < tMid ? 1.0 : 0.0;
+    
+    double const cps =
+      ((c1[0]+w*(c0[0]-c1[0]))*rT[i]+(c1[1]+w*(c0[1]-c1[1])))*rT[i]+
+      (c1[2]+w*(c0[2]-c1[2]))+t*((c1[3]+w*(c0[3]-c1[3]))+
+      t*((c1[4]+w*(c0[4]-c1[4]))+t*((c1[5]+w*(c0[5]-c1[5]))+
+      t*(c1[6]+w*(c0[6]-c1[6])))));
+    double const hs =
+      (c1[7]+w*(c0[7]-c1[7]))*rT[i]+(c1[8]+w*(c0[8]-c1[8]))*lnT[i]+
+      (c1[14]+w*(c0[14]-c1[14]))+t*((c1[9]+w*(c0[9]-c1[9]))+
+      t*((c1[10]+w*(c0[10]-c1[10]))+t*((c1[11]+w*(c0[11]-c1[11]))+
+      t*((c1[12]+w*(c0[12]-c1[12]))+t*(c1[13]+w*(c0[13]-c1[13]))))));
+    
+    sCp[i] = cps;
+    sH[i] = hs;
+    cp[i] += Y[i]*cps;
+    h[i] += Y[i]*hs;
+  }
+}
+
+} // end: namespace
+
+namespace {
+
+// Newton iteration of nasa9TemperatureFromEnergy. evaluate(T, cp, h) computes
+// the species properties at the temperatures T of the cells and the mixture
+// specific heat cp and enthalpy h.
+template<typename Evaluate>
+int temperatureFromEnergy(
+  double const tMin, double const tMax, int const n,
+  double const * e, double const * R, double * T, Evaluate const & evaluate,
+  NASA9TemperatureStatus * status
+) {
+  alignas(FLAME_SIMD_ALIGN) double cp[FLAME_NASA9_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) double h[FLAME_NASA9_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) double Tn[FLAME_NASA9_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) double step[FLAME_NASA9_BLOCK_SIZE];
+  
+  // Whether the Newton update of a cell in the last iteration was limited or
+  // not a number, and whether the cell has converged.
+  bool limited[FLAME_NASA9_BLOCK_SIZE];
+  bool invalid[FLAME_NASA9_BLOCK_SIZE];
+  bool cellConverged[FLAME_NASA9_BLOCK_SIZE];
+  
+  FLAME_SIMD_LOOP
+  for(int i = 0; i < n; ++i) {
+    T[i] = std::min(tMax, std::max(tMin, T[i]));
+    step[i] = tMax;
+  }
+  
+  int iter = 0;
+  bool converged = false;
+  for(;;) {
+    evaluate(T, cp, h);
+    
+    // Newton update with de/dT = cv = cp-R, limited to [tMin, tMax].
+    FLAME_SIMD_LOOP
+    for(int i = 0; i < n; ++i) {
+      double const f = h[i]-R[i]*T[i]-e[i];
+      double const t = T[i]-f/(cp[i]-R[i]);
+      Tn[i] = std::min(tMax, std::max(tMin, t));
+      limited[i] = t < tMin || t > tMax;
+      invalid[i] = t != t;
+    }
+    
+    // The polynomials of the two ranges do not match exactly at the range
+    // boundary, so the iteration may oscillate about the boundary with a small
+    // amplitude instead of converging. Away from the boundary a step below the
+    // square root of the tolerance is followed by one below the tolerance, so
+    // the iteration is also stopped after two successive steps below the square
+    // root of the tolerance.
+    double const stall = std::sqrt(FLAME_NASA9_TOLERANCE);
+    converged = true;
+    for(int i = 0; i < n; ++i) {
+      double const s = std::fabs(Tn[i]-T[i]);
+      cellConverged[i] = !invalid[i] && (
+        s <= FLAME_NASA9_TOLERANCE*T[i] || (s <= stall*T[i] && step[i] <= stall*T[i])
+      );
+      converged = converged && cellConverged[i];
+      step[i] = s;
+    }
+    
+    // The species properties are those of T, so T is not updated once the
+    // iteration has converged.
+    if(converged || iter == FLAME_NASA9_MAX_ITERATIONS) {
+      break;
+    }
+    
+    FLAME_SIMD_LOOP
+    for(int i = 0; i < n; ++i) {
+      T[i] = Tn[i];
+    }
+    ++iter;
+  }
+  
+  if(status) {
+    for(int i = 0; i < n; ++i) {
+      status[i] = !cellConverged[i] ? NASA9_TEMPERATURE_NOT_CONVERGED :
+        limited[i] ? NASA9_TEMPERATURE_LIMITED : NASA9_TEMPERATURE_CONVERGED;
+    }
+  }
+  
+  return converged ? iter : -1;
+}
+
+} // end: namespace
+
+int nasa9TemperatureFromEnergy(
+  NASA9Table const & table, int const n,
+  double const * e, double const * R, double const * Y,
+  double * T, double * sCp, double * sH,
+  NASA9TemperatureStatus * status
+) {
+  int const Ns = table.nSpecies;
+  
+  alignas(FLAME_SIMD_ALIGN) double rT[FLAME_NASA9_BLOCK_SIZE];
+  alignas(FLAME_SIMD_ALIGN) double lnT[FLAME_NASA9_BLOCK_SIZE];
+  
+  auto evaluate = [&](double const * T, double * cp, double * h) {
+    FLAME_SIMD_LOOP
+    for(int i = 0; i < n; ++i) {
+      rT[i] = 1.0/T[i];
+      lnT[i] = std::log(T[i]);
+      cp[i] = 0.0;
+      h[i] = 0.0;
+    }
+    
+    for(int s = 0; s < Ns; ++s) {
+      addSpeciesCpEnthalpy(
+        n, table.tMid[s], &table.coefficients[(2*s)*FLAME_NASA9_NCOEFF],
+        Y+s*FLAME_NASA9_BLOCK_SIZE, T, rT, lnT,
+        sCp+s*FLAME_NASA9_BLOCK_SIZE, sH+s*FLAME_NASA9_BLOCK_SIZE, cp, h
+      );
+    }
+  };
+  
+  return temperatureFromEnergy(table.tMin, table.tMax, n, e, R, T, evaluate, status);
+}
+
+// =============================================================================
+
+double initNASA9LookupTable(
+  NASA9LookupTable & lookup, int const Ns,
+  NASA9Thermochemistry const * thermo, double const * sR,
+  double const dT, NASA9Interpolation const interpolation
+) {
+  int const NV = FLAME_NASA9_LOOKUP_NVALUES;
+  
+  lookup.nSpecies = Ns;
+  lookup.interpolation = interpolation;
+  lookup.tMin = thermo[0].tRange[0];
+  lookup.tMax = thermo[0].tRange[2];
+  for(int s = 0; s < Ns; ++s) {
+    lookup.tMin = std::max(lookup.tMin, thermo[s].tRange[0]);
+    lookup.tMax = std::min(lookup.tMax, thermo[s].tRange[2]);
+  }
+  
+  int const nIntervals = std::max(1, int(std::ceil((lookup.tMax-lookup.tMin)/dT)));
+  lookup.nPoints = nIntervals+1;
+  lookup.dT = (lookup.tMax-lookup.tMin)/nIntervals;
+  lookup.rdT = 1.0/lookup.dT;
+  lookup.values.resize(lookup.nPoints*Ns*NV);
+  
+  std::vector<double> sCp(Ns), sH(Ns), sS(Ns);
+  for(int k = 0; k < lookup.nPoints; ++k) {
+    double const T = k+1 < lookup.nPoints ? lookup.tMin+k*lookup.dT : lookup.tMax;
+    nasa9_sCp_sH_from_T(Ns, &sCp[0], &sH[0], thermo, sR, T);
+    nasa9_sS_from_T(Ns, &sS[0], thermo, sR, T);
+    
+    for(int s = 0; s < Ns; ++s) {
+      int const r = T < thermo[s].tRange[1] ? 0 : 9;
+      double const * a = &thermo[s].cpCoeff[r];
+      double const rT = 1.0/T;
+      double const dcp = sR[s]*(
+        (-2.0*a[0]*rT-a[1])*rT*rT+a[3]+T*(2.0*a[4]+T*(3.0*a[5]+T*4.0*a[6]))
+      );
+      
+      double * v = &lookup.values[(k*Ns+s)*NV];
+      v[0] = sCp[s];
+      v[1] = dcp;
+      v[2] = sH[s];
+      v[3] = sS[s];
+    }
+  }
+  
+  // Interpolation error at the midpoints of the intervals.
+  double error = 0.0;
+  std::vector<double> tCp(Ns), tH(Ns), tS(Ns);
+  for(int k = 0; k < nIntervals; ++k) {
+    double const T = lookup.tMin+(k+0.5)*lookup.dT;
+    nasa9_sCp_sH_from_T(Ns, &sCp[0], &sH[0], thermo, sR, T);
+    nasa9_sS_from_T(Ns, &sS[0], thermo, sR, T);
+    nasa9LookupSpecies(lookup, T, &tCp[0], &tH[0], &tS[0]);
+    
+    for(int s = 0; s < Ns; ++s) {
+      error = std::max(error, std::fabs(tCp[s]-sCp[s])/sCp[s]);
+      error = std::max(error, std::fabs(tH[s]-sH[s])/(sCp[s]*T));
+      error = std::max(error, std::fabs(tS[s]-sS[s])/sCp[s]);
+    }
+  }
+  
+  return error;
+}
+
+namespace {
+
+// Interval k and position x in [0, 1] within the interval of temperature T,
+// which is limited to the range of the table.
+inline
+void lookupInterval(
+  NASA9LookupTable const & lookup, double const T, int & k, double & x
+) {
+  double const t = (std::min(lookup.tMax, std::max(lookup.tMin, T))-lookup.tMin)*lookup.rdT;
+  k = std::min(int(t), lookup.nPoints-2);
+  x = t-k;
+}
+
+} // end: namespace
+
+void nasa9LookupSpecies(
+  NASA9LookupTable const & lookup, double const T,
+  double * sCp, double * sH, double * sS
+) {
+  int const Ns = lookup.nSpecies;
+  int const NV = FLAME_NASA9_LOOKUP_NVALUES;
+  
+  int k;
+  double x;
+  lookupInterval(lookup, T, k, x);
+  
+  double const * v0 = &lookup.values[k*Ns*NV];
+  double const * v1 = v0+Ns*NV;
+  
+  if(lookup.interpolation == NASA9_INTERPOLATION_LINEAR) {
+    for(int s = 0; s < Ns; ++s) {
+      double const * a = v0+s*NV;
+      double const * b = v1+s*NV;
+      sCp[s] = a[0]+x*(b[0]-a[0]);
+      sH[s] = a[2]+x*(b[2]-a[2]);
+      sS[s] = a[3]+x*(b[3]-a[3]);
+    }
+  } else {
+    double const dT = lookup.dT;
+    double const T0 = lookup.tMin+k*dT;
+    double const rT0 = 1.0/T0, rT1 = 1.0/(T0+dT);
+    double const w00 = (1.0+2.0*x)*(1.0-x)*(1.0-x);
+    double const w10 = x*(1.0-x)*(1.0-x)*dT;
+    double const w01 = x*x*(3.0-2.0*x);
+    double const w11 = x*x*(x-1.0)*dT;
+    for(int s = 0; s < Ns; ++s) {
+      double const * a = v0+s*NV;
+      double const * b = v1+s*NV;
+      sCp[s] = w00*a[0]+w10*a[1]+w01*b[0]+w11*b[1];
+      sH[s] = w00*a[2]+w10*a[0]+w01*b[2]+w11*b[0];
+      sS[s] = w00*a[3]+w10*a[0]*rT0+w01*b[3]+w11*b[0]*rT1;
+    }
+  }
+}
+
+int nasa9TemperatureFromEnergy(
+  NASA9LookupTable const & lookup, int const n,
+  double const * e, double const * R, double const * Y,
+  double * T, double * sCp, double * sH,
+  NASA9TemperatureStatus * status
+) {
+  int const Ns = lookup.nSpecies;
+  int const NV = FLAME_NASA9_LOOKUP_NVALUES;
+  int const B = FLAME_NASA9_BLOCK_SIZE;
+  bool const cubic = lookup.interpolation == NASA9_INTERPOLATION_CUBIC;
+  
+  // The species of a cell are interpolated from two contiguous blocks of the
+  // table. The weights of the linear interpolation are those of the cubic one
+  // with the derivative terms dropped.
+  auto evaluate = [&](double const * T, double * cp, double * h) {
+    for(int i = 0; i < n; ++i) {
+      int k;
+      double x;
+      lookupInterval(lookup, T[i], k, x);
+      
+      double const * v0 = &lookup.values[k*Ns*NV];
+      double const * v1 = v0+Ns*NV;
+      double const w00 = cubic ? (1.0+2.0*x)*(1.0-x)*(1.0-x) : 1.0-x;
+      double const w10 = cubic ? x*(1.0-x)*(1.0-x)*lookup.dT : 0.0;
+      double const w01 = cubic ? x*x*(3.0-2.0*x) : x;
+      double const w11 = cubic ? x*x*(x-1.0)*lookup.dT : 0.0;
+      
+      double cpi = 0.0, hi = 0.0;
+      FLAME_SIMD_SUM_LOOP(cpi, hi)
+      for(int s = 0; s < Ns; ++s) {
+        double const * a = v0+s*NV;
+        double const * b = v1+s*NV;
+        double const cps = w00*a[0]+w10*a[1]+w01*b[0]+w11*b[1];
+        double const hs = w00*a[2]+w10*a[0]+w01*b[2]+w11*b[0];
+        sCp[s*B+i] = cps;
+        sH[s*B+i] = hs;
+        cpi += Y[s*B+i]*cps;
+        hi += Y[s*B+i]*hs;
+      }
+      cp[i] = cpi;
+      h[i] = hi;
+    }
+  };
+  
+  return temperatureFromEnergy(lookup.tMin, lookup.tMax, n, e, R, T, evaluate, status);
+}
+
+} // end: namespace flame
@@ -0,0 +1,140 @@
+#include <partition_renumbering.hh>
+
+#include <algorithm>
+
+namespace flame {
+
+int renumberedEntity(
+  std::vector<std::pair<int, int> > const & remap, int const e
+) {
+  std::vector<std::pair<int, int> >::const_iterator it = std::lower_bound(
+    remap.begin(), remap.end(), std::make_pair(e, 0),
+    [](std::pair<int, int> const & a, std::pair<int, int> const & b) {
+      return a.first < b.first;
+    }
+  );
+  return it != remap.end() && it->first == e ? it->second : e;
+}
+
+void invertRenumbering(
+  std::vector<std::pair<int, int> > const & remap,
+  std::vector<std::pair<int, int> > & inverse
+) {
+  inverse.clear();
+  for(std::size_t i = 0; i < remap.size(); ++i) {
+    inverse.push_back(std::make_pair(remap[i].second, remap[i].first));
+  }
+  std::sort(inverse.begin(), inverse.end());
+}
+
+void exchangeRenumbering(
+  std::vector<std::pair<int, int> > const & remap,
+  std::vector<std::vector<int> > const & requests,
+  std::vector<std::vector<int> > & numbers, MPI_Comm comm
+) {
+  int P;
+  MPI_Comm_size(comm, &P);
+
+  std::vector<int> sendCounts(P), sendOffsets(P+1, 0);
+  for(int p = 0; p < P; ++p) {
+    sendCounts[p] = requests[p].size();
+    sendOffsets[p+1] = sendOffsets[p]+sendCounts[p];
+  }
+  std::vector<int> recvCounts(P), recvOffsets(P+1, 0);
+  MPI_Alltoall(&sendCounts[0], 1, MPI_INT, &recvCounts[0], 1, MPI_INT, comm);
+  for(int p = 0; p < P; ++p) {
+    recvOffsets[p+1] = recvOffsets[p]+recvCounts[p];
+  }
+
+  std::vector<int> sent(sendOffsets[P]+1), received(recvOffsets[P]+1);
+  for(int p = 0; p < P; ++p) {
+    std::copy(requests[p].begin(), requests[p].end(), &sent[sendOffsets[p]]);
+  }
+  MPI_Alltoallv(
+    &sent[0], &sendCounts[0], &sendOffsets[0], MPI_INT,
+    &received[0], &recvCounts[0], &recvOffsets[0], MPI_INT, comm
+  );
+
+  // Answer the requests of the other processes in place and send the answers
+  // back the way the requests came.
+  for(int i = 0; i < recvOffsets[P]; ++i) {
+    received[i] = renumberedEntity(remap, received[i]);
+  }
+  MPI_Alltoallv(
+    &received[0], &recvCounts[0], &recvOffsets[0], MPI_INT,
+    &sent[0], &sendCounts[0], &sendOffsets[0], MPI_INT, comm
+  );
+
+  numbers.resize(P);
+  for(int p = 0; p < P; ++p) {
+    numbers[p].assign(&sent[sendOffsets[p]], &sent[sendOffsets[p+1]]);
+  }
+}
+
+void renumberPartition(PartitionRenumbering & renumbering, MPI_Comm comm) {
+  int P, me;
+  MPI_Comm_size(comm, &P);
+  MPI_Comm_rank(comm, &me);
+
+  std::vector<int> const & cells = renumbering.cells;
+  std::vector<int> const & faces = renumbering.faces;
+  std::vector<int> const & left = renumbering.left;
+  std::vector<int> const & right = renumbering.right;
+  std::vector<int> const & leftOwner = renumbering.leftOwner;
+  std::vector<int> const & rightOwner = renumbering.rightOwner;
+  std::vector<std::pair<int, int> > & remap = renumbering.remap;
+  std::vector<std::pair<int, int> > & remoteRemap = renumbering.remoteRemap;
+
+  remap.clear();
+  for(std::size_t k = 0; k < cells.size(); ++k) {
+    remap.push_back(std::make_pair(cells[renumbering.order[k]], cells[k]));
+  }
+  std::sort(remap.begin(), remap.end());
+
+  // New numbers of the cells of other processes on the faces.
+  std::vector<std::vector<int> > requests(P), numbers;
+  for(std::size_t f = 0; f < faces.size(); ++f) {
+    if(leftOwner[f] != me) {
+      requests[leftOwner[f]].push_back(left[f]);
+    }
+    if(rightOwner[f] != me) {
+      requests[rightOwner[f]].push_back(right[f]);
+    }
+  }
+  for(int p = 0; p < P; ++p) {
+    std::sort(requests[p].begin(), requests[p].end());
+    requests[p].erase(
+      std::unique(requests[p].begin(), requests[p].end()), requests[p].end()
+    );
+  }
+  exchangeRenumbering(remap, requests, numbers, comm);
+
+  remoteRemap.clear();
+  for(int p = 0; p < P; ++p) {
+    for(std::size_t i = 0; i < requests[p].size(); ++i) {
+      remoteRemap.push_back(std::make_pair(requests[p][i], numbers[p][i]));
+    }
+  }
+  std::sort(remoteRemap.begin(), remoteRemap.end());
+
+  // Order the faces by the new numbers of their cells.
+  std::vector<std::pair<std::pair<int, int>, int> > faceKeys;
+  for(std::size_t f = 0; f < faces.size(); ++f) {
+    int const l = renumberedEntity(
+      leftOwner[f] == me ? remap : remoteRemap, left[f]
+    );
+    int const r = renumberedEntity(
+      rightOwner[f] == me ? remap : remoteRemap, right[f]
+    );
+    faceKeys.push_back(
+      std::make_pair(std::make_pair(std::min(l, r), std::max(l, r)), faces[f])
+    );
+  }
+  std::sort(faceKeys.begin(), faceKeys.end());
+  for(std::size_t k = 0; k < faces.size(); ++k) {
+    remap.push_back(std::make_pair(faceKeys[k].second, faces[k]));
+  }
+  std::sort(remap.begin(), remap.end());
+}
+
+} // end: namespace flame
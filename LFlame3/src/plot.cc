@@ -1,5 +1,6 @@
 #include <flame.hh>
 #include <plot.hh>
+#include <grid_renumbering.hh>
 
 #include <mpi.h>
 
@@ -615,7 +616,7 @@ void dumpScalar(
   hid_t fileId = Loci::hdf5CreateFile(
     filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT
   );
-  Loci::writeContainer(fileId, sname, c2n.Rep());
+  writeRenumberedContainer(fileId, sname, c2n.Rep());
   Loci::hdf5CloseFile(fileId);
 }
 
@@ -731,7 +732,7 @@ void dumpVector(
   hid_t fileId = Loci::hdf5CreateFile(
     filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT
   );
-  Loci::writeContainer(fileId, sname, c2n.Rep());
+  writeRenumberedContainer(fileId, sname, c2n.Rep());
   Loci::hdf5CloseFile(fileId);
 }
 
@@ -781,7 +782,7 @@ void dumpVar(
   hid_t fileId = Loci::hdf5CreateFile(
     filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT
   );
-  Loci::writeContainer(fileId, sname, var);
+  writeRenumberedContainer(fileId, sname, var);
   Loci::hdf5CloseFile(fileId);
 }
 
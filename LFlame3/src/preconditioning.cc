@@ -0,0 +1,55 @@
+#include <preconditioning.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace flame {
+
+double lowMachReferenceVelocity(double const Umag, double const a, double const Mcut) {
+  return std::min(a, std::max(Umag, Mcut*a));
+}
+
+double preconditionedSpectralRadius(double const Un, double const a, double const Ur) {
+  // Eigenvalues of the preconditioned system are u' and u' +- c' with
+  // u' = (1-alpha)*Un, c' = sqrt(alpha^2*Un^2+Ur^2), alpha = (1-Ur^2/a^2)/2.
+  double const alpha = 0.5*(1.0-Ur*Ur/(a*a));
+  return std::fabs((1.0-alpha)*Un)+std::sqrt(alpha*alpha*Un*Un+Ur*Ur);
+}
+
+void preconditionResidual(
+  double * R, int const Ns,
+  Loci::vector3d<double> const & U, double const h0,
+  double const Cp, double const T, double const a, double const Ur,
+  double const * Y, double const * sh, double const * sW, double const mW
+) {
+  // The preconditioner differs from the Jacobian dQ/dW only in the pressure
+  // column, by (theta-rho_p)*(1, U, h0, Y). Hence the preconditioned rate of
+  // change dQ/dW*Gamma^-1*R is R plus (rho_p-theta)*dp times that column,
+  // where dp is the pressure increment Gamma^-1*R. For the ideal gas
+  // rho_p-theta = 1/a^2-1/Ur^2.
+  double const Rm = R[4];
+
+  // Energy equation minus the kinetic and species enthalpy parts, and mass
+  // equation minus the change in density due to composition.
+  double S = R[3]-h0*Rm-(U.x*R[0]+U.y*R[1]+U.z*R[2])+dot(U, U)*Rm;
+  double Rrho = Rm;
+  for(int i = 0; i < Ns-1; ++i) {
+    double const rhodY = R[5+i]-Y[i]*Rm;
+    S -= (sh[i]-sh[Ns-1])*rhodY;
+    Rrho += mW*(1.0/sW[i]-1.0/sW[Ns-1])*rhodY;
+  }
+
+  // (rho_p-theta)*dp with dp = Ur^2*(S+Cp*T*Rrho)/(Cp*T).
+  double const c = (Ur*Ur/(a*a)-1.0)*(S/(Cp*T)+Rrho);
+
+  R[0] += c*U.x;
+  R[1] += c*U.y;
+  R[2] += c*U.z;
+  R[3] += c*h0;
+  R[4] += c;
+  for(int i = 0; i < Ns-1; ++i) {
+    R[5+i] += c*Y[i];
+  }
+}
+
+} // end: namespace flame
@@ -0,0 +1,119 @@
+#include <space_filling_curve.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace flame {
+
+namespace {
+
+// Spreads the lower 21 bits of x so that there are two zero bits between
+// consecutive bits.
+std::uint64_t spreadBits(std::uint64_t x) {
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffff;
+  x = (x | x << 16) & 0x1f0000ff0000ff;
+  x = (x | x << 8) & 0x100f00f00f00f00f;
+  x = (x | x << 4) & 0x10c30c30c30c30c3;
+  x = (x | x << 2) & 0x1249249249249249;
+  return x;
+}
+
+} // end: anonymous namespace
+
+std::uint64_t mortonKey(
+  std::uint32_t const x, std::uint32_t const y, std::uint32_t const z,
+  int const bits
+) {
+  std::uint64_t const mask = (std::uint64_t(1) << bits)-1;
+  return spreadBits(x & mask) << 2 | spreadBits(y & mask) << 1 | spreadBits(z & mask);
+}
+
+std::uint64_t hilbertKey(
+  std::uint32_t const x, std::uint32_t const y, std::uint32_t const z,
+  int const bits
+) {
+  // Transposed Hilbert index (J. Skilling, AIP Conf. Proc. 707, 381, 2004).
+  std::uint32_t X[3] = {x, y, z};
+  std::uint32_t const M = std::uint32_t(1) << (bits-1);
+  
+  // Inverse undo.
+  for(std::uint32_t Q = M; Q > 1; Q >>= 1) {
+    std::uint32_t const P = Q-1;
+    for(int i = 0; i < 3; ++i) {
+      if(X[i] & Q) {
+        X[0] ^= P;
+      } else {
+        std::uint32_t const t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  
+  // Gray encode.
+  X[1] ^= X[0];
+  X[2] ^= X[1];
+  std::uint32_t t = 0;
+  for(std::uint32_t Q = M; Q > 1; Q >>= 1) {
+    if(X[2] & Q) {
+      t ^= Q-1;
+    }
+  }
+  for(int i = 0; i < 3; ++i) {
+    X[i] ^= t;
+  }
+  
+  return mortonKey(X[0], X[1], X[2], bits);
+}
+
+void spaceFillingCurveOrder(
+  std::vector<Loci::vector3d<double>> const & points,
+  SpaceFillingCurve const curve,
+  std::vector<int> & order
+) {
+  int const n = points.size();
+  
+  order.resize(n);
+  std::iota(order.begin(), order.end(), 0);
+  
+  if(n == 0) {
+    return;
+  }
+  
+  Loci::vector3d<double> pmin = points[0], pmax = points[0];
+  for(int i = 1; i < n; ++i) {
+    pmin.x = std::min(pmin.x, points[i].x);
+    pmin.y = std::min(pmin.y, points[i].y);
+    pmin.z = std::min(pmin.z, points[i].z);
+    pmax.x = std::max(pmax.x, points[i].x);
+    pmax.y = std::max(pmax.y, points[i].y);
+    pmax.z = std::max(pmax.z, points[i].z);
+  }
+  
+  // Same scale in all directions so that the curve is not stretched.
+  double const extent = std::max({pmax.x-pmin.x, pmax.y-pmin.y, pmax.z-pmin.z});
+  double const maxCoord = double((std::uint32_t(1) << FLAME_SFC_BITS)-1);
+  double const scale = extent > 0.0 ? maxCoord/extent : 0.0;
+  
+  std::vector<std::uint64_t> keys(n);
+  for(int i = 0; i < n; ++i) {
+    std::uint32_t const x = std::uint32_t(std::lround((points[i].x-pmin.x)*scale));
+    std::uint32_t const y = std::uint32_t(std::lround((points[i].y-pmin.y)*scale));
+    std::uint32_t const z = std::uint32_t(std::lround((points[i].z-pmin.z)*scale));
+    
+    if(curve == SpaceFillingCurve::Hilbert) {
+      keys[i] = hilbertKey(x, y, z, FLAME_SFC_BITS);
+    } else {
+      keys[i] = mortonKey(x, y, z, FLAME_SFC_BITS);
+    }
+  }
+  
+  std::stable_sort(
+    order.begin(), order.end(),
+    [&keys](int const a, int const b) { return keys[a] < keys[b]; }
+  );
+}
+
+} // end: namespace flame
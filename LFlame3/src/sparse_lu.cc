@@ -0,0 +1,171 @@
+#include <sparse_lu.hh>
+
+#include <algorithm>
+#include <cmath>
+
+namespace flame {
+
+void initSparseLU(SparseLU & lu, int const n, std::vector<char> const & pattern) {
+  // Graph of the symmetrized pattern, which gains the fill edges as the nodes
+  // are eliminated.
+  std::vector<char> graph(n*n, 0);
+  for(int i = 0; i < n; ++i) {
+    for(int j = 0; j < n; ++j) {
+      if(i != j && (pattern[i*n+j] || pattern[j*n+i])) {
+        graph[i*n+j] = 1;
+      }
+    }
+  }
+
+  // Minimum degree ordering: eliminate the node with the fewest remaining
+  // neighbors, the lowest first on ties, and connect its neighbors.
+  std::vector<char> eliminated(n, 0);
+  lu.perm.resize(n);
+  std::vector<int> neighbors;
+  for(int step = 0; step < n; ++step) {
+    int best = -1, bestDegree = n;
+    for(int v = 0; v < n; ++v) {
+      if(eliminated[v]) {
+        continue;
+      }
+      int degree = 0;
+      for(int u = 0; u < n; ++u) {
+        degree += !eliminated[u] && graph[v*n+u];
+      }
+      if(degree < bestDegree) {
+        best = v;
+        bestDegree = degree;
+      }
+    }
+
+    lu.perm[step] = best;
+    eliminated[best] = 1;
+    neighbors.clear();
+    for(int u = 0; u < n; ++u) {
+      if(!eliminated[u] && graph[best*n+u]) {
+        neighbors.push_back(u);
+      }
+    }
+    for(std::size_t a = 0; a < neighbors.size(); ++a) {
+      for(std::size_t b = 0; b < neighbors.size(); ++b) {
+        if(a != b) {
+          graph[neighbors[a]*n+neighbors[b]] = 1;
+        }
+      }
+    }
+  }
+
+  // Pattern of L+U in the permuted order: the edges of the filled graph and
+  // the diagonal.
+  lu.n = n;
+  lu.rowStart.assign(1, 0);
+  lu.column.clear();
+  lu.diagonal.resize(n);
+  lu.denseIndex.clear();
+  lu.position.assign(n*n, -1);
+  std::vector<int> position(n*n, -1);
+  for(int i = 0; i < n; ++i) {
+    int const pi = lu.perm[i];
+    for(int j = 0; j < n; ++j) {
+      int const pj = lu.perm[j];
+      if(i == j || graph[pi*n+pj]) {
+        if(i == j) {
+          lu.diagonal[i] = lu.column.size();
+        }
+        position[i*n+j] = lu.column.size();
+        lu.column.push_back(j);
+        lu.denseIndex.push_back(pi*n+pj);
+        lu.position[pi*n+pj] = lu.column.size()-1;
+      }
+    }
+    lu.rowStart.push_back(lu.column.size());
+  }
+  lu.nonzeros = lu.column.size();
+
+  // Operations of the row-by-row elimination. Entry (i, j) of a row k < i
+  // exists in row i because the elimination of k connected i and j.
+  lu.rowPivotStart.assign(1, 0);
+  lu.pivotEntry.clear();
+  lu.pivotDiagonal.clear();
+  lu.updateStart.assign(1, 0);
+  lu.updateTarget.clear();
+  lu.updateSource.clear();
+  for(int i = 0; i < n; ++i) {
+    for(int p = lu.rowStart[i]; p < lu.diagonal[i]; ++p) {
+      int const k = lu.column[p];
+      lu.pivotEntry.push_back(p);
+      lu.pivotDiagonal.push_back(lu.diagonal[k]);
+      for(int s = lu.diagonal[k]+1; s < lu.rowStart[k+1]; ++s) {
+        lu.updateTarget.push_back(position[i*n+lu.column[s]]);
+        lu.updateSource.push_back(s);
+      }
+      lu.updateStart.push_back(lu.updateTarget.size());
+    }
+    lu.rowPivotStart.push_back(lu.pivotEntry.size());
+  }
+}
+
+bool sparseLUFactor(
+  SparseLU const & lu, double * values, double const pivotTolerance
+) {
+  int const n = lu.n;
+  int const * pivotEntry = lu.pivotEntry.empty() ? nullptr : &lu.pivotEntry[0];
+  int const * pivotDiagonal =
+    lu.pivotDiagonal.empty() ? nullptr : &lu.pivotDiagonal[0];
+  int const * updateStart = &lu.updateStart[0];
+  int const * updateTarget = lu.updateTarget.empty() ? nullptr : &lu.updateTarget[0];
+  int const * updateSource = lu.updateSource.empty() ? nullptr : &lu.updateSource[0];
+
+  for(int i = 0; i < n; ++i) {
+    double amax = 0.0;
+    for(int p = lu.rowStart[i]; p < lu.rowStart[i+1]; ++p) {
+      amax = std::max(amax, std::fabs(values[p]));
+    }
+
+    for(int q = lu.rowPivotStart[i]; q < lu.rowPivotStart[i+1]; ++q) {
+      double const l = values[pivotEntry[q]]/values[pivotDiagonal[q]];
+      values[pivotEntry[q]] = l;
+      for(int u = updateStart[q]; u < updateStart[q+1]; ++u) {
+        values[updateTarget[u]] -= l*values[updateSource[u]];
+      }
+    }
+
+    double const d = values[lu.diagonal[i]];
+    if(!(std::fabs(d) > pivotTolerance*amax)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void sparseLUSolve(
+  SparseLU const & lu, double const * values, double * b, double * work
+) {
+  int const n = lu.n;
+  int const * perm = &lu.perm[0];
+  int const * rowStart = &lu.rowStart[0];
+  int const * column = &lu.column[0];
+  int const * diagonal = &lu.diagonal[0];
+
+  for(int i = 0; i < n; ++i) {
+    double s = b[perm[i]];
+    for(int p = rowStart[i]; p < diagonal[i]; ++p) {
+      s -= values[p]*work[column[p]];
+    }
+    work[i] = s;
+  }
+
+  for(int i = n-1; i >= 0; --i) {
+    double s = work[i];
+    for(int p = diagonal[i]+1; p < rowStart[i+1]; ++p) {
+      s -= values[p]*work[column[p]];
+    }
+    work[i] = s/values[diagonal[i]];
+  }
+
+  for(int i = 0; i < n; ++i) {
+    b[perm[i]] = work[i];
+  }
+}
+
+} // end: namespace flame
@@ -0,0 +1,85 @@
+#ifndef FLAME_TESTS_CHEMISTRY_TEST_HELPERS_HH
+#define FLAME_TESTS_CHEMISTRY_TEST_HELPERS_HH
+
+#include <chemistry_integrator.hh>
+
+#include "kinetics_test_helpers.hh"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace flame {
+namespace test {
+
+// Mechanism and thermodynamics of mixture-h2-o2.xml with an integrator of the
+// relative tolerance.
+struct Reactor {
+  std::unique_ptr<Mixture> mixture;
+  KineticsTable kinetics;
+  NASA9Table thermo;
+  ChemistryWorkspace work;
+  ChemistryIntegrator integrator;
+  std::vector<double> sR;
+
+  explicit Reactor(double const relativeTolerance = 1.0e-6)
+    : mixture(loadMixture()) {
+    int const Ns = mixture->nSpecies;
+    sR.resize(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      sR[s] = Runiv/mixture->molecularWeight[s];
+    }
+    initKineticsTable(kinetics, *mixture, Runiv);
+    initNASA9Table(thermo, Ns, mixture->nasa9Thermochemistry, &sR[0]);
+    initChemistryWorkspace(work, kinetics);
+
+    integrator.relativeTolerance = relativeTolerance;
+    integrator.absoluteTolerance = 1.0e-18;
+    integrator.maxSteps = 100000;
+  }
+
+  int integrate(double const rho, double const dt, std::vector<double> & Y, double & T) {
+    return integrateChemistry(
+      integrator, kinetics, thermo, work, rho, dt, &Y[0], T
+    );
+  }
+
+  // Specific internal energy of the mixture: [J/kg].
+  double energy(std::vector<double> const & Y, double const T) const {
+    int const Ns = mixture->nSpecies;
+    std::vector<double> sCp(Ns), sH(Ns);
+    nasa9_sCp_sH_from_T(Ns, &sCp[0], &sH[0], mixture->nasa9Thermochemistry, &sR[0], T);
+    double e = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      e += Y[s]*(sH[s]-sR[s]*T);
+    }
+    return e;
+  }
+};
+
+// Stoichiometric hydrogen-air at temperature T with density from p = 1 atm.
+inline void makeHydrogenAir(
+  Mixture const & mixture, double const T, double & rho, std::vector<double> & Y
+) {
+  int const Ns = mixture.nSpecies;
+  std::vector<double> X(Ns, 0.0);
+  X[H2] = 2.0/(2.0+1.0+3.76);
+  X[O2] = 1.0/(2.0+1.0+3.76);
+  X[N2] = 3.76/(2.0+1.0+3.76);
+
+  double W = 0.0;
+  for(int s = 0; s < Ns; ++s) {
+    W += X[s]*mixture.molecularWeight[s];
+  }
+  Y.resize(Ns);
+  for(int s = 0; s < Ns; ++s) {
+    Y[s] = X[s]*mixture.molecularWeight[s]/W;
+  }
+  rho = 101325.0*W/(Runiv*T);
+}
+
+} // end: namespace test
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_TESTS_CHEMISTRY_TEST_HELPERS_HH
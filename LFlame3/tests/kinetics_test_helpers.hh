@@ -0,0 +1,35 @@
+#ifndef FLAME_TESTS_KINETICS_TEST_HELPERS_HH
+#define FLAME_TESTS_KINETICS_TEST_HELPERS_HH
+
+#include <kinetics.hh>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace flame {
+namespace test {
+
+double const Runiv = FLAME_RUNIV;
+int const B = FLAME_KINETICS_BLOCK_SIZE;
+
+// Species of mixture-h2-o2.xml.
+enum { H2, O2, H, O, OH, H2O, N2 };
+
+// Mechanism and thermodynamics of mixture-h2-o2.xml.
+inline std::unique_ptr<Mixture> loadMixture() {
+  std::unique_ptr<Mixture> mixture(new Mixture);
+  std::ostringstream errmsg;
+  int error = parseFromXML(
+    std::string(FLAME_DATA_DIR)+"/mixture-h2-o2.xml", *mixture, errmsg
+  );
+  EXPECT_EQ(error, 0) << errmsg.str();
+  return mixture;
+}
+
+} // end: namespace test
+} // end: namespace flame
+
+#endif // end: #ifndef FLAME_TESTS_KINETICS_TEST_HELPERS_HH
@@ -0,0 +1,377 @@
+#include <chemistry_integrator.hh>
+
+#include "chemistry_test_helpers.hh"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace flame;
+using namespace flame::test;
+
+namespace {
+
+// Integrates over dt in nSteps calls of integrateChemistry.
+void integrate(
+  Reactor & reactor, double const rho, double const dt, int const nSteps,
+  std::vector<double> & Y, double & T
+) {
+  for(int i = 0; i < nSteps; ++i) {
+    int const steps = integrateChemistry(
+      reactor.integrator, reactor.kinetics, reactor.thermo, reactor.work,
+      rho, dt/nSteps, &Y[0], T
+    );
+    ASSERT_GT(steps, 0);
+  }
+}
+
+} // end: namespace
+
+// The factorization solves systems that need pivoting, with the specialized
+// and the general functions.
+TEST(DenseLU, Solve) {
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for(int n : {3, 8, 33, 40}) {
+    DenseLU const lu = selectDenseLU(n);
+    if(n <= FLAME_DENSE_LU_MAX_SPECIALIZED_N) {
+      EXPECT_NE(lu.factor, &denseLUFactor) << "n " << n;
+    } else {
+      EXPECT_EQ(lu.factor, &denseLUFactor) << "n " << n;
+    }
+
+    std::vector<double> A(n*n), x(n), b(n, 0.0);
+    for(int i = 0; i < n*n; ++i) {
+      A[i] = dist(gen);
+    }
+    for(int i = 0; i < n; ++i) {
+      A[i*n+i] = 0.0;
+      x[i] = dist(gen);
+    }
+    for(int i = 0; i < n; ++i) {
+      for(int j = 0; j < n; ++j) {
+        b[i] += A[i*n+j]*x[j];
+      }
+    }
+
+    std::vector<int> pivot(n);
+    ASSERT_TRUE(lu.factor(n, &A[0], &pivot[0]));
+    lu.solve(n, &A[0], &pivot[0], &b[0]);
+    for(int i = 0; i < n; ++i) {
+      EXPECT_NEAR(b[i], x[i], 1.0e-10) << "n " << n << " i " << i;
+    }
+  }
+
+  std::vector<double> A(9, 1.0);
+  std::vector<int> pivot(3);
+  EXPECT_FALSE(selectDenseLU(3).factor(3, &A[0], &pivot[0]));
+}
+
+// The sparse factorization solves systems with a dense last row and column,
+// with less fill than the dense matrix in the minimum degree order, and fails
+// on a zero pivot.
+TEST(SparseLU, Solve) {
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  int const n = 40;
+  std::vector<char> pattern(n*n, 0);
+  for(int i = 0; i < n; ++i) {
+    pattern[i*n+i] = 1;
+    pattern[i*n+n-1] = 1;
+    pattern[(n-1)*n+i] = 1;
+    pattern[i*n+(7*i+3)%n] = 1;
+  }
+
+  SparseLU lu;
+  initSparseLU(lu, n, pattern);
+  EXPECT_EQ(lu.perm[n-1], n-1);
+  EXPECT_LT(lu.nonzeros, n*n/4);
+
+  // Diagonally dominant rows so that the diagonal pivots are stable.
+  std::vector<double> A(n*n, 0.0), x(n), b(n, 0.0);
+  for(int i = 0; i < n; ++i) {
+    double sum = 0.0;
+    for(int j = 0; j < n; ++j) {
+      if(pattern[i*n+j] && i != j) {
+        A[i*n+j] = dist(gen);
+        sum += std::fabs(A[i*n+j]);
+      }
+    }
+    A[i*n+i] = sum+0.5;
+    x[i] = dist(gen);
+  }
+  for(int i = 0; i < n; ++i) {
+    for(int j = 0; j < n; ++j) {
+      b[i] += A[i*n+j]*x[j];
+    }
+  }
+
+  std::vector<double> values(lu.nonzeros), work(n);
+  for(int p = 0; p < lu.nonzeros; ++p) {
+    values[p] = A[lu.denseIndex[p]];
+  }
+  ASSERT_TRUE(sparseLUFactor(lu, &values[0]));
+  sparseLUSolve(lu, &values[0], &b[0], &work[0]);
+  for(int i = 0; i < n; ++i) {
+    EXPECT_NEAR(b[i], x[i], 1.0e-12) << "i " << i;
+  }
+
+  for(int p = 0; p < lu.nonzeros; ++p) {
+    values[p] = A[lu.denseIndex[p]];
+  }
+  values[lu.diagonal[0]] = 0.0;
+  EXPECT_FALSE(sparseLUFactor(lu, &values[0]));
+}
+
+// The analytic Jacobian of the reactor equations, including the row of the
+// temperature, matches central differences.
+TEST(ChemistryIntegrator, JacobianMatchesFiniteDifferences) {
+  Reactor reactor;
+  int const Ns = reactor.mixture->nSpecies;
+  int const n = Ns+1;
+  double const X[] = {0.20, 0.10, 0.05, 0.03, 0.07, 0.25, 0.30};
+
+  for(double T : {800.0, 1500.0, 2600.0}) {
+    std::vector<double> y(n), f(n), J(n*n), fp(n), fm(n);
+    double const Ctot = 101325.0/(Runiv*T);
+    for(int s = 0; s < Ns; ++s) {
+      y[s] = X[s]*Ctot;
+    }
+    y[Ns] = T;
+    chemistryRightHandSide(
+      reactor.kinetics, reactor.thermo, reactor.work, &y[0], &f[0], &J[0]
+    );
+
+    for(int k = 0; k < n; ++k) {
+      std::vector<double> yp(y), ym(y);
+      double const d = 1.0e-6*y[k];
+      yp[k] += d;
+      ym[k] -= d;
+      chemistryRightHandSide(
+        reactor.kinetics, reactor.thermo, reactor.work, &yp[0], &fp[0], nullptr
+      );
+      chemistryRightHandSide(
+        reactor.kinetics, reactor.thermo, reactor.work, &ym[0], &fm[0], nullptr
+      );
+
+      for(int i = 0; i < n; ++i) {
+        double const fd = (fp[i]-fm[i])/(2.0*d);
+        double const scale = std::fabs(f[i])/y[k];
+        EXPECT_NEAR(J[i*n+k], fd, 1.0e-6*(std::fabs(fd)+scale))
+          << "T " << T << " row " << i << " column " << k;
+      }
+    }
+  }
+}
+
+// The sensitivity of the final state to the initial one matches central
+// differences of the integration during ignition, within the error of holding
+// the Jacobian of a step fixed.
+TEST(ChemistryIntegrator, SensitivityMatchesFiniteDifferences) {
+  Reactor reactor;
+  reactor.integrator.relativeTolerance = 1.0e-9;
+  int const Ns = reactor.mixture->nSpecies;
+  int const n = Ns+1;
+  double const dt = 2.0e-5;
+
+  // Partially burnt hydrogen-air.
+  double rho, T = 1200.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+  integrate(reactor, rho, 1.5e-4, 1, Y, T);
+
+  std::vector<double> y0(n), S(n*n);
+  for(int s = 0; s < Ns; ++s) {
+    y0[s] = rho*Y[s]/reactor.mixture->molecularWeight[s];
+  }
+  y0[Ns] = T;
+
+  // Final state of the integration from initial state y.
+  auto integrateState = [&](std::vector<double> y, double * Sy) {
+    double rhoy = 0.0;
+    std::vector<double> Yy(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      rhoy += y[s]*reactor.mixture->molecularWeight[s];
+    }
+    for(int s = 0; s < Ns; ++s) {
+      Yy[s] = y[s]*reactor.mixture->molecularWeight[s]/rhoy;
+    }
+    double Ty = y[Ns];
+    EXPECT_GT(integrateChemistry(
+      reactor.integrator, reactor.kinetics, reactor.thermo, reactor.work,
+      rhoy, dt, &Yy[0], Ty, Sy
+    ), 0);
+    for(int s = 0; s < Ns; ++s) {
+      y[s] = rhoy*Yy[s]/reactor.mixture->molecularWeight[s];
+    }
+    y[Ns] = Ty;
+    return y;
+  };
+
+  std::vector<double> const y1 = integrateState(y0, &S[0]);
+  std::vector<double> const y1NoS = integrateState(y0, nullptr);
+  for(int i = 0; i < n; ++i) {
+    EXPECT_EQ(y1[i], y1NoS[i]);
+  }
+
+  for(int k = 0; k < n; ++k) {
+    double const d = 1.0e-4*y0[k]+(k < Ns ? 1.0e-10 : 0.0);
+    std::vector<double> yp(y0), ym(y0);
+    yp[k] += d;
+    ym[k] -= d;
+    std::vector<double> const y1p = integrateState(yp, nullptr);
+    std::vector<double> const y1m = integrateState(ym, nullptr);
+
+    // Columns are compared in the norm of the state scaled by y1.
+    double norm = 0.0, err = 0.0;
+    for(int i = 0; i < n; ++i) {
+      double const scale = y0[k]/(y1[i]+1.0e-12);
+      double const fd = (y1p[i]-y1m[i])/(2.0*d)*scale;
+      norm += fd*fd;
+      err += (S[i*n+k]*scale-fd)*(S[i*n+k]*scale-fd);
+    }
+    EXPECT_LT(std::sqrt(err), 2.0e-2*std::sqrt(norm)+1.0e-6) << "column " << k;
+  }
+}
+
+// Ignition of hydrogen-air conserves the mass and the internal energy and
+// releases the heat of reaction.
+TEST(ChemistryIntegrator, Ignition) {
+  Reactor reactor;
+  int const Ns = reactor.mixture->nSpecies;
+
+  double rho, T = 1200.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+  double const e0 = reactor.energy(Y, T);
+  double const YN2 = Y[N2];
+
+  integrate(reactor, rho, 1.0e-3, 1, Y, T);
+
+  double sum = 0.0;
+  for(int s = 0; s < Ns; ++s) {
+    sum += Y[s];
+  }
+  EXPECT_NEAR(sum, 1.0, 1.0e-12);
+  EXPECT_NEAR(Y[N2], YN2, 1.0e-12);
+  EXPECT_GT(T, 2500.0);
+  EXPECT_GT(Y[H2O], 0.15);
+  EXPECT_NEAR(reactor.energy(Y, T), e0, 1.0e-5*std::fabs(e0)+1.0);
+}
+
+// One integration over a flow time step gives the result of many short ones,
+// and a step far longer than the chemical time scales near equilibrium takes
+// few substeps.
+TEST(ChemistryIntegrator, LongStep) {
+  Reactor reactor;
+  int const Ns = reactor.mixture->nSpecies;
+
+  double rho, T = 1500.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+
+  std::vector<double> Y1(Y), Y2(Y);
+  double T1 = T, T2 = T;
+  integrate(reactor, rho, 1.0e-4, 1, Y1, T1);
+  integrate(reactor, rho, 1.0e-4, 1000, Y2, T2);
+  for(int s = 0; s < Ns; ++s) {
+    EXPECT_NEAR(Y1[s], Y2[s], 1.0e-4) << "species " << s;
+  }
+  EXPECT_NEAR(T1, T2, 1.0e-3*T2);
+
+  int const steps = integrateChemistry(
+    reactor.integrator, reactor.kinetics, reactor.thermo, reactor.work,
+    rho, 1.0, &Y1[0], T1
+  );
+  EXPECT_GT(steps, 0);
+  EXPECT_LT(steps, 500);
+
+  // The net production rates vanish at equilibrium.
+  std::vector<double> C(Ns), wdot(Ns);
+  for(int s = 0; s < Ns; ++s) {
+    C[s] = rho*Y1[s]/reactor.mixture->molecularWeight[s];
+  }
+  kineticsMolarRates(reactor.kinetics, &C[0], T1, &wdot[0], nullptr, 0);
+  for(int s = 0; s < Ns; ++s) {
+    EXPECT_NEAR(wdot[s], 0.0, 1.0e-3*C[s]+1.0e-12) << "species " << s;
+  }
+}
+
+// The pattern of the mechanism holds every nonzero of the Jacobian, and the
+// integration with the sparse factorization gives that with the dense one.
+TEST(ChemistryIntegrator, SparseMatchesDense) {
+  Reactor reactor;
+  int const Ns = reactor.mixture->nSpecies;
+  int const n = Ns+1;
+
+  std::vector<char> pattern;
+  kineticsJacobianPattern(reactor.kinetics, pattern);
+  double const X[] = {0.20, 0.10, 0.05, 0.03, 0.07, 0.25, 0.30};
+  std::vector<double> C(Ns), wdot(Ns), J(Ns*n);
+  for(int s = 0; s < Ns; ++s) {
+    C[s] = X[s]*101325.0/(Runiv*1500.0);
+  }
+  kineticsMolarRates(reactor.kinetics, &C[0], 1500.0, &wdot[0], &J[0], n);
+  for(int s = 0; s < Ns; ++s) {
+    for(int k = 0; k <= Ns; ++k) {
+      if(!pattern[s*n+k]) {
+        EXPECT_EQ(J[s*n+k], 0.0) << "species " << s << " column " << k;
+      }
+    }
+  }
+  EXPECT_FALSE(pattern[N2*n+N2]);
+
+  std::shared_ptr<SparseLU> lu(new SparseLU);
+  initChemistrySparseLU(*lu, reactor.kinetics);
+  EXPECT_EQ(lu->perm[Ns], Ns);
+
+  // The reactor Jacobian assembled in the entries of the factorization, with
+  // the row of the temperature, is the dense one.
+  std::vector<double> y(C), f(n), fs(n), Jd(n*n), Js(lu->nonzeros);
+  y.push_back(1500.0);
+  chemistryRightHandSide(
+    reactor.kinetics, reactor.thermo, reactor.work, &y[0], &f[0], &Jd[0]
+  );
+  chemistryRightHandSideSparse(
+    reactor.kinetics, reactor.thermo, *lu, reactor.work, &y[0], &fs[0], &Js[0]
+  );
+  for(int i = 0; i < n; ++i) {
+    EXPECT_EQ(fs[i], f[i]) << "row " << i;
+  }
+  for(int p = 0; p < lu->nonzeros; ++p) {
+    int const e = lu->denseIndex[p];
+    EXPECT_NEAR(Js[p], Jd[e], 1.0e-12*std::fabs(Jd[e]))
+      << "row " << e/n << " column " << e%n;
+  }
+
+  double rho, T = 1200.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+
+  std::vector<double> Yd(Y), Ys(Y), Sd(n*n), Ss(n*n);
+  double Td = T, Ts = T;
+  int const stepsd = integrateChemistry(
+    reactor.integrator, reactor.kinetics, reactor.thermo, reactor.work,
+    rho, 1.0e-4, &Yd[0], Td, &Sd[0]
+  );
+  reactor.integrator.sparseLU = lu;
+  int const stepss = integrateChemistry(
+    reactor.integrator, reactor.kinetics, reactor.thermo, reactor.work,
+    rho, 1.0e-4, &Ys[0], Ts, &Ss[0]
+  );
+
+  ASSERT_GT(stepsd, 0);
+  EXPECT_EQ(stepss, stepsd);
+  for(int s = 0; s < Ns; ++s) {
+    EXPECT_NEAR(Ys[s], Yd[s], 1.0e-9) << "species " << s;
+  }
+  EXPECT_NEAR(Ts, Td, 1.0e-9*Td);
+  for(int i = 0; i < n*n; ++i) {
+    EXPECT_NEAR(Ss[i], Sd[i], 1.0e-6*(std::fabs(Sd[i])+1.0)) << "entry " << i;
+  }
+}
@@ -0,0 +1,125 @@
+#include <chemistry_load_balance.hh>
+
+#include "chemistry_test_helpers.hh"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+using namespace flame;
+using namespace flame::test;
+
+namespace {
+
+// Loads after the transfers.
+std::vector<double> balancedLoads(
+  std::vector<double> loads, std::vector<ChemistryTransfer> const & transfers
+) {
+  for(std::size_t t = 0; t < transfers.size(); ++t) {
+    loads[transfers[t].from] -= transfers[t].cost;
+    loads[transfers[t].to] += transfers[t].cost;
+  }
+  return loads;
+}
+
+} // end: namespace
+
+// The transfers move the excess of the loaded processes to the others, so that
+// all loads become the mean, and are the same for the same loads.
+TEST(ChemistryLoadBalance, TransfersEvenOutLoads) {
+  std::vector<double> const loads = {10.0, 1.0, 0.0, 5.0, 0.5, 2.5};
+  double const mean = std::accumulate(loads.begin(), loads.end(), 0.0)/6.0;
+
+  std::vector<ChemistryTransfer> transfers;
+  chemistryTransferPlan(loads, 0.1, transfers);
+  ASSERT_GT(transfers.size(), 0u);
+  EXPECT_LE(transfers.size(), loads.size()-1);
+
+  for(std::size_t t = 0; t < transfers.size(); ++t) {
+    EXPECT_GT(loads[transfers[t].from], mean);
+    EXPECT_LT(loads[transfers[t].to], mean);
+    EXPECT_GT(transfers[t].cost, 0.0);
+  }
+
+  std::vector<double> const after = balancedLoads(loads, transfers);
+  for(std::size_t p = 0; p < after.size(); ++p) {
+    EXPECT_NEAR(after[p], mean, 1.0e-12);
+  }
+
+  // The largest excess goes to the largest deficit first.
+  EXPECT_EQ(transfers[0].from, 0);
+  EXPECT_EQ(transfers[0].to, 2);
+
+  std::vector<ChemistryTransfer> again;
+  chemistryTransferPlan(loads, 0.1, again);
+  ASSERT_EQ(again.size(), transfers.size());
+  for(std::size_t t = 0; t < again.size(); ++t) {
+    EXPECT_EQ(again[t].from, transfers[t].from);
+    EXPECT_EQ(again[t].to, transfers[t].to);
+    EXPECT_EQ(again[t].cost, transfers[t].cost);
+  }
+}
+
+// Loads within the imbalance of the mean, without cost, or of a single process
+// are not balanced.
+TEST(ChemistryLoadBalance, BalancedLoadsAreKept) {
+  std::vector<ChemistryTransfer> transfers;
+  chemistryTransferPlan({1.0, 1.05, 0.95, 1.0}, 0.1, transfers);
+  EXPECT_EQ(transfers.size(), 0u);
+
+  chemistryTransferPlan({0.0, 0.0, 0.0}, 0.1, transfers);
+  EXPECT_EQ(transfers.size(), 0u);
+
+  chemistryTransferPlan({3.0}, 0.1, transfers);
+  EXPECT_EQ(transfers.size(), 0u);
+
+  chemistryTransferPlan({1.0, 1.05, 0.95, 1.0}, 0.01, transfers);
+  EXPECT_GT(transfers.size(), 0u);
+}
+
+// Without balancing the reactors are advanced as integrateChemistry, and their
+// costs are measured.
+TEST(ChemistryLoadBalance, LocalReactorsAreIntegrated) {
+  Reactor reactor(1.0e-8);
+  int const Ns = reactor.mixture->nSpecies;
+
+  std::vector<double> Y(Ns, 0.0);
+  Y[H2] = 0.0283;
+  Y[O2] = 0.2264;
+  Y[N2] = 1.0-Y[H2]-Y[O2];
+  double const rho = 0.3;
+  double const dt = 1.0e-5;
+
+  ChemistryLoadBalance balance;
+  initChemistryLoadBalance(balance, false, 0.1);
+
+  ChemistryReactors reactors;
+  clearChemistryReactors(reactors, Ns);
+  double const temperatures[3] = {300.0, 1200.0, 1500.0};
+  for(int i = 0; i < 3; ++i) {
+    addChemistryReactor(reactors, rho, temperatures[i], &Y[0], 0.0);
+  }
+  integrateChemistryReactors(
+    reactors, reactor.integrator, reactor.kinetics, reactor.thermo,
+    reactor.work, nullptr, dt, &balance, MPI_COMM_WORLD
+  );
+
+  double cost = 0.0;
+  for(int i = 0; i < 3; ++i) {
+    std::vector<double> Yi(Y);
+    double T = temperatures[i];
+    int const steps = reactor.integrate(rho, dt, Yi, T);
+    EXPECT_EQ(reactors.steps[i], steps);
+    EXPECT_EQ(reactors.temperature[i], T);
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_EQ(reactors.massFraction[i*Ns+s], Yi[s]);
+    }
+    EXPECT_GT(reactors.cost[i], 0.0);
+    cost += reactors.cost[i];
+  }
+
+  EXPECT_DOUBLE_EQ(balance.statistics.cost, cost);
+  EXPECT_EQ(balance.statistics.sent, 0);
+  EXPECT_EQ(balance.statistics.received, 0);
+}
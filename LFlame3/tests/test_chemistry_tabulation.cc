@@ -0,0 +1,224 @@
+#include <chemistry_tabulation.hh>
+
+#include "chemistry_test_helpers.hh"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace flame;
+using namespace flame::test;
+
+namespace {
+
+// Reactor of chemistry_test_helpers.hh with a table.
+struct TabulatedReactor : Reactor {
+  ChemistryTabulation table;
+
+  TabulatedReactor(double const tolerance, double const memory) : Reactor(1.0e-8) {
+    initChemistryTabulation(table, mixture->nSpecies, tolerance, memory);
+  }
+
+  int tabulate(double const rho, double const dt, std::vector<double> & Y, double & T) {
+    return tabulatedChemistry(
+      table, integrator, kinetics, thermo, work, rho, dt, &Y[0], T
+    );
+  }
+};
+
+// Error of a tabulated result in the norm of the table.
+double resultError(
+  std::vector<double> const & Y1, double const T1,
+  std::vector<double> const & Y2, double const T2
+) {
+  double err = 0.0;
+  for(std::size_t s = 0; s < Y1.size(); ++s) {
+    err += (Y1[s]-Y2[s])*(Y1[s]-Y2[s]);
+  }
+  double const dT = (T1-T2)/FLAME_CHEMISTRY_TABULATION_TEMPERATURE_SCALE;
+  return std::sqrt(err+dT*dT);
+}
+
+} // end: namespace
+
+// A query that was tabulated is retrieved with the result of the integration.
+TEST(ChemistryTabulation, RepeatedQueryIsRetrieved) {
+  TabulatedReactor reactor(1.0e-4, 1.0e6);
+  double const dt = 1.0e-5;
+
+  double rho, T = 1500.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+
+  std::vector<double> Y1(Y), Y2(Y), Y3(Y);
+  double T1 = T, T2 = T, T3 = T;
+  EXPECT_GT(reactor.integrate(rho, dt, Y1, T1), 0);
+  EXPECT_GT(reactor.tabulate(rho, dt, Y2, T2), 0);
+  EXPECT_EQ(reactor.tabulate(rho, dt, Y3, T3), 0);
+
+  ChemistryTabulationStatistics const & stats = reactor.table.statistics;
+  EXPECT_EQ(stats.adds, 1);
+  EXPECT_EQ(stats.retrieves, 1);
+  EXPECT_EQ(reactor.table.nRecords, 1);
+  for(std::size_t s = 0; s < Y.size(); ++s) {
+    EXPECT_EQ(Y2[s], Y1[s]);
+    EXPECT_DOUBLE_EQ(Y3[s], Y1[s]);
+  }
+  EXPECT_EQ(T2, T1);
+  EXPECT_DOUBLE_EQ(T3, T1);
+
+}
+
+// Records of different time steps are kept side by side, and a time step
+// close to a tabulated one is retrieved with the derivative of the result
+// with respect to the time step.
+TEST(ChemistryTabulation, TimeStepIsPartOfTheQuery) {
+  double const tolerance = 1.0e-4;
+  TabulatedReactor reactor(tolerance, 1.0e6);
+  double const dt = 1.0e-5;
+
+  double rho, T = 1500.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+
+  for(int i = 0; i < 3; ++i) {
+    for(double const h : {dt, 2.0*dt}) {
+      std::vector<double> Yq(Y);
+      double Tq = T;
+      int const steps = reactor.tabulate(rho, h, Yq, Tq);
+      if(i == 0) {
+        EXPECT_GT(steps, 0);
+      } else {
+        EXPECT_EQ(steps, 0);
+      }
+    }
+  }
+
+  ChemistryTabulationStatistics const & stats = reactor.table.statistics;
+  EXPECT_EQ(stats.adds, 2);
+  EXPECT_EQ(stats.retrieves, 4);
+  EXPECT_EQ(reactor.table.nRecords, 2);
+
+  double const h = dt*(1.0+2.0e-5);
+  std::vector<double> Y1(Y), Y2(Y);
+  double T1 = T, T2 = T;
+  EXPECT_GT(reactor.integrate(rho, h, Y1, T1), 0);
+  EXPECT_EQ(reactor.tabulate(rho, h, Y2, T2), 0);
+  EXPECT_LT(resultError(Y2, T2, Y1, T1), 1.0e-2*tolerance);
+}
+
+// Queries scattered about the states of an ignition are mostly retrieved or
+// covered by grown records after the table has been built, and the retrieved
+// results are close to the integrated ones.
+TEST(ChemistryTabulation, RetrievedResultsAreAccurate) {
+  double const tolerance = 1.0e-4;
+  TabulatedReactor reactor(tolerance, 1.0e8);
+  int const Ns = reactor.mixture->nSpecies;
+  double const dt = 1.0e-6;
+
+  double rho0, T0 = 1200.0;
+  std::vector<double> Y0;
+  makeHydrogenAir(*reactor.mixture, T0, rho0, Y0);
+
+  // States along the ignition.
+  std::vector<std::vector<double> > states;
+  std::vector<double> temperatures;
+  for(int i = 0; i < 10; ++i) {
+    ASSERT_GT(reactor.integrate(rho0, 2.0e-5, Y0, T0), 0);
+    states.push_back(Y0);
+    temperatures.push_back(T0);
+  }
+
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::uniform_int_distribution<int> pick(0, states.size()-1);
+
+  double maxError = 0.0;
+  long retrieved = 0;
+  for(int q = 0; q < 4000; ++q) {
+    int const k = pick(gen);
+    std::vector<double> Y(states[k]);
+    double T = temperatures[k]*(1.0+2.0e-4*dist(gen));
+    double const rho = rho0*(1.0+2.0e-4*dist(gen));
+    for(int s = 0; s < Ns; ++s) {
+      Y[s] *= 1.0+2.0e-3*dist(gen);
+    }
+
+    std::vector<double> Yd(Y);
+    double Td = T;
+    ASSERT_GT(reactor.integrate(rho, dt, Yd, Td), 0);
+    int const steps = reactor.tabulate(rho, dt, Y, T);
+    ASSERT_GE(steps, 0);
+    if(steps == 0) {
+      ++retrieved;
+      maxError = std::max(maxError, resultError(Y, T, Yd, Td));
+    }
+  }
+
+  ChemistryTabulationStatistics const & stats = reactor.table.statistics;
+  EXPECT_EQ(stats.retrieves, retrieved);
+  EXPECT_EQ(stats.retrieves+stats.grows+stats.adds, 4000);
+  EXPECT_EQ(reactor.table.nRecords, stats.adds);
+  EXPECT_GT(stats.retrieves, 3000);
+  EXPECT_LT(maxError, tolerance);
+}
+
+// A table with room for a few records evicts the least recently used ones,
+// and the records it keeps are still found. The tolerance is so small that no
+// record is grown to cover another query.
+TEST(ChemistryTabulation, LeastRecentlyUsedEviction) {
+  TabulatedReactor reactor(1.0e-12, 0.0);
+  EXPECT_EQ(reactor.table.maxRecords, 1);
+
+  int const Ns = reactor.mixture->nSpecies;
+  int const m = Ns+3;
+  int const l = Ns+1;
+  double const bytes = sizeof(double)*(m+l+l*m+m*m+m+1)+6*sizeof(int);
+  initChemistryTabulation(reactor.table, Ns, 1.0e-12, 4.5*bytes);
+  EXPECT_EQ(reactor.table.maxRecords, 4);
+
+  // States along an ignition, after the radicals have built up so that the
+  // map is not linear about any of them.
+  int const nQueries = 20;
+  double rho, T = 1200.0;
+  std::vector<double> Y;
+  makeHydrogenAir(*reactor.mixture, T, rho, Y);
+  ASSERT_GT(reactor.integrate(rho, 3.0e-5, Y, T), 0);
+  std::vector<std::vector<double> > states;
+  std::vector<double> temperatures;
+  for(int q = 0; q < nQueries; ++q) {
+    ASSERT_GT(reactor.integrate(rho, 5.0e-6, Y, T), 0);
+    states.push_back(Y);
+    temperatures.push_back(T);
+  }
+
+  double const dt = 1.0e-5;
+  for(int q = 0; q < nQueries; ++q) {
+    std::vector<double> Yq(states[q]);
+    double Tq = temperatures[q];
+    ASSERT_GT(reactor.tabulate(rho, dt, Yq, Tq), 0);
+    EXPECT_LE(reactor.table.nRecords, 4);
+  }
+
+  ChemistryTabulationStatistics const & stats = reactor.table.statistics;
+  EXPECT_EQ(stats.adds, nQueries);
+  EXPECT_EQ(stats.evictions, nQueries-4);
+  EXPECT_EQ(reactor.table.nRecords, 4);
+
+  // The last four queries are retrieved, in any order; the others are not.
+  for(int q : {nQueries-1, nQueries-3, nQueries-4, nQueries-2}) {
+    std::vector<double> Yq(states[q]);
+    double Tq = temperatures[q];
+    EXPECT_EQ(reactor.tabulate(rho, dt, Yq, Tq), 0) << "query " << q;
+  }
+  std::vector<double> Yq(states[0]);
+  double Tq = temperatures[0];
+  EXPECT_GT(reactor.tabulate(rho, dt, Yq, Tq), 0);
+  EXPECT_EQ(reactor.table.nRecords, 4);
+
+  resetChemistryTabulationStatistics(reactor.table);
+  EXPECT_EQ(stats.adds, 0);
+  EXPECT_EQ(stats.retrieves, 0);
+}
@@ -0,0 +1,650 @@
+#include <flux.hh>
+#include <flux_registry.hh>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace flame;
+
+TEST(AUSMPlusUpFluxIdealGas, BlockMatchesFace) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  // Velocity scales cover subsonic and supersonic faces on both sides.
+  double const Uscales[3] = {50.0, 400.0, 1500.0};
+  double const Minfs[2] = {1.0, 0.1};
+
+  IdealGasFaceBlock block;
+  int const n = FLAME_FLUX_BLOCK_SIZE-3;
+
+  for(double const Uscale : Uscales) {
+    for(double const Minf : Minfs) {
+      for(int i = 0; i < n; ++i) {
+        double const nx = dist(gen), ny = dist(gen), nz = dist(gen);
+        double const nmag = sqrt(nx*nx+ny*ny+nz*nz);
+
+        block.Ulx[i] = Uscale*dist(gen);
+        block.Uly[i] = Uscale*dist(gen);
+        block.Ulz[i] = Uscale*dist(gen);
+        block.Pgl[i] = 5.0e4*dist(gen);
+        block.Tl[i] = 300.0+100.0*dist(gen);
+        block.Urx[i] = Uscale*dist(gen);
+        block.Ury[i] = Uscale*dist(gen);
+        block.Urz[i] = Uscale*dist(gen);
+        block.Pgr[i] = 5.0e4*dist(gen);
+        block.Tr[i] = 300.0+100.0*dist(gen);
+        block.area_sada[i] = 1.0+0.5*dist(gen);
+        block.area_nx[i] = nx/nmag;
+        block.area_ny[i] = ny/nmag;
+        block.area_nz[i] = nz/nmag;
+        block.Minf[i] = Minf;
+      }
+
+      AUSMPlusUpFluxIdealGasBlock(block, n, Pambient, Rtilde, Cp);
+
+      for(int i = 0; i < n; ++i) {
+        Loci::Array<double, 5> flux;
+        AUSMPlusUpFluxIdealGas(
+          flux,
+          Loci::vector3d<double>(block.Ulx[i], block.Uly[i], block.Ulz[i]),
+          block.Pgl[i], block.Tl[i],
+          Loci::vector3d<double>(block.Urx[i], block.Ury[i], block.Urz[i]),
+          block.Pgr[i], block.Tr[i],
+          block.area_sada[i],
+          Loci::vector3d<double>(block.area_nx[i], block.area_ny[i], block.area_nz[i]),
+          Pambient, Rtilde, Cp, Minf
+        );
+
+        for(int j = 0; j < 5; ++j) {
+          EXPECT_NEAR(block.flux[j][i], flux[j], 1.0e-10*(1.0+fabs(flux[j])))
+            << "face " << i << ", component " << j;
+        }
+      }
+    }
+  }
+}
+
+TEST(AUSMPlusUpFluxMultiSpeciesIdealGas, SpecializationMatchesRuntime) {
+  double const Pambient = 101325.0;
+
+  std::mt19937 gen(2);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for(int Ns = 1; Ns <= FLAME_FLUX_MAX_SPECIALIZED_NS+2; ++Ns) {
+    AUSMPlusUpFluxMultiSpeciesIdealGasFunction const fn =
+      selectAUSMPlusUpFluxMultiSpeciesIdealGas(Ns);
+
+    if(Ns < FLAME_FLUX_MIN_SPECIALIZED_NS || Ns > FLAME_FLUX_MAX_SPECIALIZED_NS) {
+      EXPECT_EQ(fn, &AUSMPlusUpFluxMultiSpeciesIdealGas) << "Ns = " << Ns;
+    } else {
+      EXPECT_NE(fn, &AUSMPlusUpFluxMultiSpeciesIdealGas) << "Ns = " << Ns;
+    }
+
+    for(int k = 0; k < 16; ++k) {
+      std::vector<double> Yl(Ns), Yr(Ns);
+      for(int i = 0; i < Ns; ++i) {
+        Yl[i] = 1.0+dist(gen);
+        Yr[i] = 1.0+dist(gen);
+      }
+
+      Loci::vector3d<double> const Ul(300.0*dist(gen), 300.0*dist(gen), 300.0*dist(gen));
+      Loci::vector3d<double> const Ur(300.0*dist(gen), 300.0*dist(gen), 300.0*dist(gen));
+      Loci::vector3d<double> const n(0.6, 0.8, 0.0);
+      double const Pgl = 5.0e4*dist(gen), Tl = 300.0+50.0*dist(gen);
+      double const Pgr = 5.0e4*dist(gen), Tr = 300.0+50.0*dist(gen);
+
+      std::vector<double> expected(Ns+4), actual(Ns+4);
+      AUSMPlusUpFluxMultiSpeciesIdealGas(
+        expected.data(), Ns,
+        Yl.data(), Ul, Pgl, Tl, 287.0, 1005.0,
+        Yr.data(), Ur, Pgr, Tr, 290.0, 1010.0,
+        1.0, n, Pambient, 1.0
+      );
+      fn(
+        actual.data(), Ns,
+        Yl.data(), Ul, Pgl, Tl, 287.0, 1005.0,
+        Yr.data(), Ur, Pgr, Tr, 290.0, 1010.0,
+        1.0, n, Pambient, 1.0
+      );
+
+      for(int i = 0; i < Ns+4; ++i) {
+        EXPECT_DOUBLE_EQ(actual[i], expected[i]) << "Ns = " << Ns << ", component " << i;
+      }
+    }
+  }
+}
+
+TEST(AUSMPlusUpFluxIdealGas, SinglePrecisionBlockIsClose) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  IdealGasFaceBlock block;
+  IdealGasFaceBlockSP blockSP;
+  int const n = FLAME_FLUX_BLOCK_SIZE;
+
+  for(int i = 0; i < n; ++i) {
+    double const nx = dist(gen), ny = dist(gen), nz = dist(gen);
+    double const nmag = sqrt(nx*nx+ny*ny+nz*nz);
+
+    blockSP.Ulx[i] = block.Ulx[i] = 300.0*dist(gen);
+    blockSP.Uly[i] = block.Uly[i] = 300.0*dist(gen);
+    blockSP.Ulz[i] = block.Ulz[i] = 300.0*dist(gen);
+    blockSP.Pgl[i] = block.Pgl[i] = 5.0e4*dist(gen);
+    blockSP.Tl[i] = block.Tl[i] = 300.0+100.0*dist(gen);
+    blockSP.Urx[i] = block.Urx[i] = 300.0*dist(gen);
+    blockSP.Ury[i] = block.Ury[i] = 300.0*dist(gen);
+    blockSP.Urz[i] = block.Urz[i] = 300.0*dist(gen);
+    blockSP.Pgr[i] = block.Pgr[i] = 5.0e4*dist(gen);
+    blockSP.Tr[i] = block.Tr[i] = 300.0+100.0*dist(gen);
+    blockSP.area_sada[i] = block.area_sada[i] = 1.0;
+    blockSP.area_nx[i] = block.area_nx[i] = nx/nmag;
+    blockSP.area_ny[i] = block.area_ny[i] = ny/nmag;
+    blockSP.area_nz[i] = block.area_nz[i] = nz/nmag;
+    blockSP.Minf[i] = block.Minf[i] = 1.0;
+  }
+
+  AUSMPlusUpFluxIdealGasBlock(block, n, Pambient, Rtilde, Cp);
+  AUSMPlusUpFluxIdealGasBlock(blockSP, n, Pambient, Rtilde, Cp);
+
+  // The flux is compared relative to the scale of its terms: momentum flux to
+  // the pressure, energy flux to the mass flux times enthalpy.
+  for(int i = 0; i < n; ++i) {
+    double const mscale = 1.0+fabs(block.flux[4][i])*300.0+Pambient;
+    double const escale = 1.0+fabs(block.flux[4][i])*Cp*400.0;
+    for(int j = 0; j < 3; ++j) {
+      EXPECT_NEAR(blockSP.flux[j][i], block.flux[j][i], 1.0e-4*mscale)
+        << "face " << i << ", component " << j;
+    }
+    EXPECT_NEAR(blockSP.flux[3][i], block.flux[3][i], 1.0e-4*escale) << "face " << i;
+    EXPECT_NEAR(blockSP.flux[4][i], block.flux[4][i], 1.0e-4*(1.0+fabs(block.flux[4][i])))
+      << "face " << i;
+  }
+}
+
+TEST(AUSMPlusUpFluxMultiSpeciesIdealGas, SinglePrecisionIsClose) {
+  double const Pambient = 101325.0;
+  int const Ns = 4;
+
+  std::mt19937 gen(4);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for(int k = 0; k < 64; ++k) {
+    std::vector<double> Yl(Ns), Yr(Ns);
+    for(int i = 0; i < Ns; ++i) {
+      Yl[i] = 0.25+0.2*dist(gen);
+      Yr[i] = 0.25+0.2*dist(gen);
+    }
+
+    Loci::vector3d<double> const Ul(300.0*dist(gen), 300.0*dist(gen), 300.0*dist(gen));
+    Loci::vector3d<double> const Ur(300.0*dist(gen), 300.0*dist(gen), 300.0*dist(gen));
+    Loci::vector3d<double> const n(0.6, 0.8, 0.0);
+    double const Pgl = 5.0e4*dist(gen), Tl = 300.0+50.0*dist(gen);
+    double const Pgr = 5.0e4*dist(gen), Tr = 300.0+50.0*dist(gen);
+
+    std::vector<double> expected(Ns+4), actual(Ns+4);
+    AUSMPlusUpFluxMultiSpeciesIdealGas(
+      expected.data(), Ns,
+      Yl.data(), Ul, Pgl, Tl, 287.0, 1005.0,
+      Yr.data(), Ur, Pgr, Tr, 290.0, 1010.0,
+      1.0, n, Pambient, 1.0
+    );
+    AUSMPlusUpFluxMultiSpeciesIdealGasSP(
+      actual.data(), Ns,
+      Yl.data(), Ul, Pgl, Tl, 287.0, 1005.0,
+      Yr.data(), Ur, Pgr, Tr, 290.0, 1010.0,
+      1.0, n, Pambient, 1.0
+    );
+
+    double const mscale = 1.0+fabs(expected[4])*300.0+Pambient;
+    double const escale = 1.0+fabs(expected[4])*1010.0*350.0;
+    for(int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(actual[i], expected[i], 1.0e-4*mscale) << "component " << i;
+    }
+    EXPECT_NEAR(actual[3], expected[3], 1.0e-4*escale);
+    for(int i = 4; i < Ns+4; ++i) {
+      EXPECT_NEAR(actual[i], expected[i], 1.0e-4*(1.0+fabs(expected[4])))
+        << "component " << i;
+    }
+  }
+}
+
+// At low Mach number with a small cutoff Mach number the pressures, rounded to
+// single precision after the ambient pressure is added, differ from the double
+// ones by a few units of 1e-7*Pambient, and the pressure diffusion of the mass
+// flux scales that error by 1/M0. The fluxes stay close relative to the scales
+// of a flow at a few m/s.
+TEST(AUSMPlusUpFluxMultiSpeciesIdealGas, SinglePrecisionIsCloseAtLowMach) {
+  double const Pambient = 101325.0;
+  int const Ns = 4;
+  double const Umax = 5.0;
+
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  for(int k = 0; k < 256; ++k) {
+    std::vector<double> Yl(Ns), Yr(Ns);
+    for(int i = 0; i < Ns; ++i) {
+      Yl[i] = 0.25+0.2*dist(gen);
+      Yr[i] = 0.25+0.2*dist(gen);
+    }
+
+    Loci::vector3d<double> const Ul(Umax*dist(gen), Umax*dist(gen), Umax*dist(gen));
+    Loci::vector3d<double> const Ur(Umax*dist(gen), Umax*dist(gen), Umax*dist(gen));
+    Loci::vector3d<double> const n(0.6, 0.8, 0.0);
+    double const Pgl = 20.0*dist(gen), Tl = 300.0+5.0*dist(gen);
+    double const Pgr = 20.0*dist(gen), Tr = 300.0+5.0*dist(gen);
+
+    std::vector<double> expected(Ns+4), actual(Ns+4);
+    AUSMPlusUpFluxMultiSpeciesIdealGas(
+      expected.data(), Ns,
+      Yl.data(), Ul, Pgl, Tl, 287.0, 1005.0,
+      Yr.data(), Ur, Pgr, Tr, 290.0, 1010.0,
+      1.0, n, Pambient, 0.01
+    );
+    AUSMPlusUpFluxMultiSpeciesIdealGasSP(
+      actual.data(), Ns,
+      Yl.data(), Ul, Pgl, Tl, 287.0, 1005.0,
+      Yr.data(), Ur, Pgr, Tr, 290.0, 1010.0,
+      1.0, n, Pambient, 0.01
+    );
+
+    double const mdot = 1.2*Umax;
+    for(int i = 0; i < 3; ++i) {
+      EXPECT_NEAR(actual[i], expected[i], 1.0e-6*Pambient) << "component " << i;
+    }
+    EXPECT_NEAR(actual[3], expected[3], 1.0e-4*mdot*1010.0*300.0);
+    for(int i = 4; i < Ns+4; ++i) {
+      EXPECT_NEAR(actual[i], expected[i], 1.0e-4*mdot) << "component " << i;
+    }
+  }
+}
+
+TEST(AUSMPlusUpFluxIdealGas, AutoCutoffMach) {
+  double const rho = 1.2, a2 = 340.0*340.0;
+
+  // Quiescent flow without pressure jump keeps the reference value.
+  EXPECT_DOUBLE_EQ(autoCutoffMach(0.05, 0.0, 0.0, rho, a2), 0.05);
+
+  // Local Mach number above the reference value.
+  EXPECT_NEAR(autoCutoffMach(0.05, 34.0*34.0, 0.0, rho, a2), 0.1, 1.0e-12);
+
+  // Pressure jump of rho*a2*M^2 gives Mach number M.
+  EXPECT_NEAR(autoCutoffMach(0.05, 0.0, -0.04*rho*a2, rho, a2), 0.2, 1.0e-12);
+
+  // Limited to 1.
+  EXPECT_DOUBLE_EQ(autoCutoffMach(0.05, 4.0*a2, 0.0, rho, a2), 1.0);
+}
+
+TEST(KEPCentralFluxIdealGas, UniformStateGivesEulerFlux) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+
+  Loci::vector3d<double> const U(120.0, -30.0, 45.0);
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+  double const Pg = 2.0e4, T = 350.0, area = 0.3;
+
+  Loci::Array<double, 5> flux;
+  KEPCentralFluxIdealGas(flux, U, Pg, T, U, Pg, T, area, n, Pambient, Rtilde, Cp);
+
+  double const rho = (Pg+Pambient)/(Rtilde*T);
+  double const mdot = area*rho*dot(U, n);
+  EXPECT_NEAR(flux[0], mdot*U.x+area*Pg*n.x, 1.0e-9*fabs(flux[0]));
+  EXPECT_NEAR(flux[1], mdot*U.y+area*Pg*n.y, 1.0e-9*fabs(flux[1]));
+  EXPECT_NEAR(flux[2], mdot*U.z+area*Pg*n.z, 1.0e-9*fabs(flux[2]));
+  EXPECT_NEAR(flux[3], mdot*(Cp*T+0.5*dot(U, U)), 1.0e-9*fabs(flux[3]));
+  EXPECT_NEAR(flux[4], mdot, 1.0e-12*fabs(mdot));
+}
+
+TEST(KEPCentralFluxIdealGas, IsSymmetric) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+
+  Loci::vector3d<double> const Ul(120.0, -30.0, 45.0), Ur(80.0, 10.0, -5.0);
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+
+  // The flux from left to right equals minus the flux from right to left.
+  Loci::Array<double, 5> flux, fluxReversed;
+  KEPCentralFluxIdealGas(flux, Ul, 2.0e4, 350.0, Ur, -1.0e4, 300.0, 1.0, n, Pambient, Rtilde, Cp);
+  KEPCentralFluxIdealGas(
+    fluxReversed, Ur, -1.0e4, 300.0, Ul, 2.0e4, 350.0, 1.0,
+    Loci::vector3d<double>(-n.x, -n.y, -n.z), Pambient, Rtilde, Cp
+  );
+
+  for(int j = 0; j < 5; ++j) {
+    EXPECT_NEAR(flux[j], -fluxReversed[j], 1.0e-9*(1.0+fabs(flux[j]))) << "component " << j;
+  }
+}
+
+TEST(KEPCentralFluxMultiSpeciesIdealGas, MatchesSingleSpecies) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+  int const Ns = 3;
+  double const Yl[Ns] = {0.2, 0.3, 0.5}, Yr[Ns] = {0.1, 0.6, 0.3};
+
+  Loci::vector3d<double> const Ul(120.0, -30.0, 45.0), Ur(80.0, 10.0, -5.0);
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+
+  // With equal gas constants and specific heats the mixture flux reduces to
+  // the single-species flux and the species are carried with the mass flux.
+  Loci::Array<double, 5> expected;
+  KEPCentralFluxIdealGas(expected, Ul, 2.0e4, 350.0, Ur, -1.0e4, 300.0, 0.5, n, Pambient, Rtilde, Cp);
+
+  double flux[Ns+4];
+  KEPCentralFluxMultiSpeciesIdealGas(
+    flux, Ns,
+    Yl, Ul, 2.0e4, 350.0, Rtilde, Cp,
+    Yr, Ur, -1.0e4, 300.0, Rtilde, Cp,
+    0.5, n, Pambient
+  );
+
+  for(int j = 0; j < 5; ++j) {
+    EXPECT_NEAR(flux[j], expected[j], 1.0e-9*(1.0+fabs(expected[j]))) << "component " << j;
+  }
+  for(int i = 0; i < Ns-1; ++i) {
+    EXPECT_NEAR(flux[5+i], expected[4]*0.5*(Yl[i]+Yr[i]), 1.0e-12) << "species " << i;
+  }
+}
+
+TEST(DucrosSensor, SeparatesCompressionFromRotation) {
+  // Solid body rotation about z.
+  Loci::tensor3d<double> rotation;
+  rotation.x = Loci::vector3d<double>(0.0, -100.0, 0.0);
+  rotation.y = Loci::vector3d<double>(100.0, 0.0, 0.0);
+  rotation.z = Loci::vector3d<double>(0.0, 0.0, 0.0);
+  EXPECT_NEAR(ducrosSensor(rotation, 200.0), 0.0, 1.0e-12);
+
+  // Normal shock along x.
+  Loci::tensor3d<double> compression;
+  compression.x = Loci::vector3d<double>(-1.0e6, 0.0, 0.0);
+  compression.y = Loci::vector3d<double>(0.0, 0.0, 0.0);
+  compression.z = Loci::vector3d<double>(0.0, 0.0, 0.0);
+  EXPECT_NEAR(ducrosSensor(compression, 0.0), 1.0, 1.0e-12);
+}
+
+TEST(ConvectiveFluxSchemeList, FindsBuiltInSchemes) {
+  char const * const names[] = {"ausmPlusUp", "hllc", "rusanov"};
+  for(char const * name : names) {
+    ConvectiveFluxScheme const * scheme = ConvectiveFluxSchemeList::find(name);
+    ASSERT_NE(scheme, nullptr) << name;
+    EXPECT_EQ(std::string(scheme->name), name);
+    EXPECT_NE(ConvectiveFluxSchemeList::names().find(name), std::string::npos) << name;
+  }
+  EXPECT_EQ(ConvectiveFluxSchemeList::find("hybrid"), nullptr);
+  EXPECT_EQ(ConvectiveFluxSchemeList::find("unknown"), nullptr);
+}
+
+TEST(ConvectiveFluxSchemeList, UniformStateGivesEulerFlux) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+  double const Pg = 2.0e4, T = 350.0, area = 0.3;
+
+  // Subsonic, and supersonic in both directions.
+  double const speeds[] = {120.0, 900.0, -900.0};
+  char const * const names[] = {"ausmPlusUp", "hllc", "rusanov"};
+  for(char const * name : names) {
+    IdealGasFluxFunction const flux_fn = ConvectiveFluxSchemeList::find(name)->singleSpecies;
+    for(double const s : speeds) {
+      Loci::vector3d<double> const U(s*n.x+20.0, s*n.y-20.0, s*n.z);
+      Loci::Array<double, 5> flux;
+      flux_fn(flux, U, Pg, T, U, Pg, T, area, n, Pambient, Rtilde, Cp, 1.0);
+
+      double const rho = (Pg+Pambient)/(Rtilde*T);
+      double const mdot = area*rho*dot(U, n);
+      double const tol = 1.0e-9*fabs(mdot)*(fabs(s)+Cp*T);
+      EXPECT_NEAR(flux[0], mdot*U.x+area*Pg*n.x, tol) << name << " " << s;
+      EXPECT_NEAR(flux[1], mdot*U.y+area*Pg*n.y, tol) << name << " " << s;
+      EXPECT_NEAR(flux[2], mdot*U.z+area*Pg*n.z, tol) << name << " " << s;
+      EXPECT_NEAR(flux[3], mdot*(Cp*T+0.5*dot(U, U)), tol) << name << " " << s;
+      EXPECT_NEAR(flux[4], mdot, 1.0e-9*fabs(mdot)) << name << " " << s;
+    }
+  }
+}
+
+TEST(ConvectiveFluxSchemeList, IsSymmetric) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+
+  Loci::vector3d<double> const Ul(120.0, -30.0, 45.0), Ur(80.0, 10.0, -5.0);
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+  Loci::vector3d<double> const nReversed(-n.x, -n.y, -n.z);
+
+  char const * const names[] = {"hllc", "rusanov"};
+  for(char const * name : names) {
+    IdealGasFluxFunction const flux_fn = ConvectiveFluxSchemeList::find(name)->singleSpecies;
+    Loci::Array<double, 5> flux, fluxReversed;
+    flux_fn(flux, Ul, 2.0e4, 350.0, Ur, -1.0e4, 300.0, 1.0, n, Pambient, Rtilde, Cp, 1.0);
+    flux_fn(fluxReversed, Ur, -1.0e4, 300.0, Ul, 2.0e4, 350.0, 1.0, nReversed, Pambient, Rtilde, Cp, 1.0);
+
+    for(int j = 0; j < 5; ++j) {
+      EXPECT_NEAR(flux[j], -fluxReversed[j], 1.0e-9*(1.0+fabs(flux[j])))
+        << name << " component " << j;
+    }
+  }
+}
+
+TEST(HLLCFluxIdealGas, ResolvesStationaryContact) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+  Loci::vector3d<double> const U(0.0, 0.0, 0.0), n(1.0, 0.0, 0.0);
+
+  // A temperature jump at rest is a steady contact: HLLC adds no dissipation
+  // across it, while the Rusanov flux diffuses it.
+  Loci::Array<double, 5> hllc, rusanov;
+  HLLCFluxIdealGas(hllc, U, 0.0, 300.0, U, 0.0, 1500.0, 1.0, n, Pambient, Rtilde, Cp, 1.0);
+  RusanovFluxIdealGas(rusanov, U, 0.0, 300.0, U, 0.0, 1500.0, 1.0, n, Pambient, Rtilde, Cp, 1.0);
+
+  EXPECT_NEAR(hllc[4], 0.0, 1.0e-12);
+  EXPECT_NEAR(hllc[3], 0.0, 1.0e-6);
+  EXPECT_GT(rusanov[4], 1.0);
+}
+
+TEST(ConvectiveFluxSchemeList, MultiSpeciesMatchesSingleSpecies) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+  int const Ns = 3;
+  double const Yl[Ns] = {0.2, 0.3, 0.5}, Yr[Ns] = {0.1, 0.6, 0.3};
+
+  Loci::vector3d<double> const Ul(120.0, -30.0, 45.0), Ur(80.0, 10.0, -5.0);
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+
+  // With equal gas constants and specific heats the mixture flux reduces to
+  // the single-species flux.
+  char const * const names[] = {"hllc", "rusanov"};
+  for(char const * name : names) {
+    ConvectiveFluxScheme const * scheme = ConvectiveFluxSchemeList::find(name);
+    Loci::Array<double, 5> expected;
+    scheme->singleSpecies(expected, Ul, 2.0e4, 350.0, Ur, -1.0e4, 300.0, 0.5, n, Pambient, Rtilde, Cp, 1.0);
+
+    double flux[Ns+4];
+    scheme->selectMultiSpecies(Ns)(
+      flux, Ns,
+      Yl, Ul, 2.0e4, 350.0, Rtilde, Cp,
+      Yr, Ur, -1.0e4, 300.0, Rtilde, Cp,
+      0.5, n, Pambient, 1.0
+    );
+
+    for(int j = 0; j < 5; ++j) {
+      EXPECT_NEAR(flux[j], expected[j], 1.0e-9*(1.0+fabs(expected[j])))
+        << name << " component " << j;
+    }
+  }
+
+  // Uniform composition is carried with the mass flux.
+  for(char const * name : names) {
+    ConvectiveFluxScheme const * scheme = ConvectiveFluxSchemeList::find(name);
+    double flux[Ns+4];
+    scheme->selectMultiSpecies(Ns)(
+      flux, Ns,
+      Yl, Ul, 2.0e4, 350.0, Rtilde, Cp,
+      Yl, Ur, -1.0e4, 300.0, Rtilde, Cp,
+      0.5, n, Pambient, 1.0
+    );
+    for(int i = 0; i < Ns-1; ++i) {
+      EXPECT_NEAR(flux[5+i], flux[4]*Yl[i], 1.0e-9*(1.0+fabs(flux[4]))) << name << " species " << i;
+    }
+  }
+}
+
+TEST(AUSMPlusUpFluxIdealGas, SupersonicInflowDependsOnlyOnInflowState) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+
+  // Reference state entering the face (against n) at Mach 2.5.
+  double const Pgr = 3.0e4, Tr = 250.0;
+  double const ar = std::sqrt(Cp/(Cp-Rtilde)*Rtilde*Tr);
+  Loci::vector3d<double> const Ur(-2.5*ar*n.x+10.0, -2.5*ar*n.y-10.0, -2.5*ar*n.z);
+
+  Loci::Array<double, 5> expected;
+  AUSMPlusUpFluxIdealGas(expected, Ur, Pgr, Tr, Ur, Pgr, Tr, 0.7, n, Pambient, Rtilde, Cp, 0.1);
+
+  // Any interior state that also enters the face supersonically gives the
+  // flux of the reference state, which supersonic inflow faces cache.
+  Loci::vector3d<double> const Ul(-700.0*n.x, -700.0*n.y+5.0, -700.0*n.z);
+  Loci::Array<double, 5> flux;
+  AUSMPlusUpFluxIdealGas(flux, Ul, -1.0e4, 230.0, Ur, Pgr, Tr, 0.7, n, Pambient, Rtilde, Cp, 0.1);
+
+  double const gamma = Cp/(Cp-Rtilde);
+  double const h0r = Cp*Tr+0.5*dot(Ur, Ur);
+  EXPECT_TRUE(AUSMPlusUpRightSupersonic(dot(Ur, n), h0r, gamma, dot(Ur, n), h0r, gamma));
+  EXPECT_TRUE(AUSMPlusUpRightSupersonic(dot(Ul, n), Cp*230.0+0.5*dot(Ul, Ul), gamma, dot(Ur, n), h0r, gamma));
+
+  for(int j = 0; j < 5; ++j) {
+    EXPECT_NEAR(flux[j], expected[j], 1.0e-9*(1.0+fabs(expected[j]))) << "component " << j;
+  }
+}
+
+TEST(AUSMPlusUpFluxIdealGas, SupersonicInflowWithSubsonicInterior) {
+  double const Pambient = 101325.0;
+  double const Rtilde = 287.0;
+  double const Cp = 1005.0;
+  double const gamma = Cp/(Cp-Rtilde);
+  Loci::vector3d<double> const n(0.48, 0.6, 0.64);
+
+  // Reference state entering the face at Mach 2.5.
+  double const Pgr = 3.0e4, Tr = 250.0;
+  double const ar = std::sqrt(gamma*Rtilde*Tr);
+  Loci::vector3d<double> const Ur(-2.5*ar*n.x+10.0, -2.5*ar*n.y-10.0, -2.5*ar*n.z);
+  double const h0r = Cp*Tr+0.5*dot(Ur, Ur);
+  ASSERT_TRUE(AUSMPlusUpRightSupersonic(dot(Ur, n), h0r, gamma, dot(Ur, n), h0r, gamma));
+
+  Loci::Array<double, 5> cached;
+  AUSMPlusUpFluxIdealGas(cached, Ur, Pgr, Tr, Ur, Pgr, Tr, 0.7, n, Pambient, Rtilde, Cp, 0.1);
+
+  // A subsonic interior state, e.g. at rest at startup or behind a shock that
+  // reached the boundary, changes the flux, so the cached flux must not be
+  // used.
+  double const Tls[2] = {300.0, 800.0};
+  Loci::vector3d<double> const Uls[2] = {
+    Loci::vector3d<double>(0.0, 0.0, 0.0),
+    Loci::vector3d<double>(-200.0*n.x, -200.0*n.y, -200.0*n.z)
+  };
+  for(int i = 0; i < 2; ++i) {
+    double const h0l = Cp*Tls[i]+0.5*dot(Uls[i], Uls[i]);
+    EXPECT_FALSE(AUSMPlusUpRightSupersonic(dot(Uls[i], n), h0l, gamma, dot(Ur, n), h0r, gamma));
+
+    Loci::Array<double, 5> flux;
+    AUSMPlusUpFluxIdealGas(flux, Uls[i], 1.0e5, Tls[i], Ur, Pgr, Tr, 0.7, n, Pambient, Rtilde, Cp, 0.1);
+    double difference = 0.0;
+    for(int j = 0; j < 5; ++j) {
+      difference = std::max(difference, fabs(flux[j]-cached[j])/(1.0+fabs(cached[j])));
+    }
+    EXPECT_GT(difference, 1.0e-3) << "interior state " << i;
+  }
+}
+
+TEST(AUSMPlusUpFluxMultiSpeciesThermallyPerfectGas, AddsUpwindEnthalpyOffset) {
+  double const Pambient = 101325.0;
+  int const Ns = 3;
+  double const Yl[Ns] = {0.2, 0.7, 0.1};
+  double const Yr[Ns] = {0.3, 0.6, 0.1};
+  double const hOffsetl = -2.0e5, hOffsetr = 3.0e5;
+  Loci::vector3d<double> const n(0.6, 0.8, 0.0);
+
+  // Flow from left to right and from right to left.
+  for(double const sign : {1.0, -1.0}) {
+    Loci::vector3d<double> const Ul(sign*80.0, sign*60.0, 10.0);
+    Loci::vector3d<double> const Ur(sign*70.0, sign*50.0, -5.0);
+
+    std::vector<double> expected(Ns+4), actual(Ns+4);
+    AUSMPlusUpFluxMultiSpeciesIdealGas(
+      expected.data(), Ns,
+      Yl, Ul, 2.0e3, 900.0, 290.0, 1150.0,
+      Yr, Ur, -1.0e3, 850.0, 295.0, 1140.0,
+      1.0, n, Pambient, 0.1
+    );
+    AUSMPlusUpFluxMultiSpeciesThermallyPerfectGas(
+      actual.data(), Ns,
+      Yl, Ul, 2.0e3, 900.0, 290.0, 1150.0, hOffsetl,
+      Yr, Ur, -1.0e3, 850.0, 295.0, 1140.0, hOffsetr,
+      1.0, n, Pambient, 0.1
+    );
+
+    double const hOffset = sign > 0.0 ? hOffsetl : hOffsetr;
+    EXPECT_EQ(expected[4] > 0.0, sign > 0.0);
+    EXPECT_NEAR(actual[3], expected[3]+expected[4]*hOffset, 1.0e-9*fabs(expected[4]*hOffset));
+    for(int i = 0; i < Ns+4; ++i) {
+      if(i != 3) {
+        EXPECT_EQ(actual[i], expected[i]) << "component " << i;
+      }
+    }
+  }
+}
+
+TEST(ViscousFlux, CouetteFlow) {
+  // Velocity u(y) = g*y and temperature T(y) = Ty*y through a face normal to
+  // y of area 2.
+  double const g = 300.0, Ty = -50.0, mu = 1.8e-5, k = 0.026;
+  Loci::tensor3d<double> gradU(
+    Loci::vector3d<double>(0.0, g, 0.0),
+    Loci::vector3d<double>(0.0, 0.0, 0.0),
+    Loci::vector3d<double>(0.0, 0.0, 0.0)
+  );
+  Loci::vector3d<double> const gradT(0.0, Ty, 0.0);
+  Loci::vector3d<double> const U(12.0, 0.0, 0.0);
+  Loci::vector3d<double> const n(0.0, 1.0, 0.0);
+
+  SymmetricTensor tau;
+  computeShearStress(tau, gradU, mu);
+  EXPECT_DOUBLE_EQ(tau.xy, mu*g);
+  EXPECT_EQ(tau.xx, 0.0);
+  EXPECT_EQ(tau.yy, 0.0);
+
+  double flux[4];
+  computeViscousFlux(flux, gradU, mu, gradT, k, U, 2.0, n);
+  EXPECT_DOUBLE_EQ(flux[0], 2.0*mu*g);
+  EXPECT_EQ(flux[1], 0.0);
+  EXPECT_EQ(flux[2], 0.0);
+  EXPECT_DOUBLE_EQ(flux[3], 12.0*2.0*mu*g + 2.0*k*Ty);
+
+  // The flux from the stored shear force and heat, as the viscousFlux_f rule
+  // computes it, is the same.
+  double stored[4];
+  computeViscousFlux(
+    stored, computeShearForce(tau, 2.0, n), U, computeHeatFlux(gradT, k, 2.0, n)
+  );
+  for(int i = 0; i < 4; ++i) {
+    EXPECT_EQ(stored[i], flux[i]) << "component " << i;
+  }
+}
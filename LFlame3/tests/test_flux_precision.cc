@@ -0,0 +1,308 @@
+#include <flux.hh>
+#include <eos.hh>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+using namespace flame;
+
+// Runs of a first order finite volume scheme for a single-species ideal gas
+// on a uniform two dimensional grid with the batched AUSM+up kernel in double
+// and in single precision. As in the solver, the primitive variables of the
+// cells are computed in double precision once per stage, with the gage
+// pressure P-Pambient of eos_TP_P_from_r_T_R, and are rounded to float only
+// when gathered into the face block; residual accumulation and time
+// integration are in double precision. Reconstruction, boundary fluxes and
+// the Loci rules of fluxPrecision are not exercised.
+
+namespace {
+
+double const Rtilde = 287.0;
+double const Cp = 1004.5;
+double const Cv = Cp-Rtilde;
+double const gamma_ = Cp/Cv;
+
+// Conservative state of a cell: density, momentum x, y and total energy.
+struct State {
+  double rho, mx, my, E;
+};
+
+// Primitive variables of a cell as the solver stores them.
+struct Primitive {
+  double u, v, Pg, T;
+};
+
+struct Case {
+  int nx, ny;
+  double h;
+  bool periodicX;
+  double Pambient;
+  double tEnd;
+  std::vector<State> U;
+};
+
+void primitives(
+  std::vector<State> const & U, double const Pambient, std::vector<Primitive> & W
+) {
+  W.resize(U.size());
+  for(std::size_t i = 0; i < U.size(); ++i) {
+    Primitive & w = W[i];
+    w.u = U[i].mx/U[i].rho;
+    w.v = U[i].my/U[i].rho;
+    w.T = (U[i].E/U[i].rho-0.5*(w.u*w.u+w.v*w.v))/Cv;
+    w.Pg = eos_TP_P_from_r_T_R(U[i].rho, w.T, Rtilde)-Pambient;
+  }
+}
+
+// Cell on the other side of a face. Outside a non-periodic boundary the cell
+// next to the boundary is returned, which gives a zero gradient boundary.
+int neighbor(int const i, int const n, bool const periodic) {
+  if(i < 0) {
+    return periodic ? i+n : 0;
+  }
+  if(i >= n) {
+    return periodic ? i-n : n-1;
+  }
+  return i;
+}
+
+// Adds the convective flux of all faces to residual R. Faces are gathered in
+// blocks of type Block, whose precision selects the flux precision.
+template<typename Block>
+void residual(Case const & c, std::vector<State> const & U, std::vector<State> & R) {
+  typedef typename std::remove_reference<decltype(Block::Ulx[0])>::type T;
+
+  std::vector<Primitive> W;
+  primitives(U, c.Pambient, W);
+  std::fill(R.begin(), R.end(), State{0.0, 0.0, 0.0, 0.0});
+
+  // Faces normal to x (dir 0) and to y (dir 1). Face (i, j) of dir 0 lies
+  // between cells (i-1, j) and (i, j); y is always periodic. The flux of a
+  // boundary face is added only to the cell inside the domain.
+  struct Face {
+    int l, r, dir;
+    bool boundaryL, boundaryR;
+  };
+  std::vector<Face> faces;
+  for(int j = 0; j < c.ny; ++j) {
+    for(int i = 0; i <= c.nx; ++i) {
+      if(c.periodicX && i == c.nx) {
+        continue;
+      }
+      faces.push_back(Face{
+        j*c.nx+neighbor(i-1, c.nx, c.periodicX),
+        j*c.nx+neighbor(i, c.nx, c.periodicX), 0,
+        !c.periodicX && i == 0, !c.periodicX && i == c.nx
+      });
+    }
+  }
+  for(int j = 0; j < c.ny; ++j) {
+    for(int i = 0; i < c.nx; ++i) {
+      faces.push_back(Face{neighbor(j-1, c.ny, true)*c.nx+i, j*c.nx+i, 1, false, false});
+    }
+  }
+
+  Block block;
+  std::size_t f0 = 0;
+  while(f0 < faces.size()) {
+    int const n = std::min<std::size_t>(FLAME_FLUX_BLOCK_SIZE, faces.size()-f0);
+    for(int k = 0; k < n; ++k) {
+      Face const & face = faces[f0+k];
+      Primitive const & wl = W[face.l];
+      Primitive const & wr = W[face.r];
+      block.Ulx[k] = T(wl.u);
+      block.Uly[k] = T(wl.v);
+      block.Ulz[k] = T(0);
+      block.Pgl[k] = T(wl.Pg);
+      block.Tl[k] = T(wl.T);
+      block.Urx[k] = T(wr.u);
+      block.Ury[k] = T(wr.v);
+      block.Urz[k] = T(0);
+      block.Pgr[k] = T(wr.Pg);
+      block.Tr[k] = T(wr.T);
+      block.area_sada[k] = T(c.h);
+      block.area_nx[k] = T(face.dir == 0 ? 1 : 0);
+      block.area_ny[k] = T(face.dir == 1 ? 1 : 0);
+      block.area_nz[k] = T(0);
+      block.Minf[k] = T(1);
+    }
+
+    AUSMPlusUpFluxIdealGasBlock(block, n, c.Pambient, Rtilde, Cp);
+
+    for(int k = 0; k < n; ++k) {
+      Face const & face = faces[f0+k];
+      State const flux = {
+        double(block.flux[4][k]), double(block.flux[0][k]),
+        double(block.flux[1][k]), double(block.flux[3][k])
+      };
+      if(!face.boundaryL) {
+        State & Rl = R[face.l];
+        Rl.rho -= flux.rho; Rl.mx -= flux.mx; Rl.my -= flux.my; Rl.E -= flux.E;
+      }
+      if(!face.boundaryR) {
+        State & Rr = R[face.r];
+        Rr.rho += flux.rho; Rr.mx += flux.mx; Rr.my += flux.my; Rr.E += flux.E;
+      }
+    }
+
+    f0 += n;
+  }
+}
+
+// Advances the case to tEnd with the two stage strong stability preserving
+// Runge-Kutta scheme in double precision.
+template<typename Block>
+std::vector<State> run(Case const & c) {
+  double const cfl = 0.4;
+  double const vol = c.h*c.h;
+
+  std::vector<State> U = c.U, U1(U.size()), R(U.size());
+  std::vector<Primitive> W;
+  double t = 0.0;
+  while(t < c.tEnd) {
+    primitives(U, c.Pambient, W);
+    double smax = 0.0;
+    for(std::size_t i = 0; i < W.size(); ++i) {
+      smax = std::max(
+        smax, std::sqrt(W[i].u*W[i].u+W[i].v*W[i].v)+std::sqrt(gamma_*Rtilde*W[i].T)
+      );
+    }
+    double const dt = std::min(cfl*c.h/smax, c.tEnd-t);
+    double const a = dt/vol;
+
+    residual<Block>(c, U, R);
+    for(std::size_t i = 0; i < U.size(); ++i) {
+      U1[i].rho = U[i].rho+a*R[i].rho;
+      U1[i].mx = U[i].mx+a*R[i].mx;
+      U1[i].my = U[i].my+a*R[i].my;
+      U1[i].E = U[i].E+a*R[i].E;
+    }
+
+    residual<Block>(c, U1, R);
+    for(std::size_t i = 0; i < U.size(); ++i) {
+      U[i].rho = 0.5*(U[i].rho+U1[i].rho+a*R[i].rho);
+      U[i].mx = 0.5*(U[i].mx+U1[i].mx+a*R[i].mx);
+      U[i].my = 0.5*(U[i].my+U1[i].my+a*R[i].my);
+      U[i].E = 0.5*(U[i].E+U1[i].E+a*R[i].E);
+    }
+
+    t += dt;
+  }
+
+  return U;
+}
+
+State conservative(double const rho, double const u, double const v, double const T) {
+  return State{rho, rho*u, rho*v, rho*(Cv*T+0.5*(u*u+v*v))};
+}
+
+// Isentropic vortex of strength beta advected diagonally across a periodic
+// domain of 10 m by 10 m. Velocity is scaled with sqrt(Rtilde*Tinf).
+void isentropicVortex(Case const & c, double const t, std::vector<State> & U) {
+  double const beta = 5.0;
+  double const Pinf = 1.0e5, Tinf = 300.0;
+  double const rhoinf = Pinf/(Rtilde*Tinf);
+  double const a = std::sqrt(Rtilde*Tinf);
+  double const uinf = a, vinf = a;
+  double const L = c.nx*c.h;
+
+  U.resize(c.nx*c.ny);
+  for(int j = 0; j < c.ny; ++j) {
+    for(int i = 0; i < c.nx; ++i) {
+      // Distance to the nearest periodic image of the vortex center.
+      double dx = (i+0.5)*c.h-(0.5*L+uinf*t);
+      double dy = (j+0.5)*c.h-(0.5*L+vinf*t);
+      dx -= L*std::round(dx/L);
+      dy -= L*std::round(dy/L);
+
+      double const r2 = dx*dx+dy*dy;
+      double const e = std::exp(0.5*(1.0-r2));
+      double const du = -beta/(2.0*M_PI)*dy*e;
+      double const dv = beta/(2.0*M_PI)*dx*e;
+      double const dT = -(gamma_-1.0)*beta*beta/(8.0*gamma_*M_PI*M_PI)*e*e;
+
+      double const T = Tinf*(1.0+dT);
+      double const rho = rhoinf*std::pow(1.0+dT, 1.0/(gamma_-1.0));
+      U[j*c.nx+i] = conservative(rho, uinf+a*du, vinf+a*dv, T);
+    }
+  }
+}
+
+// L1 norm of the density difference divided by the L1 norm of density.
+double densityL1(std::vector<State> const & a, std::vector<State> const & b) {
+  double diff = 0.0, norm = 0.0;
+  for(std::size_t i = 0; i < a.size(); ++i) {
+    diff += std::fabs(a[i].rho-b[i].rho);
+    norm += std::fabs(b[i].rho);
+  }
+  return diff/norm;
+}
+
+double totalEnergy(std::vector<State> const & U) {
+  double sum = 0.0;
+  for(std::size_t i = 0; i < U.size(); ++i) {
+    sum += U[i].E;
+  }
+  return sum;
+}
+
+} // end: anonymous namespace
+
+// Sod shock tube along x with the pressure ratio 10 and temperature ratio
+// 1.25. No exact solution is used, the single precision run is compared with
+// the double precision run.
+TEST(FluxPrecision, ShockTube) {
+  Case c;
+  c.nx = 400;
+  c.ny = 2;
+  c.h = 1.0/c.nx;
+  c.periodicX = false;
+  c.Pambient = 101325.0;
+  c.tEnd = 3.5e-4;
+  for(int j = 0; j < c.ny; ++j) {
+    for(int i = 0; i < c.nx; ++i) {
+      double const x = (i+0.5)*c.h;
+      double const P = x < 0.5 ? 1.0e5 : 1.0e4;
+      double const T = x < 0.5 ? 348.4 : 278.7;
+      c.U.push_back(conservative(P/(Rtilde*T), 0.0, 0.0, T));
+    }
+  }
+
+  std::vector<State> const Ud = run<IdealGasFaceBlock>(c);
+  std::vector<State> const Us = run<IdealGasFaceBlockSP>(c);
+
+  EXPECT_LT(densityL1(Us, Ud), 1.0e-6);
+}
+
+// The difference between the runs is small compared with the discretization
+// error of the double precision run. The domain is periodic, so total energy
+// is conserved by both runs.
+TEST(FluxPrecision, IsentropicVortex) {
+  Case c;
+  c.nx = 80;
+  c.ny = 80;
+  c.h = 10.0/c.nx;
+  c.periodicX = true;
+  c.Pambient = 101325.0;
+  c.tEnd = 0.25*10.0/std::sqrt(Rtilde*300.0);
+  isentropicVortex(c, 0.0, c.U);
+
+  std::vector<State> exact;
+  isentropicVortex(c, c.tEnd, exact);
+
+  std::vector<State> const Ud = run<IdealGasFaceBlock>(c);
+  std::vector<State> const Us = run<IdealGasFaceBlockSP>(c);
+
+  double const errd = densityL1(Ud, exact);
+  EXPECT_LT(errd, 0.05);
+  EXPECT_LT(densityL1(Us, exact), 0.05);
+  EXPECT_LT(densityL1(Us, Ud), 1.0e-3*errd);
+
+  double const E0 = totalEnergy(c.U);
+  EXPECT_LT(std::fabs(totalEnergy(Ud)-E0), 1.0e-12*E0);
+  EXPECT_LT(std::fabs(totalEnergy(Us)-E0), 1.0e-12*E0);
+}
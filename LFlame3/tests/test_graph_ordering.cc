@@ -0,0 +1,85 @@
+#include <graph_ordering.hh>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+// Edges of an nx by ny grid graph with vertices numbered randomly.
+std::vector<std::pair<int, int>> shuffledGridEdges(int const nx, int const ny) {
+  std::vector<int> number(nx*ny);
+  std::iota(number.begin(), number.end(), 0);
+  std::shuffle(number.begin(), number.end(), std::mt19937(1));
+
+  std::vector<std::pair<int, int>> edges;
+  for(int i = 0; i < nx; ++i) {
+    for(int j = 0; j < ny; ++j) {
+      if(i+1 < nx) {
+        edges.push_back(std::make_pair(number[i*ny+j], number[(i+1)*ny+j]));
+      }
+      if(j+1 < ny) {
+        edges.push_back(std::make_pair(number[i*ny+j], number[i*ny+j+1]));
+      }
+    }
+  }
+  return edges;
+}
+
+void expectPermutation(std::vector<int> const & order, int const n) {
+  ASSERT_EQ(int(order.size()), n);
+  std::vector<int> sorted(order);
+  std::sort(sorted.begin(), sorted.end());
+  for(int i = 0; i < n; ++i) {
+    ASSERT_EQ(sorted[i], i);
+  }
+}
+
+} // end: anonymous namespace
+
+TEST(ReverseCuthillMcKee, PathHasUnitBandwidth) {
+  std::vector<std::pair<int, int>> const edges = shuffledGridEdges(50, 1);
+
+  AdjacencyGraph graph;
+  createAdjacencyGraph(50, edges, graph);
+
+  std::vector<int> order;
+  reverseCuthillMcKeeOrder(graph, order);
+
+  expectPermutation(order, 50);
+  EXPECT_GT(graphBandwidth(graph, std::vector<int>()), 1);
+  EXPECT_EQ(graphBandwidth(graph, order), 1);
+}
+
+TEST(ReverseCuthillMcKee, GridBandwidthNearShortSide) {
+  int const nx = 40, ny = 12;
+  std::vector<std::pair<int, int>> const edges = shuffledGridEdges(nx, ny);
+
+  AdjacencyGraph graph;
+  createAdjacencyGraph(nx*ny, edges, graph);
+
+  std::vector<int> order;
+  reverseCuthillMcKeeOrder(graph, order);
+
+  expectPermutation(order, nx*ny);
+  EXPECT_LE(graphBandwidth(graph, order), ny+1);
+}
+
+TEST(ReverseCuthillMcKee, OrdersAllComponents) {
+  // Two paths and an isolated vertex.
+  std::vector<std::pair<int, int>> const edges = {{0, 4}, {4, 2}, {1, 5}, {5, 6}};
+
+  AdjacencyGraph graph;
+  createAdjacencyGraph(7, edges, graph);
+
+  std::vector<int> order;
+  reverseCuthillMcKeeOrder(graph, order);
+
+  expectPermutation(order, 7);
+  EXPECT_EQ(graphBandwidth(graph, order), 1);
+}
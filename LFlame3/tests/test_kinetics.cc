@@ -0,0 +1,415 @@
+#include <kinetics.hh>
+#include <nasa9.hh>
+
+#include "kinetics_test_helpers.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace flame;
+using namespace flame::test;
+
+namespace {
+
+// Keeps only reaction r of the mixture.
+void keepReaction(Mixture & mixture, int const r) {
+  mixture.reactions[0] = mixture.reactions[r];
+  mixture.nReactions = 1;
+}
+
+// Production rates of one cell.
+std::vector<double> productionRates(
+  Mixture const & mixture, double const rho, double const T,
+  std::vector<double> const & Y
+) {
+  KineticsTable table;
+  KineticsWorkspace work;
+  initKineticsTable(table, mixture, Runiv);
+  initKineticsWorkspace(work, table);
+
+  int const Ns = mixture.nSpecies;
+  std::vector<double> Yb(Ns*B, 0.0), omegab(Ns*B, 0.0);
+  for(int s = 0; s < Ns; ++s) {
+    Yb[s*B] = Y[s];
+  }
+  kineticsProductionRates(table, work, 1, &rho, &T, &Yb[0], &omegab[0]);
+
+  std::vector<double> omega(Ns);
+  for(int s = 0; s < Ns; ++s) {
+    omega[s] = omegab[s*B];
+  }
+  return omega;
+}
+
+double arrhenius(ArrheniusRate const & k, double const T) {
+  return k.A*std::pow(T, k.b)*std::exp(-k.Ea/(Runiv*T));
+}
+
+// A radical-rich mixture at temperature T with density from p = 1 atm.
+void makeState(
+  Mixture const & mixture, double const T, double & rho, std::vector<double> & Y
+) {
+  double const X[] = {0.20, 0.10, 0.05, 0.03, 0.07, 0.25, 0.30};
+  int const Ns = mixture.nSpecies;
+  double W = 0.0;
+  for(int s = 0; s < Ns; ++s) {
+    W += X[s]*mixture.molecularWeight[s];
+  }
+  Y.resize(Ns);
+  for(int s = 0; s < Ns; ++s) {
+    Y[s] = X[s]*mixture.molecularWeight[s]/W;
+  }
+  rho = 101325.0*W/(Runiv*T);
+}
+
+} // end: namespace
+
+// The production rates of a balanced mechanism conserve mass.
+TEST(Kinetics, MassConservation) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  int const Ns = mixture->nSpecies;
+  ASSERT_EQ(Ns, 7);
+  ASSERT_EQ(mixture->nReactions, 8);
+
+  KineticsTable table;
+  KineticsWorkspace work;
+  initKineticsTable(table, *mixture, Runiv);
+  initKineticsWorkspace(work, table);
+
+  int const n = 37;
+  std::vector<double> rho(n), T(n), Y(Ns*B, 0.0), omega(Ns*B, 0.0);
+  for(int i = 0; i < n; ++i) {
+    std::vector<double> Yc;
+    T[i] = 300.0+i*100.0;
+    makeState(*mixture, T[i], rho[i], Yc);
+    for(int s = 0; s < Ns; ++s) {
+      Y[s*B+i] = Yc[s];
+    }
+  }
+
+  kineticsProductionRates(table, work, n, &rho[0], &T[0], &Y[0], &omega[0]);
+
+  for(int i = 0; i < n; ++i) {
+    double sum = 0.0, norm = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      sum += omega[s*B+i];
+      norm = std::max(norm, std::fabs(omega[s*B+i]));
+    }
+    EXPECT_GT(norm, 0.0);
+    EXPECT_NEAR(sum, 0.0, 1.0e-12*norm) << "cell " << i;
+    EXPECT_NEAR(omega[N2*B+i], 0.0, 1.0e-300);
+  }
+}
+
+// The rates of a block are those of the cells computed one at a time.
+TEST(Kinetics, BlockMatchesCells) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  int const Ns = mixture->nSpecies;
+
+  KineticsTable table;
+  KineticsWorkspace work;
+  initKineticsTable(table, *mixture, Runiv);
+  initKineticsWorkspace(work, table);
+
+  int const n = B;
+  std::vector<double> rho(n), T(n), Y(Ns*B, 0.0), omega(Ns*B, 0.0);
+  for(int i = 0; i < n; ++i) {
+    std::vector<double> Yc;
+    T[i] = 800.0+i*37.0;
+    makeState(*mixture, T[i], rho[i], Yc);
+    for(int s = 0; s < Ns; ++s) {
+      Y[s*B+i] = Yc[s];
+    }
+  }
+  kineticsProductionRates(table, work, n, &rho[0], &T[0], &Y[0], &omega[0]);
+
+  for(int i = 0; i < n; i += 7) {
+    std::vector<double> Yc(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      Yc[s] = Y[s*B+i];
+    }
+    std::vector<double> omegac = productionRates(*mixture, rho[i], T[i], Yc);
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(omega[s*B+i], omegac[s], 1.0e-12*std::fabs(omegac[s]));
+    }
+  }
+}
+
+// Irreversible elementary reaction O + H2 => H + OH against the law of mass
+// action.
+TEST(Kinetics, ElementaryRate) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  keepReaction(*mixture, 1);
+  mixture->reactions[0].reversible = 0;
+
+  double const T = 1500.0;
+  double rho;
+  std::vector<double> Y;
+  makeState(*mixture, T, rho, Y);
+
+  std::vector<double> omega = productionRates(*mixture, rho, T, Y);
+
+  double const * W = mixture->molecularWeight;
+  double const q = arrhenius(mixture->reactions[0].rate, T)*
+    (rho*Y[O]/W[O])*(rho*Y[H2]/W[H2]);
+  EXPECT_NEAR(omega[OH], W[OH]*q, 1.0e-12*W[OH]*q);
+  EXPECT_NEAR(omega[H], W[H]*q, 1.0e-12*W[H]*q);
+  EXPECT_NEAR(omega[O], -W[O]*q, 1.0e-12*W[O]*q);
+  EXPECT_NEAR(omega[H2], -W[H2]*q, 1.0e-12*W[H2]*q);
+  EXPECT_EQ(omega[O2], 0.0);
+}
+
+// Third-body reaction H + OH + M => H2O + M with efficiencies of H2 and H2O.
+TEST(Kinetics, ThirdBodyRate) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  keepReaction(*mixture, 7);
+  mixture->reactions[0].reversible = 0;
+  ASSERT_EQ(mixture->reactions[0].nEfficiencies, 2);
+
+  double const T = 2000.0;
+  double rho;
+  std::vector<double> Y;
+  makeState(*mixture, T, rho, Y);
+
+  std::vector<double> omega = productionRates(*mixture, rho, T, Y);
+
+  double const * W = mixture->molecularWeight;
+  double C[7], M = 0.0;
+  for(int s = 0; s < 7; ++s) {
+    C[s] = rho*Y[s]/W[s];
+    M += C[s];
+  }
+  M += 1.5*C[H2]+11.0*C[H2O];
+  double const q = arrhenius(mixture->reactions[0].rate, T)*M*C[H]*C[OH];
+  EXPECT_NEAR(omega[H2O], W[H2O]*q, 1.0e-12*W[H2O]*q);
+}
+
+// Falloff of H + OH (+M) => H2O (+M) with the Lindemann and Troe forms.
+TEST(Kinetics, FalloffRate) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  keepReaction(*mixture, 7);
+  Reaction & r = mixture->reactions[0];
+  r.reversible = 0;
+  r.hasThirdBody = 0;
+  r.rate.A = 2.5e10;
+  r.rate.b = 0.2;
+  r.rate.Ea = 0.0;
+  r.lowPressureRate.A = 4.0e16;
+  r.lowPressureRate.b = -2.0;
+  r.lowPressureRate.Ea = 2.0e6;
+
+  double const T = 1200.0;
+  double rho;
+  std::vector<double> Y;
+  makeState(*mixture, T, rho, Y);
+
+  double const * W = mixture->molecularWeight;
+  double C[7], M = 0.0;
+  for(int s = 0; s < 7; ++s) {
+    C[s] = rho*Y[s]/W[s];
+    M += C[s];
+  }
+  M += 1.5*C[H2]+11.0*C[H2O];
+
+  double const kinf = arrhenius(r.rate, T);
+  double const Pr = arrhenius(r.lowPressureRate, T)*M/kinf;
+
+  r.falloffModel = FALLOFF_LINDEMANN;
+  {
+    std::vector<double> omega = productionRates(*mixture, rho, T, Y);
+    double const q = kinf*Pr/(1.0+Pr)*C[H]*C[OH];
+    EXPECT_NEAR(omega[H2O], W[H2O]*q, 1.0e-12*W[H2O]*q);
+  }
+
+  double const alpha = 0.7, T3 = 100.0, T1 = 2000.0, T2 = 5000.0;
+  r.falloffModel = FALLOFF_TROE;
+  r.troe[0] = alpha;
+  r.troe[1] = T3;
+  r.troe[2] = T1;
+  r.troe[3] = T2;
+  for(int nTroe = 3; nTroe <= 4; ++nTroe) {
+    r.nTroe = nTroe;
+    std::vector<double> omega = productionRates(*mixture, rho, T, Y);
+
+    double Fcent = (1.0-alpha)*std::exp(-T/T3)+alpha*std::exp(-T/T1);
+    if(nTroe == 4) {
+      Fcent += std::exp(-T2/T);
+    }
+    double const c = -0.4-0.67*std::log10(Fcent);
+    double const m = 0.75-1.27*std::log10(Fcent);
+    double const f = (std::log10(Pr)+c)/(m-0.14*(std::log10(Pr)+c));
+    double const F = std::pow(10.0, std::log10(Fcent)/(1.0+f*f));
+    double const q = kinf*Pr/(1.0+Pr)*F*C[H]*C[OH];
+    EXPECT_NEAR(omega[H2O], W[H2O]*q, 1.0e-12*W[H2O]*q) << "nTroe " << nTroe;
+  }
+}
+
+// The net rate of a reversible reaction vanishes at the equilibrium of
+// H2 + M <=> 2 H, with the equilibrium constant from the species enthalpies
+// and entropies.
+TEST(Kinetics, ZeroNetRateAtEquilibrium) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  keepReaction(*mixture, 4);
+  int const Ns = mixture->nSpecies;
+  double const * W = mixture->molecularWeight;
+
+  std::vector<double> sR(Ns), sCp(Ns), sH(Ns), sS(Ns);
+  for(int s = 0; s < Ns; ++s) {
+    sR[s] = Runiv/W[s];
+  }
+
+  for(double T : {600.0, 2500.0, 4000.0}) {
+    nasa9_sCp_sH_from_T(Ns, &sCp[0], &sH[0], mixture->nasa9Thermochemistry, &sR[0], T);
+    nasa9_sS_from_T(Ns, &sS[0], mixture->nasa9Thermochemistry, &sR[0], T);
+
+    // Molar Gibbs energies: [J/kmol].
+    double const gH2 = W[H2]*(sH[H2]-T*sS[H2]);
+    double const gH = W[H]*(sH[H]-T*sS[H]);
+    double const Kc = std::exp(-(2.0*gH-gH2)/(Runiv*T))*1.0e5/(Runiv*T);
+
+    // Concentrations of H2 and N2 and the equilibrium concentration of H.
+    double const CH2 = 1.0e-3, CN2 = 3.0e-3;
+    double const CH = std::sqrt(Kc*CH2);
+
+    std::vector<double> C(Ns, 0.0);
+    C[H2] = CH2;
+    C[N2] = CN2;
+    C[H] = CH;
+    double rho = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      rho += C[s]*W[s];
+    }
+    std::vector<double> Y(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      Y[s] = C[s]*W[s]/rho;
+    }
+
+    std::vector<double> omega = productionRates(*mixture, rho, T, Y);
+
+    double const M = CH2+CN2+CH+1.5*CH2;
+    double const qf = arrhenius(mixture->reactions[0].rate, T)*M*CH2;
+    EXPECT_NEAR(omega[H], 0.0, 1.0e-9*W[H]*qf) << "T " << T;
+  }
+}
+
+// The molar rates of a single cell are those of the blocked evaluation.
+TEST(Kinetics, MolarRatesMatchBlock) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  int const Ns = mixture->nSpecies;
+  double const * W = mixture->molecularWeight;
+
+  KineticsTable table;
+  initKineticsTable(table, *mixture, Runiv);
+
+  for(double T : {900.0, 1500.0, 2800.0}) {
+    double rho;
+    std::vector<double> Y;
+    makeState(*mixture, T, rho, Y);
+    std::vector<double> omega = productionRates(*mixture, rho, T, Y);
+
+    std::vector<double> C(Ns), wdot(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      C[s] = rho*Y[s]/W[s];
+    }
+    kineticsMolarRates(table, &C[0], T, &wdot[0], nullptr, 0);
+
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(W[s]*wdot[s], omega[s], 1.0e-12*std::fabs(omega[s])+1.0e-300)
+        << "T " << T << " species " << s;
+    }
+  }
+}
+
+// The analytic derivatives of the molar rates match central differences, with
+// the last reaction turned into a Troe falloff reaction so that every kind of
+// rate is covered.
+TEST(Kinetics, JacobianMatchesFiniteDifferences) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  Reaction & r = mixture->reactions[7];
+  r.falloffModel = FALLOFF_TROE;
+  r.rate.A = 2.5e10;
+  r.rate.b = 0.2;
+  r.lowPressureRate.A = 4.0e16;
+  r.lowPressureRate.b = -2.0;
+  r.lowPressureRate.Ea = 2.0e6;
+  r.nTroe = 4;
+  r.troe[0] = 0.7;
+  r.troe[1] = 100.0;
+  r.troe[2] = 2000.0;
+  r.troe[3] = 5000.0;
+
+  int const Ns = mixture->nSpecies;
+  int const n = Ns+1;
+  double const * W = mixture->molecularWeight;
+
+  KineticsTable table;
+  initKineticsTable(table, *mixture, Runiv);
+
+  for(double T : {1100.0, 2400.0}) {
+    double rho;
+    std::vector<double> Y;
+    makeState(*mixture, T, rho, Y);
+
+    std::vector<double> C(Ns), wdot(Ns), J(Ns*n);
+    for(int s = 0; s < Ns; ++s) {
+      C[s] = rho*Y[s]/W[s];
+    }
+    kineticsMolarRates(table, &C[0], T, &wdot[0], &J[0], n);
+
+    std::vector<double> wp(Ns), wm(Ns);
+    for(int k = 0; k <= Ns; ++k) {
+      std::vector<double> Cp(C), Cm(C);
+      double Tp = T, Tm = T, d;
+      if(k < Ns) {
+        d = 1.0e-6*C[k];
+        Cp[k] += d;
+        Cm[k] -= d;
+      } else {
+        d = 1.0e-6*T;
+        Tp += d;
+        Tm -= d;
+      }
+      kineticsMolarRates(table, &Cp[0], Tp, &wp[0], nullptr, 0);
+      kineticsMolarRates(table, &Cm[0], Tm, &wm[0], nullptr, 0);
+
+      for(int s = 0; s < Ns; ++s) {
+        double const fd = (wp[s]-wm[s])/(2.0*d);
+        double const scale = std::fabs(wdot[s])/(k < Ns ? C[k] : T);
+        EXPECT_NEAR(J[s*n+k], fd, 1.0e-6*(std::fabs(fd)+scale))
+          << "T " << T << " species " << s << " column " << k;
+      }
+    }
+  }
+}
+
+// A cell is active above the activation temperature with enough fuel and
+// oxidizer; the default criterion makes every cell active.
+TEST(Kinetics, ActivityMask) {
+  double Y[] = {0.02, 0.2, 0.0, 0.0, 0.0, 0.0, 0.78};
+
+  ChemistryActivity activity;
+  activity.temperature = 0.0;
+  activity.massFraction = 0.0;
+  EXPECT_TRUE(chemistryCellActive(activity, 200.0, Y));
+
+  activity.temperature = 600.0;
+  activity.massFraction = 1.0e-3;
+  EXPECT_FALSE(chemistryCellActive(activity, 599.0, Y));
+  EXPECT_TRUE(chemistryCellActive(activity, 600.0, Y));
+
+  activity.fuel.push_back(H2);
+  activity.oxidizer.push_back(O2);
+  activity.oxidizer.push_back(O);
+  EXPECT_TRUE(chemistryCellActive(activity, 1000.0, Y));
+  Y[H2] = 5.0e-4;
+  EXPECT_FALSE(chemistryCellActive(activity, 1000.0, Y));
+  Y[H2] = 0.02;
+  Y[O2] = 6.0e-4;
+  EXPECT_FALSE(chemistryCellActive(activity, 1000.0, Y));
+  Y[O] = 6.0e-4;
+  EXPECT_TRUE(chemistryCellActive(activity, 1000.0, Y));
+}
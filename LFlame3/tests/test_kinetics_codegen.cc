@@ -0,0 +1,195 @@
+#include <kinetics.hh>
+#include <kinetics_registry.hh>
+#include <sparse_lu.hh>
+
+#include "kinetics_test_helpers.hh"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace flame;
+using namespace flame::test;
+
+namespace {
+
+// States of n cells from 600 K to 3000 K at 1 atm with every species present.
+void makeStates(
+  Mixture const & mixture, int const n, std::vector<double> & rho,
+  std::vector<double> & T, std::vector<double> & Y
+) {
+  int const Ns = mixture.nSpecies;
+  rho.assign(n, 0.0);
+  T.assign(n, 0.0);
+  Y.assign(Ns*B, 0.0);
+  for(int i = 0; i < n; ++i) {
+    T[i] = 600.0+2400.0*i/(n-1);
+    double W = 0.0;
+    std::vector<double> X(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      X[s] = 0.01+0.1*((3*s+5*i)%7);
+      W += X[s]*mixture.molecularWeight[s];
+    }
+    double Xsum = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      Xsum += X[s];
+    }
+    for(int s = 0; s < Ns; ++s) {
+      Y[s*B+i] = X[s]*mixture.molecularWeight[s]/W;
+    }
+    rho[i] = 101325.0*W/Xsum/(Runiv*T[i]);
+  }
+}
+
+} // end: namespace
+
+// The table of the mechanism shipped with the solver finds its generated
+// kernels, and a table of a modified mechanism falls back to interpretation.
+TEST(KineticsCodegen, RegisteredByHash) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+
+  KineticsTable table;
+  initKineticsTable(table, *mixture, Runiv);
+  ASSERT_NE(table.compiled, nullptr)
+    << "registered: " << CompiledMechanismList::names();
+  EXPECT_EQ(std::string(table.compiled->name), "mixture-h2-o2");
+  EXPECT_EQ(table.compiled->hash, kineticsTableHash(table));
+
+  mixture->reactions[2].rate.A *= 1.001;
+  KineticsTable modified;
+  initKineticsTable(modified, *mixture, Runiv);
+  EXPECT_NE(kineticsTableHash(modified), kineticsTableHash(table));
+  EXPECT_EQ(modified.compiled, nullptr);
+
+  KineticsTable other;
+  initKineticsTable(other, *loadMixture(), 8314.0);
+  EXPECT_EQ(other.compiled, nullptr);
+}
+
+// The generated production rates match the interpreted ones.
+TEST(KineticsCodegen, ProductionRatesMatchInterpreted) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  int const Ns = mixture->nSpecies;
+  int const n = 40;
+
+  KineticsTable compiled, interpreted;
+  initKineticsTable(compiled, *mixture, Runiv);
+  ASSERT_NE(compiled.compiled, nullptr);
+  interpreted = compiled;
+  interpreted.compiled = nullptr;
+
+  KineticsWorkspace work;
+  initKineticsWorkspace(work, compiled);
+
+  std::vector<double> rho, T, Y;
+  makeStates(*mixture, n, rho, T, Y);
+
+  std::vector<double> omegac(Ns*B, 0.0), omegai(Ns*B, 0.0);
+  kineticsProductionRates(compiled, work, n, &rho[0], &T[0], &Y[0], &omegac[0]);
+  kineticsProductionRates(interpreted, work, n, &rho[0], &T[0], &Y[0], &omegai[0]);
+
+  for(int i = 0; i < n; ++i) {
+    double scale = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      scale = std::max(scale, std::fabs(omegai[s*B+i]));
+    }
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(omegac[s*B+i], omegai[s*B+i], 1.0e-12*scale)
+        << "T " << T[i] << " species " << s;
+    }
+  }
+}
+
+// The generated molar rates and their Jacobian match the interpreted ones.
+TEST(KineticsCodegen, MolarRatesMatchInterpreted) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  int const Ns = mixture->nSpecies;
+  int const ldJ = Ns+2;
+  int const n = 12;
+
+  KineticsTable compiled, interpreted;
+  initKineticsTable(compiled, *mixture, Runiv);
+  ASSERT_NE(compiled.compiled, nullptr);
+  interpreted = compiled;
+  interpreted.compiled = nullptr;
+
+  std::vector<double> rho, T, Y;
+  makeStates(*mixture, n, rho, T, Y);
+
+  for(int i = 0; i < n; ++i) {
+    std::vector<double> C(Ns);
+    for(int s = 0; s < Ns; ++s) {
+      C[s] = rho[i]*Y[s*B+i]/mixture->molecularWeight[s];
+    }
+
+    // The column past the derivatives is not touched.
+    std::vector<double> wc(Ns), wi(Ns), Jc(Ns*ldJ, -1.0), Ji(Ns*ldJ, -1.0);
+    kineticsMolarRates(compiled, &C[0], T[i], &wc[0], &Jc[0], ldJ);
+    kineticsMolarRates(interpreted, &C[0], T[i], &wi[0], &Ji[0], ldJ);
+
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(wc[s], wi[s], 1.0e-12*std::fabs(wi[s])+1.0e-300)
+        << "T " << T[i] << " species " << s;
+      double scale = 0.0;
+      for(int k = 0; k <= Ns; ++k) {
+        scale = std::max(scale, std::fabs(Ji[s*ldJ+k]));
+      }
+      for(int k = 0; k <= Ns; ++k) {
+        EXPECT_NEAR(Jc[s*ldJ+k], Ji[s*ldJ+k], 1.0e-12*scale)
+          << "T " << T[i] << " species " << s << " column " << k;
+      }
+      EXPECT_EQ(Jc[s*ldJ+Ns+1], -1.0);
+    }
+  }
+}
+
+// The Jacobian assembled in the entries of a sparse factorization, by the
+// generated and the interpreted kernels, has the entries of the dense one and
+// zeros elsewhere.
+TEST(KineticsCodegen, SparseMolarRatesMatchDense) {
+  std::unique_ptr<Mixture> mixture = loadMixture();
+  int const Ns = mixture->nSpecies;
+  int const n = Ns+1;
+  int const cells = 4;
+
+  KineticsTable compiled, interpreted;
+  initKineticsTable(compiled, *mixture, Runiv);
+  ASSERT_NE(compiled.compiled, nullptr);
+  interpreted = compiled;
+  interpreted.compiled = nullptr;
+
+  std::vector<char> pattern;
+  kineticsJacobianPattern(compiled, pattern);
+  SparseLU lu;
+  initSparseLU(lu, n, pattern);
+
+  std::vector<double> rho, T, Y;
+  makeStates(*mixture, cells, rho, T, Y);
+
+  for(KineticsTable const * table : {&compiled, &interpreted}) {
+    for(int i = 0; i < cells; ++i) {
+      std::vector<double> C(Ns);
+      for(int s = 0; s < Ns; ++s) {
+        C[s] = rho[i]*Y[s*B+i]/mixture->molecularWeight[s];
+      }
+
+      std::vector<double> wd(Ns), ws(Ns), Jd(Ns*n), Js(lu.nonzeros, -1.0);
+      kineticsMolarRates(*table, &C[0], T[i], &wd[0], &Jd[0], n);
+      kineticsMolarRatesSparse(
+        *table, &C[0], T[i], &ws[0], &Js[0], &lu.position[0], lu.nonzeros
+      );
+
+      for(int s = 0; s < Ns; ++s) {
+        EXPECT_EQ(ws[s], wd[s]) << "species " << s;
+      }
+      for(int p = 0; p < lu.nonzeros; ++p) {
+        int const e = lu.denseIndex[p];
+        EXPECT_EQ(Js[p], e < Ns*n ? Jd[e] : 0.0)
+          << "T " << T[i] << " row " << e/n << " column " << e%n;
+      }
+    }
+  }
+}
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+
 using namespace flame;
 
 TEST(MixtureXMLParser, Mixture1) {
@@ -49,3 +51,149 @@ TEST(MixtureXMLParser, Mixture1) {
   EXPECT_EQ(mixture.caloricallyPerfectThermochemistry[0].specificHeat, 920.0);
   EXPECT_EQ(mixture.caloricallyPerfectThermochemistry[1].specificHeat, 1005.0);
 }
+
+TEST(MixtureXMLParser, MixtureNASA9) {
+  Mixture mixture;
+  std::ostringstream errmsg;
+  int error = parseFromXML(std::string(FLAME_DATA_DIR)+"/mixture-nasa9.xml", mixture, errmsg);
+
+  ASSERT_EQ(error, 0) << errmsg.str();
+  ASSERT_EQ(mixture.nSpecies, 2);
+
+  EXPECT_EQ(std::string(mixture.speciesName[0]), std::string("O2"));
+  EXPECT_EQ(std::string(mixture.speciesName[1]), std::string("N2"));
+
+  for(int i = 0; i < 2; ++i) {
+    EXPECT_EQ(mixture.thermochemistryModel[i], THERMOCHEMISTRY_NASA9);
+    EXPECT_TRUE(mixture.hasNasa9Thermochemistry[i]);
+    EXPECT_EQ(mixture.nasa9Thermochemistry[i].tRange[0], 200.0);
+    EXPECT_EQ(mixture.nasa9Thermochemistry[i].tRange[1], 1000.0);
+    EXPECT_EQ(mixture.nasa9Thermochemistry[i].tRange[2], 6000.0);
+  }
+
+  EXPECT_EQ(mixture.nasa9Thermochemistry[0].cpCoeff[0], -3.425563420e+04);
+  EXPECT_EQ(mixture.nasa9Thermochemistry[0].cpCoeff[17], 1.738716506e+01);
+  EXPECT_EQ(mixture.nasa9Thermochemistry[0].hCoeff[0], 3.425563420e+04);
+  EXPECT_EQ(mixture.nasa9Thermochemistry[1].cpCoeff[9], 5.877124060e+05);
+}
+
+TEST(MixtureXMLParser, MixtureReactions) {
+  Mixture mixture;
+  std::ostringstream errmsg;
+  int error = parseFromXML(std::string(FLAME_DATA_DIR)+"/mixture-h2-o2.xml", mixture, errmsg);
+
+  ASSERT_EQ(error, 0) << errmsg.str();
+  ASSERT_EQ(mixture.nSpecies, 7);
+  ASSERT_EQ(mixture.nReactions, 8);
+
+  // H + O2 <=> O + OH
+  Reaction const & r0 = mixture.reactions[0];
+  EXPECT_EQ(r0.nReactants, 2);
+  EXPECT_EQ(r0.reactantSpecies[0], 2);
+  EXPECT_EQ(r0.reactantSpecies[1], 1);
+  EXPECT_EQ(r0.reactantCoeff[0], 1.0);
+  EXPECT_EQ(r0.nProducts, 2);
+  EXPECT_EQ(r0.productSpecies[0], 3);
+  EXPECT_EQ(r0.productSpecies[1], 4);
+  EXPECT_TRUE(r0.reversible);
+  EXPECT_EQ(r0.rate.A, 3.547e+12);
+  EXPECT_EQ(r0.rate.b, -0.406);
+  EXPECT_DOUBLE_EQ(r0.rate.Ea, 16599.0*4184.0);
+  EXPECT_FALSE(r0.hasThirdBody);
+  EXPECT_EQ(r0.falloffModel, FALLOFF_NONE);
+
+  // O + H2O <=> 2 OH
+  Reaction const & r3 = mixture.reactions[3];
+  EXPECT_EQ(r3.nProducts, 1);
+  EXPECT_EQ(r3.productSpecies[0], 4);
+  EXPECT_EQ(r3.productCoeff[0], 2.0);
+
+  // H2 + M <=> 2 H + M
+  Reaction const & r4 = mixture.reactions[4];
+  EXPECT_TRUE(r4.hasThirdBody);
+  ASSERT_EQ(r4.nEfficiencies, 2);
+  EXPECT_EQ(r4.efficiencySpecies[0], 0);
+  EXPECT_EQ(r4.efficiency[0], 2.5);
+  EXPECT_EQ(r4.efficiencySpecies[1], 5);
+  EXPECT_EQ(r4.efficiency[1], 12.0);
+}
+
+TEST(MixtureXMLParser, ReactionFalloff) {
+  std::string const file = testing::TempDir()+"/mixture-falloff.xml";
+  {
+    std::ofstream out(file);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<mixture xmlns=\"http://flame-mixture\">\n"
+        << "  <species><name>A</name><molecularWeight>10.0</molecularWeight>"
+        << "<thermochemistry><specificHeat>1000.0</specificHeat></thermochemistry></species>\n"
+        << "  <species><name>B</name><molecularWeight>20.0</molecularWeight>"
+        << "<thermochemistry><specificHeat>1000.0</specificHeat></thermochemistry></species>\n"
+        << "  <reactions>\n"
+        << "    <reaction reversible=\"false\">\n"
+        << "      <reactants>A:2</reactants>\n"
+        << "      <products>B</products>\n"
+        << "      <arrhenius><preExponentialFactor>1.0e10</preExponentialFactor></arrhenius>\n"
+        << "      <thirdBody><efficiencies>B:0.5</efficiencies></thirdBody>\n"
+        << "      <falloff>\n"
+        << "        <lowPressure>\n"
+        << "          <preExponentialFactor>2.0e14</preExponentialFactor>\n"
+        << "          <temperatureExponent>-1.5</temperatureExponent>\n"
+        << "          <activationEnergy unit=\"J/mol\">1000.0</activationEnergy>\n"
+        << "        </lowPressure>\n"
+        << "        <troe>0.6 100.0 1000.0</troe>\n"
+        << "      </falloff>\n"
+        << "    </reaction>\n"
+        << "  </reactions>\n"
+        << "</mixture>\n";
+  }
+
+  Mixture mixture;
+  std::ostringstream errmsg;
+  int error = parseFromXML(file, mixture, errmsg);
+
+  ASSERT_EQ(error, 0) << errmsg.str();
+  ASSERT_EQ(mixture.nReactions, 1);
+
+  Reaction const & r = mixture.reactions[0];
+  EXPECT_FALSE(r.reversible);
+  EXPECT_EQ(r.reactantCoeff[0], 2.0);
+  EXPECT_EQ(r.rate.A, 1.0e10);
+  EXPECT_EQ(r.rate.b, 0.0);
+  EXPECT_EQ(r.rate.Ea, 0.0);
+  EXPECT_EQ(r.nEfficiencies, 1);
+  EXPECT_EQ(r.efficiencySpecies[0], 1);
+  EXPECT_EQ(r.falloffModel, FALLOFF_TROE);
+  EXPECT_EQ(r.lowPressureRate.A, 2.0e14);
+  EXPECT_EQ(r.lowPressureRate.b, -1.5);
+  EXPECT_EQ(r.lowPressureRate.Ea, 1.0e6);
+  ASSERT_EQ(r.nTroe, 3);
+  EXPECT_EQ(r.troe[0], 0.6);
+  EXPECT_EQ(r.troe[1], 100.0);
+  EXPECT_EQ(r.troe[2], 1000.0);
+}
+
+TEST(MixtureXMLParser, ReactionUnknownSpecies) {
+  std::string const file = testing::TempDir()+"/mixture-unknown-species.xml";
+  {
+    std::ofstream out(file);
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<mixture xmlns=\"http://flame-mixture\">\n"
+        << "  <species><name>A</name><molecularWeight>10.0</molecularWeight>"
+        << "<thermochemistry><specificHeat>1000.0</specificHeat></thermochemistry></species>\n"
+        << "  <reactions>\n"
+        << "    <reaction>\n"
+        << "      <reactants>A</reactants>\n"
+        << "      <products>C</products>\n"
+        << "      <arrhenius><preExponentialFactor>1.0</preExponentialFactor></arrhenius>\n"
+        << "    </reaction>\n"
+        << "  </reactions>\n"
+        << "</mixture>\n";
+  }
+
+  Mixture mixture;
+  std::ostringstream errmsg;
+  int error = parseFromXML(file, mixture, errmsg);
+
+  EXPECT_EQ(error, 12);
+  EXPECT_NE(errmsg.str().find("'C'"), std::string::npos) << errmsg.str();
+}
@@ -0,0 +1,402 @@
+#include <nasa9.hh>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+double const Runiv = FLAME_RUNIV;
+
+// NASA9 polynomials of O2, N2 and H2O from the NASA Glenn thermodynamic
+// database, with the enthalpy coefficients derived as in the mixture parser.
+struct Species {
+  double W;
+  double tRange[3];
+  double coefficients[18];
+};
+
+Species const species[3] = {
+  {31.9988, {200.0, 1000.0, 6000.0}, {
+    -3.425563420e+04, 4.847000970e+02, 1.119010961e+00, 4.293889240e-03,
+    -6.836300520e-07, -2.023372700e-09, 1.039040018e-12, -3.391454870e+03,
+    1.849699470e+01,
+    -1.037939022e+06, 2.344830282e+03, 1.819732036e+00, 1.267847582e-03,
+    -2.188067988e-07, 2.053719572e-11, -8.193467050e-16, -1.689010929e+04,
+    1.738716506e+01
+  }},
+  {28.0134, {200.0, 1000.0, 6000.0}, {
+    2.210371497e+04, -3.818461820e+02, 6.082738360e+00, -8.530914410e-03,
+    1.384646189e-05, -9.625793620e-09, 2.519705809e-12, 7.108460860e+02,
+    -1.076003744e+01,
+    5.877124060e+05, -2.239249073e+03, 6.066949220e+00, -6.139685500e-04,
+    1.491806679e-07, -1.923105485e-11, 1.061954386e-15, 1.283210415e+04,
+    -1.586640027e+01
+  }},
+  {18.01528, {200.0, 1000.0, 6000.0}, {
+    -3.947960830e+04, 5.755731020e+02, 9.317826530e-01, 7.222712860e-03,
+    -7.342557370e-06, 4.955043490e-09, -1.336933246e-12, -3.303974310e+04,
+    1.724205775e+01,
+    1.034972096e+06, -2.412698562e+03, 4.646110780e+00, 2.291998307e-03,
+    -6.836830480e-07, 9.426468930e-11, -4.822380530e-15, -1.384286509e+04,
+    -7.978148510e+00
+  }}
+};
+
+int const Ns = 3;
+
+void makeThermo(NASA9Thermochemistry * thermo, double * sR) {
+  for(int s = 0; s < Ns; ++s) {
+    sR[s] = Runiv/species[s].W;
+    for(int i = 0; i < 3; ++i) {
+      thermo[s].tRange[i] = species[s].tRange[i];
+    }
+    for(int k = 0; k < 18; k += 9) {
+      double const * a = &species[s].coefficients[k];
+      double * c = &thermo[s].cpCoeff[k];
+      double * h = &thermo[s].hCoeff[k];
+      double * e = &thermo[s].sCoeff[k];
+      for(int i = 0; i < 9; ++i) {
+        c[i] = a[i];
+      }
+      h[0] = -a[0];
+      h[1] = a[1];
+      h[2] = a[2];
+      h[3] = a[3]/2.0;
+      h[4] = a[4]/3.0;
+      h[5] = a[5]/4.0;
+      h[6] = a[6]/5.0;
+      h[7] = a[7];
+      h[8] = a[8];
+      e[0] = -a[0]/2.0;
+      e[1] = -a[1];
+      e[2] = a[2];
+      e[3] = a[3];
+      e[4] = a[4]/2.0;
+      e[5] = a[5]/3.0;
+      e[6] = a[6]/4.0;
+      e[7] = 0.0;
+      e[8] = a[8];
+    }
+  }
+}
+
+// Internal energy of a mixture with mass fractions Y at temperature T.
+double energy(
+  NASA9Thermochemistry const * thermo, double const * sR, double const * Y,
+  double const T
+) {
+  double sCp[Ns], sH[Ns];
+  nasa9_sCp_sH_from_T(Ns, sCp, sH, thermo, sR, T);
+  double h = 0.0, R = 0.0;
+  for(int s = 0; s < Ns; ++s) {
+    h += Y[s]*sH[s];
+    R += Y[s]*sR[s];
+  }
+  return h-R*T;
+}
+
+} // end: namespace
+
+// Specific heats and enthalpies at 298.15 K against the tabulated values, and
+// continuity of the two temperature ranges.
+TEST(NASA9, SpeciesProperties) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  double sCp[Ns], sH[Ns];
+  nasa9_sCp_sH_from_T(Ns, sCp, sH, thermo, sR, 298.15);
+
+  // cp: 29.376, 29.124, 33.588 J/mol.K; hf: 0, 0, -241.826 kJ/mol.
+  EXPECT_NEAR(sCp[0]*species[0].W, 29376.0, 10.0);
+  EXPECT_NEAR(sCp[1]*species[1].W, 29124.0, 10.0);
+  EXPECT_NEAR(sCp[2]*species[2].W, 33588.0, 10.0);
+  EXPECT_NEAR(sH[0]*species[0].W, 0.0, 1.0e4);
+  EXPECT_NEAR(sH[1]*species[1].W, 0.0, 1.0e4);
+  EXPECT_NEAR(sH[2]*species[2].W, -241.826e6, 1.0e4);
+
+  // s: 205.152, 191.609, 188.835 J/mol.K.
+  double sS[Ns];
+  nasa9_sS_from_T(Ns, sS, thermo, sR, 298.15);
+  EXPECT_NEAR(sS[0]*species[0].W, 205152.0, 10.0);
+  EXPECT_NEAR(sS[1]*species[1].W, 191609.0, 10.0);
+  EXPECT_NEAR(sS[2]*species[2].W, 188835.0, 10.0);
+
+  double sCpLow[Ns], sHLow[Ns], sCpHigh[Ns], sHHigh[Ns];
+  nasa9_sCp_sH_from_T(Ns, sCpLow, sHLow, thermo, sR, 1000.0-1.0e-9);
+  nasa9_sCp_sH_from_T(Ns, sCpHigh, sHHigh, thermo, sR, 1000.0);
+  for(int s = 0; s < Ns; ++s) {
+    EXPECT_NEAR(sCpLow[s], sCpHigh[s], 1.0e-3*sCpHigh[s]);
+    EXPECT_NEAR(sHLow[s], sHHigh[s], 1.0e-4*std::fabs(sHHigh[s])+10.0);
+  }
+}
+
+// The table gives the same properties as the species polynomials.
+TEST(NASA9, TableMatchesSpeciesPolynomials) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  NASA9Table table;
+  initNASA9Table(table, Ns, thermo, sR);
+  EXPECT_EQ(table.tMin, 200.0);
+  EXPECT_EQ(table.tMax, 6000.0);
+
+  for(double T = 250.0; T < 6000.0; T += 250.0) {
+    double sCp[Ns], sH[Ns];
+    nasa9_sCp_sH_from_T(Ns, sCp, sH, thermo, sR, T);
+    for(int s = 0; s < Ns; ++s) {
+      double const * c = &table.coefficients[
+        (2*s+(T < table.tMid[s] ? 0 : 1))*FLAME_NASA9_NCOEFF
+      ];
+      double const cp = c[0]/(T*T)+c[1]/T+c[2]+c[3]*T+c[4]*T*T+
+        c[5]*T*T*T+c[6]*T*T*T*T;
+      double const h = c[7]/T+c[8]*std::log(T)+c[9]*T+c[10]*T*T+
+        c[11]*T*T*T+c[12]*T*T*T*T+c[13]*T*T*T*T*T+c[14];
+      EXPECT_NEAR(cp, sCp[s], 1.0e-9*sCp[s]);
+      EXPECT_NEAR(h, sH[s], 1.0e-9*(std::fabs(sH[s])+sCp[s]*T));
+    }
+  }
+}
+
+// Temperatures in both ranges are recovered from the energy of random mixtures,
+// starting from a constant initial guess, over a partially filled block.
+TEST(NASA9, TemperatureFromEnergy) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  NASA9Table table;
+  initNASA9Table(table, Ns, thermo, sR);
+
+  int const B = FLAME_NASA9_BLOCK_SIZE;
+  int const n = B-5;
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dT(250.0, 5500.0);
+  std::uniform_real_distribution<double> dY(0.0, 1.0);
+
+  std::vector<double> e(B), R(B), T(B), Texact(B);
+  std::vector<double> Y(Ns*B), sCp(Ns*B), sH(Ns*B);
+  for(int i = 0; i < n; ++i) {
+    double Yi[Ns], sum = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      Yi[s] = dY(gen);
+      sum += Yi[s];
+    }
+    R[i] = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      Yi[s] /= sum;
+      Y[s*B+i] = Yi[s];
+      R[i] += Yi[s]*sR[s];
+    }
+    Texact[i] = dT(gen);
+    e[i] = energy(thermo, sR, Yi, Texact[i]);
+    T[i] = 1000.0;
+  }
+
+  std::vector<NASA9TemperatureStatus> status(n);
+  int const iter = nasa9TemperatureFromEnergy(
+    table, n, &e[0], &R[0], &Y[0], &T[0], &sCp[0], &sH[0], &status[0]
+  );
+  EXPECT_GE(iter, 0);
+  EXPECT_LT(iter, FLAME_NASA9_MAX_ITERATIONS);
+
+  for(int i = 0; i < n; ++i) {
+    EXPECT_EQ(status[i], NASA9_TEMPERATURE_CONVERGED);
+    EXPECT_NEAR(T[i], Texact[i], 1.0e-8*Texact[i]);
+
+    double sCpi[Ns], sHi[Ns];
+    nasa9_sCp_sH_from_T(Ns, sCpi, sHi, thermo, sR, T[i]);
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(sCp[s*B+i], sCpi[s], 1.0e-12*sCpi[s]);
+      EXPECT_NEAR(sH[s*B+i], sHi[s], 1.0e-9*(std::fabs(sHi[s])+sCpi[s]*T[i]));
+    }
+  }
+}
+
+// Starting from the temperature of the previous stage the iteration converges
+// in a few steps.
+TEST(NASA9, WarmStart) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  NASA9Table table;
+  initNASA9Table(table, Ns, thermo, sR);
+
+  int const B = FLAME_NASA9_BLOCK_SIZE;
+  std::vector<double> e(B), R(B), T(B), Texact(B);
+  std::vector<double> Y(Ns*B), sCp(Ns*B), sH(Ns*B);
+  double const Yi[Ns] = {0.2, 0.7, 0.1};
+  for(int i = 0; i < B; ++i) {
+    R[i] = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      Y[s*B+i] = Yi[s];
+      R[i] += Yi[s]*sR[s];
+    }
+    Texact[i] = 300.0+70.0*i;
+    e[i] = energy(thermo, sR, Yi, Texact[i]);
+    T[i] = Texact[i]*(1.0+1.0e-3*((i%3)-1));
+  }
+
+  int const iter = nasa9TemperatureFromEnergy(
+    table, B, &e[0], &R[0], &Y[0], &T[0], &sCp[0], &sH[0]
+  );
+  EXPECT_LE(iter, 3);
+  for(int i = 0; i < B; ++i) {
+    EXPECT_NEAR(T[i], Texact[i], 1.0e-8*Texact[i]);
+  }
+}
+
+// Energies outside the range of the polynomials give the limiting temperatures
+// without running into the iteration limit.
+TEST(NASA9, TemperatureLimits) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  NASA9Table table;
+  initNASA9Table(table, Ns, thermo, sR);
+
+  int const B = FLAME_NASA9_BLOCK_SIZE;
+  std::vector<double> e(B), R(B), T(B);
+  std::vector<double> Y(Ns*B, 0.0), sCp(Ns*B), sH(Ns*B);
+  double const Yi[Ns] = {0.0, 1.0, 0.0};
+  Y[B+0] = 1.0;
+  Y[B+1] = 1.0;
+  R[0] = sR[1];
+  R[1] = sR[1];
+  e[0] = energy(thermo, sR, Yi, 100.0);
+  e[1] = energy(thermo, sR, Yi, 8000.0);
+  T[0] = 300.0;
+  T[1] = 300.0;
+
+  NASA9TemperatureStatus status[3];
+  int const iter = nasa9TemperatureFromEnergy(
+    table, 2, &e[0], &R[0], &Y[0], &T[0], &sCp[0], &sH[0], status
+  );
+  EXPECT_GE(iter, 0);
+  EXPECT_LT(iter, FLAME_NASA9_MAX_ITERATIONS);
+  EXPECT_EQ(T[0], 200.0);
+  EXPECT_EQ(T[1], 6000.0);
+  EXPECT_EQ(status[0], NASA9_TEMPERATURE_LIMITED);
+  EXPECT_EQ(status[1], NASA9_TEMPERATURE_LIMITED);
+
+  // An energy that is not a number, e.g. of a diverged cell, does not
+  // converge.
+  Y[B+2] = 1.0;
+  R[2] = sR[1];
+  e[2] = std::nan("");
+  T[0] = T[1] = T[2] = 300.0;
+  EXPECT_EQ(
+    nasa9TemperatureFromEnergy(
+      table, 3, &e[0], &R[0], &Y[0], &T[0], &sCp[0], &sH[0], status
+    ),
+    -1
+  );
+  EXPECT_EQ(status[0], NASA9_TEMPERATURE_LIMITED);
+  EXPECT_EQ(status[1], NASA9_TEMPERATURE_LIMITED);
+  EXPECT_EQ(status[2], NASA9_TEMPERATURE_NOT_CONVERGED);
+}
+
+// The lookup table interpolates the species polynomials within the error it
+// reports, and cubic interpolation is more accurate than linear interpolation
+// on the same grid.
+TEST(NASA9, LookupTableMatchesSpeciesPolynomials) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  NASA9LookupTable cubic, linear;
+  double const cubicError = initNASA9LookupTable(
+    cubic, Ns, thermo, sR, 10.0, NASA9_INTERPOLATION_CUBIC
+  );
+  double const linearError = initNASA9LookupTable(
+    linear, Ns, thermo, sR, 10.0, NASA9_INTERPOLATION_LINEAR
+  );
+  EXPECT_EQ(cubic.tMin, 200.0);
+  EXPECT_EQ(cubic.tMax, 6000.0);
+  EXPECT_EQ(cubic.nPoints, 581);
+  EXPECT_LT(cubicError, 1.0e-3);
+  EXPECT_LT(cubicError, linearError);
+
+  for(double T = 203.7; T < 6000.0; T += 97.3) {
+    double sCp[Ns], sH[Ns], sS[Ns];
+    nasa9_sCp_sH_from_T(Ns, sCp, sH, thermo, sR, T);
+    nasa9_sS_from_T(Ns, sS, thermo, sR, T);
+
+    double tCp[Ns], tH[Ns], tS[Ns];
+    nasa9LookupSpecies(cubic, T, tCp, tH, tS);
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(tCp[s], sCp[s], cubicError*sCp[s]);
+      EXPECT_NEAR(tH[s], sH[s], cubicError*sCp[s]*T);
+      EXPECT_NEAR(tS[s], sS[s], cubicError*sCp[s]);
+    }
+
+    nasa9LookupSpecies(linear, T, tCp, tH, tS);
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(tCp[s], sCp[s], linearError*sCp[s]);
+      EXPECT_NEAR(tH[s], sH[s], linearError*sCp[s]*T);
+      EXPECT_NEAR(tS[s], sS[s], linearError*sCp[s]);
+    }
+  }
+}
+
+// Temperatures are recovered from the energy with the species properties
+// interpolated from the lookup table, to the accuracy of the interpolation.
+TEST(NASA9, LookupTemperatureFromEnergy) {
+  NASA9Thermochemistry thermo[Ns];
+  double sR[Ns];
+  makeThermo(thermo, sR);
+
+  NASA9LookupTable lookup;
+  initNASA9LookupTable(lookup, Ns, thermo, sR, 10.0, NASA9_INTERPOLATION_CUBIC);
+
+  int const B = FLAME_NASA9_BLOCK_SIZE;
+  int const n = B-5;
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dT(250.0, 5500.0);
+  std::uniform_real_distribution<double> dY(0.0, 1.0);
+
+  std::vector<double> e(B), R(B), T(B), Texact(B);
+  std::vector<double> Y(Ns*B), sCp(Ns*B), sH(Ns*B);
+  for(int i = 0; i < n; ++i) {
+    double Yi[Ns], sum = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      Yi[s] = dY(gen);
+      sum += Yi[s];
+    }
+    R[i] = 0.0;
+    for(int s = 0; s < Ns; ++s) {
+      Yi[s] /= sum;
+      Y[s*B+i] = Yi[s];
+      R[i] += Yi[s]*sR[s];
+    }
+    Texact[i] = dT(gen);
+    e[i] = energy(thermo, sR, Yi, Texact[i]);
+    T[i] = 1000.0;
+  }
+
+  int const iter = nasa9TemperatureFromEnergy(
+    lookup, n, &e[0], &R[0], &Y[0], &T[0], &sCp[0], &sH[0]
+  );
+  EXPECT_LT(iter, FLAME_NASA9_MAX_ITERATIONS);
+
+  for(int i = 0; i < n; ++i) {
+    EXPECT_NEAR(T[i], Texact[i], 1.0e-3*Texact[i]);
+
+    double tCp[Ns], tH[Ns], tS[Ns];
+    nasa9LookupSpecies(lookup, T[i], tCp, tH, tS);
+    for(int s = 0; s < Ns; ++s) {
+      EXPECT_NEAR(sCp[s*B+i], tCp[s], 1.0e-12*tCp[s]);
+      EXPECT_NEAR(sH[s*B+i], tH[s], 1.0e-9*(std::fabs(tH[s])+tCp[s]*T[i]));
+    }
+  }
+}
@@ -0,0 +1,281 @@
+#include <partition_renumbering.hh>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+int const n = 8;
+
+// Grid of n x n cells partitioned into columns over the processes of comm.
+// The cells of a process take a contiguous range of numbers in random order,
+// as a grid generator with poor locality would write them. The internal faces
+// are owned by the process of their left cell and ordered by their numbers
+// after the cells. The cells of the process are ordered row by row.
+struct Grid {
+  int P, me;
+  std::vector<int> owner;
+  std::vector<int> number;
+  PartitionRenumbering renumbering;
+};
+
+void createGrid(Grid & grid, MPI_Comm comm) {
+  MPI_Comm_size(comm, &grid.P);
+  MPI_Comm_rank(comm, &grid.me);
+  int const P = grid.P;
+
+  grid.owner.resize(n*n);
+  for(int j = 0; j < n; ++j) {
+    for(int i = 0; i < n; ++i) {
+      grid.owner[j*n+i] = i*P/n;
+    }
+  }
+
+  std::mt19937 gen(7);
+  grid.number.resize(n*n);
+  int next = 0;
+  for(int p = 0; p < P; ++p) {
+    std::vector<int> cells;
+    for(int c = 0; c < n*n; ++c) {
+      if(grid.owner[c] == p) {
+        cells.push_back(c);
+      }
+    }
+    std::vector<int> numbers(cells.size());
+    std::iota(numbers.begin(), numbers.end(), next);
+    std::shuffle(numbers.begin(), numbers.end(), gen);
+    for(std::size_t k = 0; k < cells.size(); ++k) {
+      grid.number[cells[k]] = numbers[k];
+    }
+    next += cells.size();
+  }
+
+  PartitionRenumbering & r = grid.renumbering;
+  std::vector<int> rowMajor;
+  for(int c = 0; c < n*n; ++c) {
+    if(grid.owner[c] == grid.me) {
+      r.cells.push_back(grid.number[c]);
+      rowMajor.push_back(grid.number[c]);
+    }
+  }
+  std::sort(r.cells.begin(), r.cells.end());
+  for(std::size_t k = 0; k < rowMajor.size(); ++k) {
+    r.order.push_back(
+      std::lower_bound(r.cells.begin(), r.cells.end(), rowMajor[k])-r.cells.begin()
+    );
+  }
+
+  for(int p = 0; p < P; ++p) {
+    for(int j = 0; j < n; ++j) {
+      for(int i = 0; i < n; ++i) {
+        int const c = j*n+i;
+        if(grid.owner[c] != p) {
+          continue;
+        }
+        int const neighbors[2] = {i+1 < n ? c+1 : -1, j+1 < n ? c+n : -1};
+        for(int k = 0; k < 2; ++k) {
+          int const d = neighbors[k];
+          if(d >= 0) {
+            if(p == grid.me) {
+              r.faces.push_back(next);
+              r.left.push_back(grid.number[c]);
+              r.right.push_back(grid.number[d]);
+              r.leftOwner.push_back(p);
+              r.rightOwner.push_back(grid.owner[d]);
+            }
+            ++next;
+          }
+        }
+      }
+    }
+  }
+}
+
+int lookup(std::vector<std::pair<int, int> > const & remap, int const e) {
+  for(std::size_t i = 0; i < remap.size(); ++i) {
+    if(remap[i].first == e) {
+      return remap[i].second;
+    }
+  }
+  return e;
+}
+
+// Checks that the cells and faces of the process of grid are permuted among
+// their numbers, the cells row by row and the faces by their new cells.
+void checkRenumbering(Grid const & grid) {
+  PartitionRenumbering const & r = grid.renumbering;
+  ASSERT_EQ(r.remap.size(), r.cells.size()+r.faces.size());
+  ASSERT_TRUE(std::is_sorted(r.remap.begin(), r.remap.end()));
+
+  std::vector<int> owned(r.cells), renumbered;
+  owned.insert(owned.end(), r.faces.begin(), r.faces.end());
+  for(std::size_t i = 0; i < r.remap.size(); ++i) {
+    renumbered.push_back(r.remap[i].second);
+  }
+  std::sort(owned.begin(), owned.end());
+  std::sort(renumbered.begin(), renumbered.end());
+  EXPECT_EQ(renumbered, owned);
+
+  int previous = -1;
+  int moved = 0;
+  for(int c = 0; c < n*n; ++c) {
+    if(grid.owner[c] == grid.me) {
+      int const newNumber = lookup(r.remap, grid.number[c]);
+      EXPECT_GT(newNumber, previous);
+      previous = newNumber;
+      moved += newNumber != grid.number[c];
+    }
+  }
+  EXPECT_GT(moved, 0);
+
+  std::vector<std::pair<std::pair<int, int>, int> > keys;
+  for(std::size_t f = 0; f < r.faces.size(); ++f) {
+    int const lo = lookup(r.leftOwner[f] == grid.me ? r.remap : r.remoteRemap, r.left[f]);
+    int const ro = lookup(r.rightOwner[f] == grid.me ? r.remap : r.remoteRemap, r.right[f]);
+    keys.push_back(std::make_pair(
+      std::make_pair(std::min(lo, ro), std::max(lo, ro)), lookup(r.remap, r.faces[f])
+    ));
+  }
+  std::sort(
+    keys.begin(), keys.end(),
+    [](std::pair<std::pair<int, int>, int> const & a,
+      std::pair<std::pair<int, int>, int> const & b) {
+      return a.second < b.second;
+    }
+  );
+  for(std::size_t k = 1; k < keys.size(); ++k) {
+    EXPECT_LE(keys[k-1].first, keys[k].first);
+  }
+}
+
+// Values of the cells of the process of grid in the order of the grid file as
+// writeRenumberedContainer writes them after renumbering: the value of each
+// cell, its index in the grid, is stored at its number in the file.
+std::map<int, int> writeCells(Grid const & grid) {
+  std::vector<std::pair<int, int> > inverse;
+  invertRenumbering(grid.renumbering.remap, inverse);
+  std::map<int, int> values, file;
+  for(int c = 0; c < n*n; ++c) {
+    if(grid.owner[c] == grid.me) {
+      values[renumberedEntity(grid.renumbering.remap, grid.number[c])] = c;
+    }
+  }
+  for(std::map<int, int>::const_iterator vi = values.begin(); vi != values.end(); ++vi) {
+    file[renumberedEntity(inverse, vi->first)] = vi->second;
+  }
+  return file;
+}
+
+// Checks that the values of file, read as readRenumberedContainer does into
+// the cells of the process of grid, reach the cells they were written from.
+void checkReadCells(Grid const & grid, std::map<int, int> const & file) {
+  std::vector<std::pair<int, int> > inverse;
+  invertRenumbering(grid.renumbering.remap, inverse);
+  for(int c = 0; c < n*n; ++c) {
+    if(grid.owner[c] == grid.me) {
+      int const e = renumberedEntity(grid.renumbering.remap, grid.number[c]);
+      std::map<int, int>::const_iterator fi = file.find(renumberedEntity(inverse, e));
+      ASSERT_TRUE(fi != file.end());
+      EXPECT_EQ(fi->second, c);
+    }
+  }
+}
+
+} // end: anonymous namespace
+
+TEST(PartitionRenumbering, SingleProcess) {
+  Grid grid;
+  createGrid(grid, MPI_COMM_SELF);
+  renumberPartition(grid.renumbering, MPI_COMM_SELF);
+
+  EXPECT_TRUE(grid.renumbering.remoteRemap.empty());
+  checkRenumbering(grid);
+}
+
+// Run with mpirun -np 2 (or more).
+TEST(PartitionRenumbering, TwoProcesses) {
+  int P;
+  MPI_Comm_size(MPI_COMM_WORLD, &P);
+  if(P < 2) {
+    GTEST_SKIP() << "requires 2 or more processes";
+  }
+
+  Grid grid;
+  createGrid(grid, MPI_COMM_WORLD);
+  renumberPartition(grid.renumbering, MPI_COMM_WORLD);
+  checkRenumbering(grid);
+
+  // The new numbers of the cells of other processes are the ones their owners
+  // gave them.
+  PartitionRenumbering const & r = grid.renumbering;
+  std::vector<int> local(2*r.remap.size());
+  for(std::size_t i = 0; i < r.remap.size(); ++i) {
+    local[2*i] = r.remap[i].first;
+    local[2*i+1] = r.remap[i].second;
+  }
+  int const size = local.size();
+  std::vector<int> sizes(P), offsets(P+1, 0);
+  MPI_Allgather(&size, 1, MPI_INT, &sizes[0], 1, MPI_INT, MPI_COMM_WORLD);
+  for(int p = 0; p < P; ++p) {
+    offsets[p+1] = offsets[p]+sizes[p];
+  }
+  std::vector<int> all(offsets[P]);
+  MPI_Allgatherv(
+    &local[0], size, MPI_INT, &all[0], &sizes[0], &offsets[0], MPI_INT,
+    MPI_COMM_WORLD
+  );
+  std::vector<std::pair<int, int> > global;
+  for(int i = 0; i < offsets[P]; i += 2) {
+    global.push_back(std::make_pair(all[i], all[i+1]));
+  }
+
+  if(grid.me == 0) {
+    EXPECT_FALSE(r.remoteRemap.empty());
+  }
+  for(std::size_t i = 0; i < r.remoteRemap.size(); ++i) {
+    EXPECT_EQ(r.remoteRemap[i].second, lookup(global, r.remoteRemap[i].first));
+  }
+}
+
+// A restart written after renumbering the cells row by row is read back into
+// the cells renumbered column by column, and without renumbering.
+TEST(PartitionRenumbering, RestartRoundTrip) {
+  Grid grid;
+  createGrid(grid, MPI_COMM_WORLD);
+  renumberPartition(grid.renumbering, MPI_COMM_WORLD);
+  std::map<int, int> const file = writeCells(grid);
+  for(int c = 0; c < n*n; ++c) {
+    if(grid.owner[c] == grid.me) {
+      EXPECT_EQ(file.at(grid.number[c]), c);
+    }
+  }
+
+  Grid restart;
+  createGrid(restart, MPI_COMM_WORLD);
+  PartitionRenumbering & r = restart.renumbering;
+  std::vector<int> columnMajor;
+  for(int i = 0; i < n; ++i) {
+    for(int j = 0; j < n; ++j) {
+      if(restart.owner[j*n+i] == restart.me) {
+        columnMajor.push_back(restart.number[j*n+i]);
+      }
+    }
+  }
+  for(std::size_t k = 0; k < columnMajor.size(); ++k) {
+    r.order[k] = std::lower_bound(r.cells.begin(), r.cells.end(), columnMajor[k])-r.cells.begin();
+  }
+  renumberPartition(r, MPI_COMM_WORLD);
+  checkReadCells(restart, file);
+
+  Grid none;
+  createGrid(none, MPI_COMM_WORLD);
+  checkReadCells(none, file);
+}
@@ -0,0 +1,246 @@
+#include <preconditioning.hh>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+double const Runiv = 8314.46;
+
+// Ideal gas mixture of species with constant specific heats. The primitive
+// variables are W = (p, u, v, w, T, Y_0, ..., Y_{Ns-2}), the conservative
+// variables are in the layout of msResidual.
+struct Mixture {
+  int Ns;
+  std::vector<double> sW, sCp, shf;
+
+  void conservative(std::vector<double> const & W, std::vector<double> & Q) const {
+    std::vector<double> Y(Ns);
+    double sumY = 0.0;
+    for(int i = 0; i < Ns-1; ++i) {
+      Y[i] = W[5+i];
+      sumY += Y[i];
+    }
+    Y[Ns-1] = 1.0-sumY;
+
+    double Winv = 0.0, h = 0.0;
+    for(int i = 0; i < Ns; ++i) {
+      Winv += Y[i]/sW[i];
+      h += Y[i]*(shf[i]+sCp[i]*W[4]);
+    }
+    double const rho = W[0]/(Runiv*Winv*W[4]);
+    double const ke = 0.5*(W[1]*W[1]+W[2]*W[2]+W[3]*W[3]);
+
+    Q.resize(Ns+4);
+    Q[0] = rho*W[1];
+    Q[1] = rho*W[2];
+    Q[2] = rho*W[3];
+    Q[3] = rho*(h+ke)-W[0];
+    Q[4] = rho;
+    for(int i = 0; i < Ns-1; ++i) {
+      Q[5+i] = rho*Y[i];
+    }
+  }
+
+  // Jacobian dQ/dW by central differences; J[j][k] is dQ_j/dW_k.
+  void jacobian(std::vector<double> const & W, std::vector<std::vector<double> > & J) const {
+    int const n = Ns+4;
+    J.assign(n, std::vector<double>(n, 0.0));
+    std::vector<double> Wp, Wm, Qp, Qm;
+    for(int k = 0; k < n; ++k) {
+      double const h = 1.0e-6*(std::fabs(W[k])+1.0e-3);
+      Wp = W;
+      Wm = W;
+      Wp[k] += h;
+      Wm[k] -= h;
+      conservative(Wp, Qp);
+      conservative(Wm, Qm);
+      for(int j = 0; j < n; ++j) {
+        J[j][k] = (Qp[j]-Qm[j])/(2.0*h);
+      }
+    }
+  }
+};
+
+// Solves A*x = b by Gaussian elimination with partial pivoting.
+std::vector<double> solve(std::vector<std::vector<double> > A, std::vector<double> b) {
+  int const n = int(b.size());
+  for(int k = 0; k < n; ++k) {
+    int p = k;
+    for(int i = k+1; i < n; ++i) {
+      if(std::fabs(A[i][k]) > std::fabs(A[p][k])) {
+        p = i;
+      }
+    }
+    std::swap(A[k], A[p]);
+    std::swap(b[k], b[p]);
+    for(int i = k+1; i < n; ++i) {
+      double const f = A[i][k]/A[k][k];
+      for(int j = k; j < n; ++j) {
+        A[i][j] -= f*A[k][j];
+      }
+      b[i] -= f*b[k];
+    }
+  }
+  std::vector<double> x(n);
+  for(int i = n-1; i >= 0; --i) {
+    double sum = b[i];
+    for(int j = i+1; j < n; ++j) {
+      sum -= A[i][j]*x[j];
+    }
+    x[i] = sum/A[i][i];
+  }
+  return x;
+}
+
+// Compares preconditionResidual with dQ/dW*Gamma^-1*R computed from the
+// Jacobian of the mixture.
+void checkAgainstMatrix(Mixture const & mix, double const Mach, double const Mcut) {
+  int const Ns = mix.Ns;
+  int const n = Ns+4;
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  std::vector<double> W(n);
+  W[0] = 1.0e5;
+  W[4] = 800.0;
+  std::vector<double> Y(Ns);
+  double sumY = 0.0;
+  for(int i = 0; i < Ns; ++i) {
+    Y[i] = 1.0+0.5*dist(gen);
+    sumY += Y[i];
+  }
+  for(int i = 0; i < Ns; ++i) {
+    Y[i] /= sumY;
+  }
+  for(int i = 0; i < Ns-1; ++i) {
+    W[5+i] = Y[i];
+  }
+
+  double Winv = 0.0, Cp = 0.0, h = 0.0;
+  std::vector<double> sh(Ns);
+  for(int i = 0; i < Ns; ++i) {
+    Winv += Y[i]/mix.sW[i];
+    Cp += Y[i]*mix.sCp[i];
+    sh[i] = mix.shf[i]+mix.sCp[i]*W[4];
+    h += Y[i]*sh[i];
+  }
+  double const mW = 1.0/Winv;
+  double const R = Runiv/mW;
+  double const a = std::sqrt(Cp/(Cp-R)*R*W[4]);
+
+  Loci::vector3d<double> const U(0.6*Mach*a, -0.3*Mach*a, 0.2*Mach*a);
+  W[1] = U.x;
+  W[2] = U.y;
+  W[3] = U.z;
+  double const h0 = h+0.5*dot(U, U);
+  double const Ur = lowMachReferenceVelocity(std::sqrt(dot(U, U)), a, Mcut);
+
+  std::vector<std::vector<double> > P;
+  mix.jacobian(W, P);
+
+  // Gamma differs from P in the pressure column.
+  std::vector<std::vector<double> > Gamma = P;
+  double const dtheta = 1.0/(Ur*Ur)-1.0/(a*a);
+  double column[3] = {U.x, U.y, U.z};
+  for(int j = 0; j < 3; ++j) {
+    Gamma[j][0] += dtheta*column[j];
+  }
+  Gamma[3][0] += dtheta*h0;
+  Gamma[4][0] += dtheta;
+  for(int i = 0; i < Ns-1; ++i) {
+    Gamma[5+i][0] += dtheta*Y[i];
+  }
+
+  std::vector<double> res(n);
+  for(int j = 0; j < n; ++j) {
+    res[j] = dist(gen);
+  }
+  res[3] *= 1.0e5;
+
+  std::vector<double> const x = solve(Gamma, res);
+  std::vector<double> expected(n, 0.0);
+  for(int j = 0; j < n; ++j) {
+    for(int k = 0; k < n; ++k) {
+      expected[j] += P[j][k]*x[k];
+    }
+  }
+
+  std::vector<double> actual(res);
+  preconditionResidual(
+    &actual[0], Ns, U, h0, Cp, W[4], a, Ur,
+    &Y[0], &sh[0], &mix.sW[0], mW
+  );
+
+  for(int j = 0; j < n; ++j) {
+    double const scale = j == 3 ? 1.0e5*(1.0+1.0/(Mcut*Mcut)) : 1.0+1.0/(Mcut*Mcut);
+    EXPECT_NEAR(actual[j], expected[j], 1.0e-6*scale) << "component " << j;
+  }
+}
+
+} // end: anonymous namespace
+
+TEST(LowMachPreconditioning, SpectralRadius) {
+  double const a = 340.0;
+
+  // Without preconditioning the spectral radius is |Un|+a.
+  EXPECT_NEAR(preconditionedSpectralRadius(-20.0, a, a), 20.0+a, 1.0e-10);
+
+  // At rest the preconditioned spectral radius is the reference velocity.
+  EXPECT_NEAR(preconditionedSpectralRadius(0.0, a, 5.0), 5.0, 1.0e-10);
+
+  // At low Mach number with Ur = |Un| the acoustic speed is removed.
+  double const Un = 0.01*a;
+  double const lambda = preconditionedSpectralRadius(Un, a, lowMachReferenceVelocity(Un, a, 1.0e-3));
+  EXPECT_LT(lambda, 3.0*Un);
+  EXPECT_GT(lambda, Un);
+}
+
+TEST(LowMachPreconditioning, ReferenceVelocity) {
+  double const a = 340.0;
+  EXPECT_DOUBLE_EQ(lowMachReferenceVelocity(10.0, a, 0.1), 34.0);
+  EXPECT_DOUBLE_EQ(lowMachReferenceVelocity(100.0, a, 0.1), 100.0);
+  EXPECT_DOUBLE_EQ(lowMachReferenceVelocity(500.0, a, 0.1), a);
+}
+
+TEST(LowMachPreconditioning, SingleSpeciesMatchesMatrix) {
+  Mixture mix;
+  mix.Ns = 1;
+  mix.sW = {28.97};
+  mix.sCp = {1005.0};
+  mix.shf = {0.0};
+
+  checkAgainstMatrix(mix, 0.05, 0.01);
+  checkAgainstMatrix(mix, 0.5, 0.01);
+}
+
+TEST(LowMachPreconditioning, MultiSpeciesMatchesMatrix) {
+  Mixture mix;
+  mix.Ns = 4;
+  mix.sW = {2.016, 31.998, 18.015, 28.014};
+  mix.sCp = {14300.0, 920.0, 1860.0, 1040.0};
+  mix.shf = {0.0, 0.0, -1.34e7, 0.0};
+
+  checkAgainstMatrix(mix, 0.05, 0.01);
+  checkAgainstMatrix(mix, 0.5, 0.01);
+}
+
+TEST(LowMachPreconditioning, IdentityWithoutPreconditioning) {
+  int const Ns = 1;
+  Loci::vector3d<double> const U(30.0, -4.0, 2.0);
+  double const T = 300.0, Cp = 1005.0, a = std::sqrt(1.4*287.0*T);
+  double R[5] = {1.0, -2.0, 0.5, 3.0e4, 0.1};
+  double const expected[5] = {1.0, -2.0, 0.5, 3.0e4, 0.1};
+
+  preconditionResidual(R, Ns, U, Cp*T+0.5*dot(U, U), Cp, T, a, a, 0, 0, 0, 28.97);
+
+  for(int j = 0; j < 5; ++j) {
+    EXPECT_NEAR(R[j], expected[j], 1.0e-9*(1.0+std::fabs(expected[j])));
+  }
+}
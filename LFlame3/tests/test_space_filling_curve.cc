@@ -0,0 +1,74 @@
+#include <space_filling_curve.hh>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace flame;
+
+TEST(SpaceFillingCurve, MortonKeyInterleavesBits) {
+  EXPECT_EQ(mortonKey(0, 0, 0, 4), 0u);
+  EXPECT_EQ(mortonKey(1, 0, 0, 4), 4u);
+  EXPECT_EQ(mortonKey(0, 1, 0, 4), 2u);
+  EXPECT_EQ(mortonKey(0, 0, 1, 4), 1u);
+  EXPECT_EQ(mortonKey(3, 3, 3, 4), 63u);
+  EXPECT_EQ(mortonKey(2, 0, 0, 4), 32u);
+
+  std::uint32_t const m = (std::uint32_t(1) << FLAME_SFC_BITS)-1;
+  EXPECT_EQ(mortonKey(m, m, m, FLAME_SFC_BITS), (std::uint64_t(1) << 3*FLAME_SFC_BITS)-1);
+}
+
+TEST(SpaceFillingCurve, HilbertKeyVisitsNeighbors) {
+  int const bits = 3;
+  int const n = 1 << bits;
+
+  std::vector<int> cell(n*n*n, -1);
+  for(int x = 0; x < n; ++x) {
+    for(int y = 0; y < n; ++y) {
+      for(int z = 0; z < n; ++z) {
+        std::uint64_t const key = hilbertKey(x, y, z, bits);
+        ASSERT_LT(key, std::uint64_t(n*n*n));
+        ASSERT_EQ(cell[key], -1);
+        cell[key] = (x*n+y)*n+z;
+      }
+    }
+  }
+
+  for(int k = 1; k < n*n*n; ++k) {
+    int const a = cell[k-1], b = cell[k];
+    int const dist = std::abs(a/(n*n)-b/(n*n))+std::abs(a/n%n-b/n%n)+std::abs(a%n-b%n);
+    EXPECT_EQ(dist, 1) << "keys " << k-1 << " and " << k;
+  }
+}
+
+TEST(SpaceFillingCurve, OrderFollowsHilbertCurve) {
+  int const n = 16;
+
+  std::vector<Loci::vector3d<double>> points;
+  for(int x = 0; x < n; ++x) {
+    for(int y = 0; y < n; ++y) {
+      for(int z = 0; z < n; ++z) {
+        points.push_back(Loci::vector3d<double>(0.5*x, 0.5*y, 0.5*z));
+      }
+    }
+  }
+  std::shuffle(points.begin(), points.end(), std::mt19937(1));
+
+  std::vector<int> order;
+  spaceFillingCurveOrder(points, SpaceFillingCurve::Hilbert, order);
+
+  ASSERT_EQ(order.size(), points.size());
+  std::vector<int> sorted(order);
+  std::sort(sorted.begin(), sorted.end());
+  for(int i = 0; i < int(sorted.size()); ++i) {
+    ASSERT_EQ(sorted[i], i);
+  }
+
+  for(int k = 1; k < int(order.size()); ++k) {
+    Loci::vector3d<double> const d = points[order[k]]-points[order[k-1]];
+    EXPECT_DOUBLE_EQ(std::abs(d.x)+std::abs(d.y)+std::abs(d.z), 0.5);
+  }
+}
@@ -0,0 +1,54 @@
+#include <transport.hh>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+// Row-major matrix of order N with phi[k][m] at k*N+m.
+struct Matrix {
+  double * p;
+  int N;
+  double * operator[](int const k) const {
+    return p+k*N;
+  }
+};
+
+} // end: anonymous namespace
+
+TEST(WilkeTransport, MatchesWilkeFormula) {
+  int const N = 12;
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> weight(1.0, 200.0);
+  std::uniform_real_distribution<double> viscosity(1.0e-5, 8.0e-5);
+
+  std::vector<double> W(N), mu(N);
+  for(int k = 0; k < N; ++k) {
+    W[k] = weight(gen);
+    mu[k] = viscosity(gen);
+  }
+
+  std::vector<double> factors;
+  initWilkeTransportFactors(N, &W[0], factors);
+  ASSERT_EQ(factors.size(), 2u*N*N);
+
+  std::vector<double> phi(N*N);
+  Matrix m = {&phi[0], N};
+  wilkeTransportPhi(m, N, &factors[0], &mu[0]);
+
+  for(int k = 0; k < N; ++k) {
+    for(int j = 0; j < N; ++j) {
+      double const wratio = W[k]/W[j];
+      double const muratio = mu[k]/mu[j];
+      double const expected = pow(8.0*(1.0+wratio), -0.5)
+        * pow(1.0+sqrt(muratio)*pow(1.0/wratio, 0.25), 2.0);
+      EXPECT_NEAR(phi[k*N+j], expected, 1.0e-14*expected);
+    }
+    EXPECT_NEAR(phi[k*N+k], 1.0, 1.0e-14);
+  }
+}
@@ -0,0 +1,662 @@
+// Generator of rate kernels specialized for a reaction mechanism. It reads a
+// mixture file of the flame-mixture.xsd schema, builds the table of the
+// mechanism as initKineticsTable does, and writes C++ source with the
+// production rates of a block of cells and the molar rates and their analytic
+// Jacobian of one cell, with every reaction unrolled and its coefficients as
+// constants. The source registers the kernels under the hash of the table, so
+// that a table built from the same mechanism uses them.
+//
+// Usage: LFlame3MechGen <mixture.xml> [name] > <name>.cc
+// The name of the mechanism defaults to the base name of the file.
+
+#include <kinetics_registry.hh>
+#include <mixture.hh>
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace flame;
+
+namespace {
+
+// Universal gas constant of the solver: [J/kmol.K].
+double const Runiv = FLAME_RUNIV;
+
+// Literal of a double that reads back as the same value.
+std::string lit(double const x) {
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%.17g", x == 0.0 ? 0.0 : x);
+  std::string s(buf);
+  if(s.find_first_of(".eEn") == std::string::npos) {
+    s += ".0";
+  }
+  return s;
+}
+
+// Term c*v of a sum that follows other terms, with its sign as the operator.
+std::string term(double const c, std::string const & v) {
+  if(c == 0.0) {
+    return "";
+  }
+  std::string const op = c < 0.0 ? " - " : " + ";
+  double const a = std::fabs(c);
+  return a == 1.0 ? op+v : op+lit(a)+"*"+v;
+}
+
+// Constant c of a sum that follows other terms.
+std::string constant(double const c) {
+  if(c == 0.0) {
+    return "";
+  }
+  return (c < 0.0 ? " - " : " + ")+lit(std::fabs(c));
+}
+
+// Concentration of species s raised to nu, and its derivative.
+std::string power(int const s, double const nu) {
+  std::string const C = "C" + std::to_string(s);
+  if(nu == 1.0) {
+    return C;
+  } else if(nu == 2.0) {
+    return C+"*"+C;
+  }
+  return "std::pow("+C+", "+lit(nu)+")";
+}
+
+std::string powerDerivative(int const s, double const nu) {
+  std::string const C = "C" + std::to_string(s);
+  if(nu == 1.0) {
+    return "1.0";
+  } else if(nu == 2.0) {
+    return "2.0*"+C;
+  }
+  return lit(nu)+"*std::pow("+C+", "+lit(nu-1.0)+")";
+}
+
+// Product of the concentrations of the entries [begin, end), and its
+// derivative with respect to the concentration of entry j.
+std::string product(
+  int const begin, int const end,
+  std::vector<int> const & species, std::vector<double> const & coeff
+) {
+  std::string p;
+  for(int i = begin; i < end; ++i) {
+    p += (p.empty() ? "" : "*") + power(species[i], coeff[i]);
+  }
+  return p.empty() ? "1.0" : p;
+}
+
+std::string productDerivative(
+  int const begin, int const end, int const j,
+  std::vector<int> const & species, std::vector<double> const & coeff
+) {
+  std::string p = powerDerivative(species[j], coeff[j]);
+  for(int i = begin; i < end; ++i) {
+    if(i != j) {
+      p = (p == "1.0" ? "" : p+"*") + power(species[i], coeff[i]);
+    }
+  }
+  return p;
+}
+
+// Product of a and b, without a factor of 1.
+std::string times(std::string const & a, std::string const & b) {
+  return b == "1.0" ? a : a+"*"+b;
+}
+
+// Statement that adds c*v to target.
+std::string accumulate(std::string const & target, double const c, std::string const & v) {
+  double const a = std::fabs(c);
+  return target + (c < 0.0 ? " -= " : " += ") + (a == 1.0 ? "" : lit(a)+"*") + v
+    + ";\n";
+}
+
+// Exponent ln(A)+b*ln(T)-Ta/T of a rate constant.
+std::string arrhenius(double const lnA, double const b, double const Ta) {
+  return lit(lnA)+term(b, "lnT")+term(-Ta, "rT");
+}
+
+// Derivative of the exponent with respect to T.
+std::string arrheniusDerivative(double const b, double const Ta) {
+  if(Ta == 0.0) {
+    return b == 0.0 ? "0.0" : lit(b)+"*rT";
+  }
+  return "("+lit(b)+term(Ta, "rT")+")*rT";
+}
+
+// Equation of reaction r, e.g. "H2 + O2 <=> 2 OH".
+std::string equation(Mixture const & mixture, Reaction const & reaction) {
+  std::ostringstream ss;
+  for(int j = 0; j < reaction.nReactants; ++j) {
+    ss << (j ? " + " : "");
+    if(reaction.reactantCoeff[j] != 1.0) {
+      ss << reaction.reactantCoeff[j] << " ";
+    }
+    ss << mixture.speciesName[reaction.reactantSpecies[j]];
+  }
+  if(reaction.hasThirdBody && reaction.falloffModel == FALLOFF_NONE) {
+    ss << " + M";
+  } else if(reaction.falloffModel != FALLOFF_NONE) {
+    ss << " (+M)";
+  }
+  ss << (reaction.reversible ? " <=> " : " => ");
+  for(int j = 0; j < reaction.nProducts; ++j) {
+    ss << (j ? " + " : "");
+    if(reaction.productCoeff[j] != 1.0) {
+      ss << reaction.productCoeff[j] << " ";
+    }
+    ss << mixture.speciesName[reaction.productSpecies[j]];
+  }
+  if(reaction.hasThirdBody && reaction.falloffModel == FALLOFF_NONE) {
+    ss << " + M";
+  } else if(reaction.falloffModel != FALLOFF_NONE) {
+    ss << " (+M)";
+  }
+  return ss.str();
+}
+
+// Dimensionless Gibbs energy of species s at temperature t of range k, and its
+// derivative with respect to t.
+std::string gibbs(KineticsTable const & table, int const s, int const k) {
+  double const * c =
+    &table.gibbsCoefficients[(2*s+k)*FLAME_KINETICS_NCOEFF];
+  return "(" + lit(c[0])+"*rT"+term(c[1], "lnT")+constant(c[3])+")*rT"
+    + term(c[2], "lnT")+constant(c[4])
+    + " + t*("+lit(c[5])+" + t*("+lit(c[6])+" + t*("+lit(c[7])
+    + term(c[8], "t")+")))";
+}
+
+std::string gibbsDerivative(KineticsTable const & table, int const s, int const k) {
+  double const * c =
+    &table.gibbsCoefficients[(2*s+k)*FLAME_KINETICS_NCOEFF];
+  return "((" + lit(-2.0*c[0])+"*rT"+term(c[1], "(1.0-lnT)")+constant(-c[3])
+    + ")*rT"+constant(c[2])+")*rT"
+    + constant(c[5])+" + t*("+lit(2.0*c[6])+" + t*("+lit(3.0*c[7])
+    + term(4.0*c[8], "t")+"))";
+}
+
+// Third-body concentration M of reaction r.
+std::string thirdBody(KineticsTable const & table, int const r) {
+  std::string M = "Ctot";
+  for(int j = table.efficiencyOffset[r]; j < table.efficiencyOffset[r+1]; ++j) {
+    M += term(
+      table.efficiency[j], "C"+std::to_string(table.efficiencySpecies[j])
+    );
+  }
+  return M;
+}
+
+// Center broadening factor of a Troe reaction and its derivative, with the
+// terms of zero weight left out.
+std::string troeFcent(double const * t) {
+  std::string F;
+  if(t[0] != 0.0) {
+    F += lit(t[0])+"*std::exp("+lit(-t[1])+"*t)";
+  }
+  if(t[2] != 0.0) {
+    F += (F.empty() ? "" : " + ")+lit(t[2])+"*std::exp("+lit(-t[3])+"*t)";
+  }
+  if(t[4] != 0.0) {
+    F += (F.empty() ? "" : " + ")+lit(t[4])+"*std::exp("+lit(-t[5])+"*rT)";
+  }
+  return F.empty() ? "0.0" : F;
+}
+
+std::string troeFcentDerivative(double const * t) {
+  std::string F;
+  if(t[0] != 0.0) {
+    F += lit(-t[0]*t[1])+"*std::exp("+lit(-t[1])+"*t)";
+  }
+  if(t[2] != 0.0) {
+    F += (F.empty() ? "" : " + ")+lit(-t[2]*t[3])+"*std::exp("+lit(-t[3])+"*t)";
+  }
+  if(t[4] != 0.0) {
+    F += (F.empty() ? "" : " + ")+lit(t[4]*t[5])+"*rT*rT*std::exp("
+      + lit(-t[5])+"*rT)";
+  }
+  return F.empty() ? "0.0" : F;
+}
+
+// Species whose Gibbs energies enter the equilibrium constants.
+std::vector<bool> gibbsSpecies(KineticsTable const & table) {
+  std::vector<bool> used(table.nSpecies, false);
+  for(int r = 0; r < table.nReactions; ++r) {
+    if(table.reversible[r]) {
+      for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+        used[table.netSpecies[j]] = true;
+      }
+    }
+  }
+  return used;
+}
+
+void writeProductionRates(
+  std::ostream & os, Mixture const & mixture, KineticsTable const & table
+) {
+  int const Ns = table.nSpecies;
+  int const Nr = table.nReactions;
+  std::vector<bool> const used = gibbsSpecies(table);
+
+  os << "void productionRates(\n"
+     << "  KineticsTable const & /*table*/, KineticsWorkspace & /*work*/, int const n,\n"
+     << "  double const * rho, double const * T, double const * Y, double * omega\n"
+     << ") {\n"
+     << "  int const B = FLAME_KINETICS_BLOCK_SIZE;\n"
+     << "\n"
+     << "  FLAME_SIMD_LOOP\n"
+     << "  for(int i = 0; i < n; ++i) {\n"
+     << "    double const t = T[i];\n"
+     << "    double const rT = 1.0/t;\n"
+     << "    double const lnT = std::log(t);\n";
+  if(table.hasReversible) {
+    os << "    double const lnPRT = " << lit(table.lnPstdByRuniv) << " - lnT;\n";
+  }
+  os << "\n";
+
+  for(int s = 0; s < Ns; ++s) {
+    os << "    double const C" << s << " = std::max(0.0, rho[i]*Y[" << s
+       << "*B+i]*" << lit(1.0/table.W[s]) << ");\n";
+  }
+  os << "    double const Ctot = C0";
+  for(int s = 1; s < Ns; ++s) {
+    os << " + C" << s;
+  }
+  os << ";\n";
+
+  for(int s = 0; s < Ns; ++s) {
+    if(used[s]) {
+      os << "    double const g" << s << " = t < " << lit(table.tMid[s])
+         << " ?\n      " << gibbs(table, s, 0) << " :\n      "
+         << gibbs(table, s, 1) << ";\n";
+    }
+  }
+
+  for(int r = 0; r < Nr; ++r) {
+    int const type = table.type[r];
+    std::string const R = std::to_string(r);
+    os << "\n    // " << equation(mixture, mixture.reactions[r]) << "\n";
+    os << "    double const x" << R << " = "
+       << arrhenius(table.lnA[r], table.b[r], table.Ta[r]) << ";\n";
+
+    std::string fac;
+    if(type == KINETICS_THIRD_BODY) {
+      fac = "(" + thirdBody(table, r) + ")";
+    } else if(type == KINETICS_LINDEMANN || type == KINETICS_TROE) {
+      os << "    double const Pr" << R << " = std::exp("
+         << arrhenius(table.lnA0[r], table.b0[r], table.Ta0[r]) << " - x" << R
+         << ")*(" << thirdBody(table, r) << ");\n";
+      if(type == KINETICS_LINDEMANN) {
+        os << "    double const fac" << R << " = Pr" << R << "/(1.0+Pr" << R
+           << ");\n";
+      } else {
+        os << "    double const logFcent" << R << " = std::log10(std::max("
+           << troeFcent(&table.troe[6*r]) << ", 1.0e-300));\n"
+           << "    double const logPr" << R << " = std::log10(std::max(Pr" << R
+           << ", 1.0e-300));\n"
+           << "    double const c" << R << " = -0.4-0.67*logFcent" << R << ";\n"
+           << "    double const m" << R << " = 0.75-1.27*logFcent" << R << ";\n"
+           << "    double const f" << R << " = (logPr" << R << "+c" << R
+           << ")/(m" << R << "-0.14*(logPr" << R << "+c" << R << "));\n"
+           << "    double const fac" << R << " = Pr" << R << "/(1.0+Pr" << R
+           << ")*std::exp(" << lit(std::log(10.0)) << "*logFcent" << R
+           << "/(1.0+f" << R << "*f" << R << "));\n";
+      }
+      fac = "fac" + R;
+    }
+
+    os << "    double const q" << R << " = ";
+    if(!fac.empty()) {
+      os << fac << "*(";
+    }
+    os << "std::exp(x" << R << ")*" << product(
+      table.reactantOffset[r], table.reactantOffset[r+1],
+      table.reactantSpecies, table.reactantCoeff
+    );
+    if(table.reversible[r]) {
+      std::string xr = "x" + R + term(-table.dNu[r], "lnPRT");
+      for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+        xr += term(table.netCoeff[j], "g"+std::to_string(table.netSpecies[j]));
+      }
+      os << "\n      - std::exp(std::min(" << xr << ", 600.0))*" << product(
+        table.productOffset[r], table.productOffset[r+1],
+        table.productSpecies, table.productCoeff
+      );
+    }
+    os << (fac.empty() ? "" : ")") << ";\n";
+  }
+
+  // Net production of every species from the rates of its reactions.
+  os << "\n";
+  for(int s = 0; s < Ns; ++s) {
+    std::string sum;
+    for(int r = 0; r < Nr; ++r) {
+      for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+        if(table.netSpecies[j] == s) {
+          sum += term(table.netCoeff[j], "q"+std::to_string(r));
+        }
+      }
+    }
+    os << "    omega[" << s << "*B+i] = ";
+    if(sum.empty()) {
+      os << "0.0;\n";
+    } else {
+      os << lit(table.W[s]) << "*(" << (sum[1] == '+' ? sum.substr(3) : "-"+sum.substr(3))
+         << ");\n";
+    }
+  }
+
+  os << "  }\n"
+     << "}\n";
+}
+
+void writeMolarRates(
+  std::ostream & os, Mixture const & mixture, KineticsTable const & table
+) {
+  int const Ns = table.nSpecies;
+  int const Nr = table.nReactions;
+  std::vector<bool> const used = gibbsSpecies(table);
+
+  os << "template<class Jacobian>\n"
+     << "void molarRates(\n"
+     << "  double const * C, double const t, double * wdot,\n"
+     << "  Jacobian const * jacobian\n"
+     << ") {\n"
+     << "  int const Ns = " << Ns << ";\n"
+     << "  double const rT = 1.0/t;\n"
+     << "  double const lnT = std::log(t);\n";
+  if(table.hasReversible) {
+    os << "  double const lnPRT = " << lit(table.lnPstdByRuniv) << " - lnT;\n";
+  }
+  os << "\n";
+
+  for(int s = 0; s < Ns; ++s) {
+    os << "  double const C" << s << " = std::max(0.0, C[" << s << "]);\n";
+  }
+  os << "  double const Ctot = C0";
+  for(int s = 1; s < Ns; ++s) {
+    os << " + C" << s;
+  }
+  os << ";\n\n";
+
+  for(int s = 0; s < Ns; ++s) {
+    if(used[s]) {
+      os << "  bool const lower" << s << " = t < " << lit(table.tMid[s]) << ";\n"
+         << "  double const g" << s << " = lower" << s << " ?\n    "
+         << gibbs(table, s, 0) << " :\n    " << gibbs(table, s, 1) << ";\n"
+         << "  double const dg" << s << " = lower" << s << " ?\n    "
+         << gibbsDerivative(table, s, 0) << " :\n    "
+         << gibbsDerivative(table, s, 1) << ";\n";
+    }
+  }
+
+  os << "\n"
+     << "  for(int s = 0; s < Ns; ++s) {\n"
+     << "    wdot[s] = 0.0;\n"
+     << "  }\n";
+
+  for(int r = 0; r < Nr; ++r) {
+    int const type = table.type[r];
+    int const rb = table.reactantOffset[r], re = table.reactantOffset[r+1];
+    int const pb = table.productOffset[r], pe = table.productOffset[r+1];
+
+    os << "\n  // " << equation(mixture, mixture.reactions[r]) << "\n"
+       << "  {\n"
+       << "    double const x = "
+       << arrhenius(table.lnA[r], table.b[r], table.Ta[r]) << ";\n"
+       << "    double const dxdT = " << arrheniusDerivative(table.b[r], table.Ta[r])
+       << ";\n"
+       << "    double const kf = std::exp(x);\n";
+
+    if(type == KINETICS_ELEMENTARY) {
+      os << "    double const fac = 1.0, dfacdT = 0.0;\n";
+    } else if(type == KINETICS_THIRD_BODY) {
+      os << "    double const fac = " << thirdBody(table, r) << ";\n"
+         << "    double const dfacdM = 1.0, dfacdT = 0.0;\n";
+    } else {
+      os << "    double const M = " << thirdBody(table, r) << ";\n"
+         << "    double const ratio = std::exp("
+         << arrhenius(table.lnA0[r], table.b0[r], table.Ta0[r]) << " - x);\n"
+         << "    double const Pr = ratio*M;\n";
+      std::string const dx0dT =
+        arrheniusDerivative(table.b0[r], table.Ta0[r]);
+      if(type == KINETICS_LINDEMANN) {
+        os << "    double const fac = Pr/(1.0+Pr);\n"
+           << "    double const dfacdPr = 1.0/((1.0+Pr)*(1.0+Pr));\n"
+           << "    double const dfacdM = dfacdPr*ratio;\n"
+           << "    double const dfacdT = dfacdPr*Pr*(" << dx0dT << " - dxdT);\n";
+      } else {
+        double const * t = &table.troe[6*r];
+        os << "    double const Fcent = std::max(" << troeFcent(t)
+           << ", 1.0e-300);\n"
+           << "    double const dFcentdT = " << troeFcentDerivative(t) << ";\n"
+           << "    double const L = std::log10(Fcent);\n"
+           << "    double const logPr = std::log10(std::max(Pr, 1.0e-300));\n"
+           << "    double const a = logPr-0.4-0.67*L;\n"
+           << "    double const d = 0.75-1.27*L-0.14*a;\n"
+           << "    double const f = a/d;\n"
+           << "    double const g = 1.0/(1.0+f*f);\n"
+           << "    double const F = std::exp(" << lit(std::log(10.0))
+           << "*L*g);\n"
+           << "    double const dlogFdlogPr = -2.0*L*f*g*g*(0.75-1.27*L)/(d*d);\n"
+           << "    double const dlogFdL = g-2.0*L*f*g*g*(-0.67*d+1.1762*a)/(d*d);\n"
+           << "    double const fac = Pr/(1.0+Pr)*F;\n"
+           << "    double const dfacdPr = F/((1.0+Pr)*(1.0+Pr))+F*dlogFdlogPr/(1.0+Pr);\n"
+           << "    double const dfacdM = dfacdPr*ratio;\n"
+           << "    double const dfacdT = fac*dlogFdL*dFcentdT/Fcent\n"
+           << "      + dfacdPr*Pr*(" << dx0dT << " - dxdT);\n";
+      }
+    }
+
+    os << "    double const Pf = " << product(
+      rb, re, table.reactantSpecies, table.reactantCoeff
+    ) << ";\n"
+       << "    double q0 = kf*Pf;\n"
+       << "    double dq0dT = kf*dxdT*Pf;\n";
+
+    if(table.reversible[r]) {
+      std::string xr = "x" + term(-table.dNu[r], "lnPRT");
+      std::string dxr = "dxdT" + term(table.dNu[r], "rT");
+      for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+        std::string const S = std::to_string(table.netSpecies[j]);
+        xr += term(table.netCoeff[j], "g"+S);
+        dxr += term(table.netCoeff[j], "dg"+S);
+      }
+      os << "    double xr = " << xr << ";\n"
+         << "    double dxrdT = " << dxr << ";\n"
+         << "    if(xr > 600.0) {\n"
+         << "      xr = 600.0;\n"
+         << "      dxrdT = 0.0;\n"
+         << "    }\n"
+         << "    double const kr = std::exp(xr);\n"
+         << "    double const Pb = " << product(
+           pb, pe, table.productSpecies, table.productCoeff
+         ) << ";\n"
+         << "    q0 -= kr*Pb;\n"
+         << "    dq0dT -= kr*dxrdT*Pb;\n";
+    }
+
+    os << "    double const q = fac*q0;\n";
+    for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+      os << "    " << accumulate(
+        "wdot["+std::to_string(table.netSpecies[j])+"]", table.netCoeff[j], "q"
+      );
+    }
+
+    // Derivatives of q with respect to T and the concentrations, added to the
+    // rows of the net species.
+    os << "    if(jacobian != nullptr) {\n"
+       << "      double const dqdT = fac*dq0dT+q0*dfacdT;\n";
+    std::vector<std::pair<int, std::string> > dq;
+    for(int i = rb; i < re; ++i) {
+      dq.push_back(std::make_pair(
+        table.reactantSpecies[i], " + "+times("fac*kf", productDerivative(
+          rb, re, i, table.reactantSpecies, table.reactantCoeff
+        ))
+      ));
+    }
+    if(table.reversible[r]) {
+      for(int i = pb; i < pe; ++i) {
+        dq.push_back(std::make_pair(
+          table.productSpecies[i], " - "+times("fac*kr", productDerivative(
+            pb, pe, i, table.productSpecies, table.productCoeff
+          ))
+        ));
+      }
+    }
+    if(type != KINETICS_ELEMENTARY) {
+      os << "      double const dqdM = q0*dfacdM;\n";
+      for(int i = table.efficiencyOffset[r]; i < table.efficiencyOffset[r+1]; ++i) {
+        dq.push_back(std::make_pair(
+          table.efficiencySpecies[i], term(table.efficiency[i], "dqdM")
+        ));
+      }
+    }
+
+    // Sum of the contributions to each concentration derivative.
+    std::vector<std::string> dqdC(Ns);
+    for(std::size_t k = 0; k < dq.size(); ++k) {
+      dqdC[dq[k].first] += dq[k].second;
+    }
+    for(int s = 0; s < Ns; ++s) {
+      if(!dqdC[s].empty()) {
+        std::string const & e = dqdC[s];
+        os << "      double const dqdC" << s << " = "
+           << (e[1] == '+' ? e.substr(3) : "-"+e.substr(3)) << ";\n";
+      }
+    }
+
+    for(int j = table.netOffset[r]; j < table.netOffset[r+1]; ++j) {
+      int const s = table.netSpecies[j];
+      double const nu = table.netCoeff[j];
+      os << "      {\n"
+         << "        typename Jacobian::Row const Js = jacobian->row(" << s << ");\n"
+         << "        " << accumulate("Js[Ns]", nu, "dqdT");
+      for(int k = 0; k < Ns; ++k) {
+        if(!dqdC[k].empty()) {
+          os << "        " << accumulate(
+            "Js["+std::to_string(k)+"]", nu, "dqdC"+std::to_string(k)
+          );
+        }
+      }
+      if(type != KINETICS_ELEMENTARY) {
+        os << "        for(int k = 0; k < Ns; ++k) {\n"
+           << "          " << accumulate("Js[k]", nu, "dqdM")
+           << "        }\n";
+      }
+      os << "      }\n";
+    }
+    os << "    }\n"
+       << "  }\n";
+  }
+
+  os << "}\n"
+     << "\n"
+     << "void molarRatesDense(\n"
+     << "  KineticsTable const & /*table*/, double const * C, double const t,\n"
+     << "  double * wdot, double * J, int const ldJ\n"
+     << ") {\n"
+     << "  if(J == nullptr) {\n"
+     << "    molarRates<DenseJacobian>(C, t, wdot, nullptr);\n"
+     << "    return;\n"
+     << "  }\n"
+     << "  for(int s = 0; s < " << Ns << "; ++s) {\n"
+     << "    std::fill(J+s*ldJ, J+s*ldJ+" << Ns+1 << ", 0.0);\n"
+     << "  }\n"
+     << "  DenseJacobian const jacobian = {J, ldJ};\n"
+     << "  molarRates(C, t, wdot, &jacobian);\n"
+     << "}\n"
+     << "\n"
+     << "void molarRatesSparse(\n"
+     << "  KineticsTable const & /*table*/, double const * C, double const t,\n"
+     << "  double * wdot, double * J, int const * position, int const nonzeros\n"
+     << ") {\n"
+     << "  if(J == nullptr) {\n"
+     << "    molarRates<SparseJacobian>(C, t, wdot, nullptr);\n"
+     << "    return;\n"
+     << "  }\n"
+     << "  std::fill(J, J+nonzeros, 0.0);\n"
+     << "  SparseJacobian const jacobian = {J, position, " << Ns+1 << "};\n"
+     << "  molarRates(C, t, wdot, &jacobian);\n"
+     << "}\n";
+}
+
+// Identifier from the name of a mechanism.
+std::string identifier(std::string const & name) {
+  std::string id;
+  for(std::size_t i = 0; i < name.size(); ++i) {
+    char const c = name[i];
+    bool const alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9');
+    id += alnum ? c : '_';
+  }
+  return id;
+}
+
+} // end: namespace
+
+int main(int argc, char * argv[]) {
+  if(argc < 2 || argc > 3) {
+    std::cerr << "usage: " << argv[0] << " <mixture.xml> [name]" << std::endl;
+    return 1;
+  }
+
+  std::string const filename(argv[1]);
+  std::size_t const slash = filename.find_last_of('/');
+  std::string const basename =
+    slash == std::string::npos ? filename : filename.substr(slash+1);
+  std::string name;
+  if(argc == 3) {
+    name = argv[2];
+  } else {
+    name = basename.substr(0, basename.find_last_of('.'));
+  }
+
+  std::unique_ptr<Mixture> mixture(new Mixture);
+  std::ostringstream errmsg;
+  if(parseFromXML(filename, *mixture, errmsg)) {
+    std::cerr << "unable to read '" << filename << "': " << errmsg.str()
+      << std::endl;
+    return 1;
+  }
+  if(mixture->nReactions == 0) {
+    std::cerr << "'" << filename << "' has no reactions" << std::endl;
+    return 1;
+  }
+
+  KineticsTable table;
+  initKineticsTable(table, *mixture, Runiv);
+  std::uint64_t const hash = kineticsTableHash(table);
+
+  std::ostream & os = std::cout;
+  os << "// Rate kernels of mechanism " << name << ", " << table.nReactions
+     << " reactions of " << table.nSpecies << " species.\n"
+     << "// Generated by LFlame3MechGen from " << basename << "; do not edit.\n"
+     << "\n"
+     << "#include <kinetics_registry.hh>\n"
+     << "\n"
+     << "#include <algorithm>\n"
+     << "#include <cmath>\n"
+     << "\n"
+     << "namespace flame {\n"
+     << "\n"
+     << "namespace {\n"
+     << "\n";
+  writeProductionRates(os, *mixture, table);
+  os << "\n";
+  writeMolarRates(os, *mixture, table);
+  os << "\n"
+     << "registerCompiledMechanism register_" << identifier(name) << "(\n"
+     << "  \"" << name << "\", " << hash << "ull, productionRates, molarRatesDense,\n"
+     << "  molarRatesSparse\n"
+     << ");\n"
+     << "\n"
+     << "} // end: namespace\n"
+     << "\n"
+     << "} // end: namespace flame\n";
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+AC_DEFUN([CONFIGURE_OPENMP],[
+AC_PREREQ(2.50)
+
+AC_ARG_ENABLE(
+  [openmp],
+  [AS_HELP_STRING([--enable-openmp],[run conflict-free loops on threads using OpenMP])],
+  [],
+  [enable_openmp=no]
+)
+
+use_openmp=no
+AS_IF([test "x$enable_openmp" = "xyes"],[
+  AC_LANG_PUSH([C++])
+  _configure_openmp_save_CXXFLAGS="$CXXFLAGS"
+  CXXFLAGS="$CXXFLAGS -fopenmp"
+  AC_MSG_CHECKING([whether $CXX accepts -fopenmp])
+  AC_LINK_IFELSE(
+    [AC_LANG_PROGRAM([[#include <omp.h>]],[[return omp_get_max_threads() > 0 ? 0 : 1;]])],
+    [use_openmp=yes],
+    [use_openmp=no]
+  )
+  AC_MSG_RESULT([$use_openmp])
+  CXXFLAGS="$_configure_openmp_save_CXXFLAGS"
+  AC_LANG_POP([C++])
+  AS_IF([test "x$use_openmp" != "xyes"],[AC_MSG_ERROR([OpenMP requested but not supported by $CXX])])
+])
+
+AS_IF(
+  [test "x$use_openmp" = "xyes"],
+  [OPENMP_CXXFLAGS="-fopenmp"],
+  [OPENMP_CXXFLAGS=""]
+)
+AC_SUBST([OPENMP_CXXFLAGS])
+
+AM_CONDITIONAL([HAVE_OPENMP],[test "x$use_openmp" = "xyes"])
+
+])
@@ -0,0 +1,42 @@
+AC_DEFUN([CONFIGURE_OPENMP_SIMD],[
+AC_PREREQ(2.50)
+
+AC_ARG_ENABLE(
+  [openmp-simd],
+  [AS_HELP_STRING([--disable-openmp-simd],[do not vectorize batched kernels using OpenMP SIMD directives])],
+  [],
+  [enable_openmp_simd=yes]
+)
+
+use_openmp_simd=no
+AS_IF([test "x$enable_openmp_simd" = "xyes"],[
+  AC_LANG_PUSH([C++])
+  _configure_openmp_simd_save_CXXFLAGS="$CXXFLAGS"
+  CXXFLAGS="$CXXFLAGS -fopenmp-simd -fno-math-errno"
+  AC_MSG_CHECKING([whether $CXX accepts -fopenmp-simd -fno-math-errno])
+  AC_COMPILE_IFELSE(
+    [AC_LANG_PROGRAM([],[[
+      double a[4] = {0.0, 1.0, 2.0, 3.0};
+#pragma omp simd
+      for(int i = 0; i < 4; ++i) { a[i] *= 2.0; }
+    ]])],
+    [use_openmp_simd=yes],
+    [use_openmp_simd=no]
+  )
+  AC_MSG_RESULT([$use_openmp_simd])
+  CXXFLAGS="$_configure_openmp_simd_save_CXXFLAGS"
+  AC_LANG_POP([C++])
+])
+
+dnl sqrt() may set errno unless -fno-math-errno is given, which keeps the
+dnl compiler from vectorizing loops that call it.
+AS_IF(
+  [test "x$use_openmp_simd" = "xyes"],
+  [OPENMP_SIMD_CXXFLAGS="-fopenmp-simd -fno-math-errno"],
+  [OPENMP_SIMD_CXXFLAGS=""]
+)
+AC_SUBST([OPENMP_SIMD_CXXFLAGS])
+
+AM_CONDITIONAL([HAVE_OPENMP_SIMD],[test "x$use_openmp_simd" = "xyes"])
+
+])